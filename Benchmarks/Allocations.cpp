@@ -0,0 +1,64 @@
+#include <atomic>
+#include <cstddef>                                                              // size_t
+#include <cstdlib>                                                              // malloc(), aligned_alloc(), free()
+#include <new>                                                                  // align_val_t, bad_alloc
+
+#include "Benchmarks/Benchmark.hpp"
+
+
+
+// The global operator new and delete, replaced so the benchmarks can count heap allocations.  They live alone in this translation
+// unit so the compiler never sees a replaced delete alongside the standard library's calls to new.
+namespace  // anonymous
+{
+  // Constant initialized, so allocations made by other translation units' static objects are counted from the start
+  constinit std::atomic<std::size_t> heapAllocations = 0;
+}    // namespace
+
+
+
+std::size_t Benchmark::allocations() noexcept
+{ return heapAllocations.load( std::memory_order_relaxed ); }
+
+
+
+
+// Every allocation through operator new, whatever its form, is counted.  The array and nothrow forms forward to these, so they
+// needn't be replaced as well.
+void * operator new( std::size_t size )
+{
+  heapAllocations.fetch_add( 1, std::memory_order_relaxed );
+  if( auto memory = std::malloc( size == 0  ?  1  :  size ) ) return memory;
+  throw std::bad_alloc();
+}
+
+
+
+void * operator new( std::size_t size, std::align_val_t alignment )
+{
+  heapAllocations.fetch_add( 1, std::memory_order_relaxed );
+  auto align   = static_cast<std::size_t>( alignment );
+  auto rounded = ( ( size == 0  ?  1  :  size ) + align - 1 ) / align * align;                    // aligned_alloc() wants a multiple of align
+  if( auto memory = std::aligned_alloc( align, rounded ) ) return memory;
+  throw std::bad_alloc();
+}
+
+
+
+void operator delete( void * memory ) noexcept
+{ std::free( memory ); }
+
+
+
+void operator delete( void * memory, std::size_t ) noexcept
+{ std::free( memory ); }
+
+
+
+void operator delete( void * memory, std::align_val_t ) noexcept
+{ std::free( memory ); }
+
+
+
+void operator delete( void * memory, std::size_t, std::align_val_t ) noexcept
+{ std::free( memory ); }
@@ -0,0 +1,252 @@
+#include <chrono>                                                               // steady_clock, system_clock, duration_cast
+#include <cstddef>                                                              // size_t
+#include <cstdio>                                                               // snprintf()
+#include <ctime>                                                                // localtime(), strftime()
+#include <exception>
+#include <fstream>
+#include <iomanip>                                                              // setw(), setprecision()
+#include <iostream>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <thread>                                                               // hardware_concurrency()
+#include <utility>                                                              // move()
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+
+
+
+namespace Benchmark
+{
+  namespace  // anonymous
+  {
+    struct Registered
+    {
+      std::string name;
+      Function    function;
+    };
+
+    #ifdef NDEBUG
+      constexpr char BUILD_TYPE[] = "release";
+    #else
+      constexpr char BUILD_TYPE[] = "debug";
+    #endif
+
+
+
+    // A function local static so registrations from other translation units' static objects never see it unconstructed
+    std::vector<Registered> & registry()
+    {
+      static std::vector<Registered> benchmarks;
+      return benchmarks;
+    }
+  }    // namespace
+
+
+
+  double Measurement::nanosecondsPerOperation() const
+  { return operations == 0  ?  0.0  :  static_cast<double>( elapsed.count() ) / static_cast<double>( operations ); }
+
+
+
+  double Measurement::operationsPerSecond() const
+  { return elapsed.count() == 0  ?  0.0  :  static_cast<double>( operations ) * 1e9 / static_cast<double>( elapsed.count() ); }
+
+
+
+  double Measurement::bytesPerSecond() const
+  { return elapsed.count() == 0  ?  0.0  :  static_cast<double>( bytes ) * 1e9 / static_cast<double>( elapsed.count() ); }
+
+
+
+  double Measurement::allocationsPerOperation() const
+  { return operations == 0  ?  0.0  :  static_cast<double>( allocations ) / static_cast<double>( operations ); }
+
+
+
+
+  void add( std::string name, Function function )
+  { registry().push_back( { std::move( name ), std::move( function ) } ); }
+
+
+
+
+  Measurement measure( const std::string & name, const Function & function, unsigned repetitions )
+  {
+    function();                                                                 // warm up caches, page in data, and let lazy setup happen
+
+    Measurement best{ name, 0, std::chrono::nanoseconds::max(), repetitions };
+    for( unsigned i = 0; i < repetitions; ++i )
+    {
+      auto allocated = allocations();
+      auto start     = std::chrono::steady_clock::now();
+      auto work      = function();
+      auto elapsed   = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start );
+      allocated      = allocations() - allocated;
+
+      if( elapsed < best.elapsed ) best = { name, work.operations, elapsed, repetitions, work.bytes, allocated };
+    }
+    return best;
+  }
+
+
+
+
+  int run( int argc, char * argv[], std::ostream & stream )
+  {
+    std::string filter, format = "console", outFilename;
+    unsigned    repetitions = 5;
+
+    try
+    {
+      for( int i = 1; i < argc; ++i )
+      {
+        std::string_view argument = argv[i];
+        auto option = [&]( std::string_view name ) { return argument.starts_with( name )  ?  std::string( argument.substr( name.size() ) )  :  std::string(); };
+
+        if     ( argument.starts_with( "--benchmark_filter="      ) ) filter      = option( "--benchmark_filter=" );
+        else if( argument.starts_with( "--benchmark_repetitions=" ) ) repetitions = static_cast<unsigned>( std::stoul( option( "--benchmark_repetitions=" ) ) );
+        else if( argument.starts_with( "--benchmark_format="      ) ) format      = option( "--benchmark_format=" );
+        else if( argument.starts_with( "--benchmark_out="         ) ) outFilename = option( "--benchmark_out=" );
+        else if( !argument.starts_with( "--" )                      ) filter      = argument;
+        else
+        {
+          std::cerr << "Unrecognized option \"" << argument << "\"\n";
+          return 2;
+        }
+      }
+      if( format != "console"  &&  format != "json" )
+      {
+        std::cerr << "Unrecognized format \"" << format << "\", expected console or json\n";
+        return 2;
+      }
+
+      std::regex selected( filter );
+      bool       console = format == "console";
+
+      if( console ) stream << std::left  << std::setw( 48 ) << "Benchmark"
+                           << std::right << std::setw( 14 ) << "Operations"
+                           << std::setw( 16 ) << "Time (ms)"
+                           << std::setw( 14 ) << "ns/op"
+                           << std::setw( 16 ) << "ops/s"
+                           << std::setw( 12 ) << "allocs/op"
+                           << std::setw( 10 ) << "GB/s" << '\n'
+                           << std::string( 130, '-' ) << '\n';
+
+      std::vector<Measurement> measurements;
+      for( const auto & [name, function] : registry() )
+      {
+        if( !std::regex_search( name, selected ) ) continue;
+        measurements.push_back( measure( name, function, repetitions ) );
+        if( console ) stream << measurements.back() << '\n';
+      }
+
+      if( !console ) writeJson( stream, measurements, argv[0] );
+      if( !outFilename.empty() )
+      {
+        std::ofstream out( outFilename );
+        writeJson( out, measurements, argv[0] );
+        if( !out )
+        {
+          std::cerr << "Could not write benchmark results to \"" << outFilename << "\"\n";
+          return 1;
+        }
+      }
+    }
+    catch( const std::exception & ex )
+    {
+      std::cerr << "Benchmark aborted with an unhandled exception:\n" << ex.what() << '\n';
+      return 1;
+    }
+    return 0;
+  }
+
+
+
+
+  void writeJson( std::ostream & stream, const std::vector<Measurement> & measurements, const std::string & executable )
+  {
+    auto quoted = []( std::string_view text )
+    {
+      std::string result = "\"";
+      for( char c : text )
+      {
+        if     ( c == '"'  ||  c == '\\' ) ( result += '\\' ) += c;
+        else if( static_cast<unsigned char>( c ) < 0x20 )
+        {
+          char escape[8];
+          std::snprintf( escape, sizeof( escape ), "\\u%04x", static_cast<unsigned>( c ) );
+          result += escape;
+        }
+        else result += c;
+      }
+      return result += '"';
+    };
+
+    auto now = std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() );
+    char date[32];
+    std::strftime( date, sizeof( date ), "%Y-%m-%dT%H:%M:%S%z", std::localtime( &now ) );
+
+    auto flags     = stream.flags();
+    auto precision = stream.precision();
+    stream << std::fixed << std::setprecision( 3 );
+
+    stream << "{\n"
+           << "  \"context\": {\n"
+           << "    \"date\": "               << quoted( date )       << ",\n"
+           << "    \"executable\": "         << quoted( executable ) << ",\n"
+           << "    \"num_cpus\": "           << std::thread::hardware_concurrency() << ",\n"
+           << "    \"library_build_type\": " << quoted( BUILD_TYPE ) << "\n"
+           << "  },\n"
+           << "  \"benchmarks\": [";
+
+    for( std::size_t i = 0; i < measurements.size(); ++i )
+    {
+      const auto & measurement = measurements[i];
+      stream << ( i == 0  ?  "\n"  :  ",\n" )
+             << "    {\n"
+             << "      \"name\": "             << quoted( measurement.name ) << ",\n"
+             << "      \"run_name\": "         << quoted( measurement.name ) << ",\n"
+             << "      \"run_type\": \"iteration\",\n"
+             << "      \"repetitions\": "      << measurement.repetitions    << ",\n"
+             << "      \"iterations\": "       << measurement.operations     << ",\n"
+             << "      \"real_time\": "        << measurement.nanosecondsPerOperation() << ",\n"
+             << "      \"time_unit\": \"ns\",\n"
+             << "      \"items_per_second\": " << measurement.operationsPerSecond() << ",\n"
+             << "      \"allocs_per_iter\": "  << measurement.allocationsPerOperation();
+      if( measurement.bytes != 0 ) stream << ",\n      \"bytes_per_second\": " << measurement.bytesPerSecond();
+      stream << "\n    }";
+    }
+    stream << "\n  ]\n}\n";
+
+    stream.flags( flags );
+    stream.precision( precision );
+  }
+
+
+
+
+  std::ostream & operator<<( std::ostream & stream, const Measurement & measurement )
+  {
+    auto flags     = stream.flags();
+    auto precision = stream.precision();
+
+    stream << std::left  << std::setw( 48 ) << measurement.name
+           << std::right << std::setw( 14 ) << measurement.operations
+           << std::fixed << std::setprecision( 3 )
+           << std::setw( 16 ) << static_cast<double>( measurement.elapsed.count() ) / 1e6
+           << std::setprecision( 2 )
+           << std::setw( 14 ) << measurement.nanosecondsPerOperation()
+           << std::setprecision( 0 )
+           << std::setw( 16 ) << measurement.operationsPerSecond()
+           << std::setprecision( 2 )
+           << std::setw( 12 ) << measurement.allocationsPerOperation();
+
+    if( measurement.bytes != 0 ) stream << std::setw( 10 ) << measurement.bytesPerSecond() / 1e9;
+
+    stream.flags( flags );
+    stream.precision( precision );
+    return stream;
+  }
+}    // namespace Benchmark
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>                                                               // nanoseconds
+#include <cstddef>                                                              // size_t
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>                                                              // move()
+#include <vector>
+
+
+
+// A minimal benchmark harness.  Benchmarks register themselves from static objects, much as the regression tests do, and
+// Benchmark::run() executes those selected on the command line.  Options follow Google Benchmark's so existing tooling can consume
+// the results:
+//     --benchmark_filter=<regex>        run only benchmarks whose name matches (a bare argument does the same)
+//     --benchmark_repetitions=<n>       timed passes per benchmark, the fastest is reported (default 5)
+//     --benchmark_format=<console|json> what's written to standard output (default console)
+//     --benchmark_out=<filename>        also write the results to filename as JSON
+namespace Benchmark
+{
+  // What one timed pass did:  the operations it performed and, for benchmarks of throughput, the bytes it processed.  Implicitly
+  // constructed from a count of operations, so most benchmarks simply return that.
+  struct Work
+  {
+    Work( std::size_t operationsPerformed, std::size_t bytesProcessed = 0 ) noexcept
+      : operations( operationsPerformed ), bytes( bytesProcessed )
+    {}
+
+    std::size_t operations = 0;
+    std::size_t bytes      = 0;
+  };
+
+  // One timed pass over the code being measured
+  using Function = std::function<Work()>;
+
+  struct Measurement
+  {
+    std::string              name;
+    std::size_t              operations  = 0;                                   // Operations performed by the fastest pass
+    std::chrono::nanoseconds elapsed     {};                                    // Time taken by the fastest pass
+    unsigned                 repetitions = 0;                                   // Timed passes the fastest was chosen from
+    std::size_t              bytes       = 0;                                   // Bytes processed by the fastest pass, if reported
+    std::size_t              allocations = 0;                                   // Heap allocations made during the fastest pass, by any thread
+
+    double nanosecondsPerOperation () const;
+    double operationsPerSecond     () const;
+    double bytesPerSecond          () const;
+    double allocationsPerOperation () const;
+  };
+
+  // Heap allocations made so far, by any thread, through operator new.  The benchmarks replace the global operator new to count them.
+  std::size_t allocations() noexcept;
+
+  // Registers a benchmark to be run later by run()
+  void add( std::string name, Function function );
+
+  struct Registration
+  {
+    Registration( std::string name, Function function )
+    { add( std::move( name ), std::move( function ) ); }
+  };
+
+  // Runs function once to warm up, then repetitions more times, and reports the fastest pass
+  Measurement measure( const std::string & name, const Function & function, unsigned repetitions = 5 );
+
+  // Runs the registered benchmarks selected by the command line options above and reports their results to stream.  Returns the
+  // process exit status.
+  int run( int argc, char * argv[], std::ostream & stream = std::cout );
+
+  // Writes measurements in Google Benchmark's JSON format
+  void writeJson( std::ostream & stream, const std::vector<Measurement> & measurements, const std::string & executable );
+
+  std::ostream & operator<<( std::ostream & stream, const Measurement & measurement );
+
+
+  // Keeps the optimizer from discarding a result the benchmark computes but never otherwise uses
+  template<typename T>
+  inline void doNotOptimize( const T & value )
+  { asm volatile( "" : : "r,m"( value ) : "memory" ); }
+}    // namespace Benchmark
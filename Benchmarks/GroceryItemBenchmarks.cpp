@@ -0,0 +1,125 @@
+#include <compare>                                                              // weak_ordering
+#include <cstddef>                                                              // size_t
+#include <sstream>                                                              // istringstream, ostringstream
+#include <string>
+#include <utility>                                                              // move()
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "GroceryItem.hpp"
+
+
+
+// The GroceryItem value type:  construction, copy versus move, comparisons, and stream insertion and extraction.  Names and brands
+// are long enough to defeat the small string optimization, as most in the real database are.
+namespace  // anonymous
+{
+  constexpr std::size_t ITEMS = 100'000;
+
+  std::vector<GroceryItem> makeItems()
+  {
+    std::vector<GroceryItem> items;
+    items.reserve( ITEMS );
+    for( std::size_t i = 0; i < ITEMS; ++i )
+    {
+      auto upc = std::to_string( 10'000'000'000'000ULL + i * 7 );
+      items.emplace_back( "Organic Whole Milk, Vitamin D - 1 gal #" + std::to_string( i ), "Happy Meadow Dairy Farms", upc, 3.49 + static_cast<double>( i % 100 ) );
+    }
+    return items;
+  }
+
+  const std::vector<GroceryItem> & items()
+  {
+    static const std::vector<GroceryItem> cache = makeItems();
+    return cache;
+  }
+
+
+
+  const Benchmark::Registration construct( "GroceryItem/construct", []
+  {
+    std::string productName = "Organic Whole Milk, Vitamin D - 1 gal", brandName = "Happy Meadow Dairy Farms", upc = "00075457129000";
+    for( std::size_t i = 0; i < ITEMS; ++i )
+    {
+      GroceryItem item( productName, brandName, upc, 3.49 );
+      Benchmark::doNotOptimize( item );
+    }
+    return ITEMS;
+  } );
+
+
+
+  const Benchmark::Registration copy( "GroceryItem/copy", []
+  {
+    std::vector<GroceryItem> copies;
+    copies.reserve( ITEMS );
+    for( const auto & item : items() ) copies.push_back( item );
+    Benchmark::doNotOptimize( copies.data() );
+    return ITEMS;
+  } );
+
+
+
+  const Benchmark::Registration move( "GroceryItem/move", []
+  {
+    // Only the moves are of interest, but there must be something to move from, so the copies are made on the warm up pass and
+    // moved back and forth between two vectors on the timed ones
+    static std::vector<GroceryItem> from = items(), to;
+    to.clear();
+    to.reserve( ITEMS );
+    for( auto & item : from ) to.push_back( std::move( item ) );
+    from.swap( to );
+    Benchmark::doNotOptimize( from.data() );
+    return ITEMS;
+  } );
+
+
+
+  const Benchmark::Registration threeWayCompare( "GroceryItem/operator<=>", []
+  {
+    std::size_t less = 0;
+    const auto & all = items();
+    for( std::size_t i = 1; i < all.size(); ++i ) if( ( all[i - 1] <=> all[i] ) < 0 ) ++less;
+    Benchmark::doNotOptimize( less );
+    return all.size() - 1;
+  } );
+
+
+
+  const Benchmark::Registration equal( "GroceryItem/operator==", []
+  {
+    // Compare each item against an equal copy, the worst case since every attribute must be examined
+    static const std::vector<GroceryItem> copies = items();
+    std::size_t same = 0;
+    for( std::size_t i = 0; i < copies.size(); ++i ) if( items()[i] == copies[i] ) ++same;
+    Benchmark::doNotOptimize( same );
+    return copies.size();
+  } );
+
+
+
+  const Benchmark::Registration insertion( "GroceryItem/operator<<", []
+  {
+    std::ostringstream stream;
+    for( const auto & item : items() ) stream << item << '\n';
+    Benchmark::doNotOptimize( stream.tellp() );
+    return ITEMS;
+  } );
+
+
+
+  const Benchmark::Registration extraction( "GroceryItem/operator>>", []
+  {
+    static const std::string text = []
+    {
+      std::ostringstream stream;
+      for( const auto & item : items() ) stream << item << '\n';
+      return stream.str();
+    }();
+
+    std::istringstream stream( text );
+    std::size_t        count = 0;
+    for( GroceryItem item; stream >> item; ++count ) Benchmark::doNotOptimize( item );
+    return count;
+  } );
+}    // namespace
@@ -0,0 +1,255 @@
+#include <atomic>
+#include <cstddef>                                                              // size_t
+#include <cstdint>                                                              // uint64_t
+#include <filesystem>                                                           // temp_directory_path(), remove()
+#include <fstream>                                                              // ofstream
+#include <map>
+#include <random>                                                               // mt19937_64, uniform_int_distribution
+#include <string>
+#include <thread>                                                               // jthread
+#include <utility>                                                              // move()
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "GroceryItemCatalog.hpp"
+#include "GroceryItemDatabase.hpp"
+#include "Money.hpp"
+#include "Upc.hpp"
+
+
+
+// Looking up grocery items by UPC at each of the database file scales.  GroceryItemDatabase is a singleton bound to whichever file
+// is in the working directory, so each scale is instead a catalog, the storage GroceryItemDatabase::find() delegates to, built in
+// memory with the same number of grocery items.  Nine lookups in ten find their grocery item, as at a checkout counter.
+namespace  // anonymous
+{
+  constexpr std::size_t LOOKUPS = 1'000'000;
+
+  struct Scale
+  {
+    const char * name;
+    std::size_t  groceryItems;
+  };
+
+  constexpr Scale SCALES[] = { { "Small", 1'000 }, { "Medium", 10'000 }, { "Large", 100'000 }, { "Full", 1'000'000 } };
+
+  // UPCs are spread across the whole range, like real ones, rather than consecutive
+  Upc upcOf( std::size_t i )
+  { return *Upc::fromValue( 10'000'000'000'000ULL + i * 7'919'993ULL ); }
+
+
+
+  struct State
+  {
+    GroceryItemCatalog catalog;
+    std::vector<Upc>   lookups;
+  };
+
+  State makeState( std::size_t groceryItems )
+  {
+    std::map<Upc, std::size_t> sorted;                                          // the builder wants UPCs in increasing order
+    for( std::size_t i = 0; i < groceryItems; ++i ) sorted.emplace( upcOf( i ), i );
+
+    GroceryItemCatalog::Builder builder;
+    builder.reserve( groceryItems, groceryItems * 40 );
+    for( const auto & [upc, i] : sorted ) builder.append( upc, "Brand " + std::to_string( i % 5'000 ), "Product name of grocery item number " + std::to_string( i ), 1.0 + static_cast<double>( i % 1'000 ) );
+
+    State state{ std::move( builder ).build(), {} };
+
+    std::mt19937_64                            generator( 42 );
+    std::uniform_int_distribution<std::size_t> pick( 0, groceryItems * 10 / 9 );   // indexes past groceryItems aren't in the catalog
+    state.lookups.reserve( LOOKUPS );
+    for( std::size_t i = 0; i < LOOKUPS; ++i ) state.lookups.push_back( upcOf( pick( generator ) ) );
+    return state;
+  }
+
+
+
+  // Catalogs are built on first use, during a benchmark's untimed warm up pass, and kept for the rest of the run
+  const State & stateAt( std::size_t groceryItems )
+  {
+    static std::map<std::size_t, State> states;
+    auto [state, inserted] = states.try_emplace( groceryItems );
+    if( inserted ) state->second = makeState( groceryItems );
+    return state->second;
+  }
+
+
+
+  const struct Registrations
+  {
+    Registrations()
+    {
+      for( const auto & scale : SCALES )
+      {
+        Benchmark::add( std::string( "GroceryItemDatabase/find/" ) + scale.name, [size = scale.groceryItems]
+        {
+          const auto & state = stateAt( size );
+          std::size_t  found = 0;
+          for( const auto & upc : state.lookups ) if( state.catalog.find( upc ) != GroceryItemCatalog::NOT_FOUND ) ++found;
+          Benchmark::doNotOptimize( found );
+          return state.lookups.size();
+        } );
+
+        Benchmark::add( std::string( "GroceryItemDatabase/findMany/" ) + scale.name, [size = scale.groceryItems]
+        {
+          const auto & state = stateAt( size );
+          std::vector<GroceryItemCatalog::Record> records( state.lookups.size() );
+          state.catalog.find( state.lookups, records );
+          Benchmark::doNotOptimize( records.data() );
+          return state.lookups.size();
+        } );
+      }
+    }
+  } registrations;
+
+
+
+
+  // Prefix queries, as for a manufacturer's recall:  every grocery item whose UPC begins with the first few digits of a UPC in the
+  // catalog.  The sorted UPCs bound each query with two binary searches, compared here against examining every grocery item.
+  constexpr std::size_t   PREFIX_QUERIES = 100;
+  constexpr std::uint64_t PREFIX_SPAN    = 100'000'000;                         // UPCs sharing their first 6 of 14 digits
+
+  std::vector<std::uint64_t> prefixesOf( const GroceryItemCatalog & catalog )
+  {
+    std::mt19937_64                            generator( 7 );
+    std::uniform_int_distribution<std::size_t> pick( 0, catalog.size() - 1 );
+    std::vector<std::uint64_t>                 prefixes;
+    for( std::size_t i = 0; i < PREFIX_QUERIES; ++i ) prefixes.push_back( catalog.upc( static_cast<GroceryItemCatalog::Record>( pick( generator ) ) ).value() / PREFIX_SPAN );
+    return prefixes;
+  }
+
+
+
+  const struct PrefixRegistrations
+  {
+    PrefixRegistrations()
+    {
+      for( const auto & scale : SCALES )
+      {
+        Benchmark::add( std::string( "GroceryItemDatabase/findPrefix/" ) + scale.name, [size = scale.groceryItems]
+        {
+          const auto & catalog = stateAt( size ).catalog;
+          auto         total   = Money::Cents{ 0 };
+          for( auto prefix : prefixesOf( catalog ) )
+          {
+            auto records = catalog.range( *Upc::fromValue( prefix * PREFIX_SPAN ), *Upc::fromValue( prefix * PREFIX_SPAN + PREFIX_SPAN - 1 ) );
+            for( auto record = records.begin; record != records.end; ++record ) total += catalog.price( record ).cents();
+          }
+          Benchmark::doNotOptimize( total );
+          return PREFIX_QUERIES;
+        } );
+
+        Benchmark::add( std::string( "GroceryItemDatabase/findPrefixByScan/" ) + scale.name, [size = scale.groceryItems]
+        {
+          const auto & catalog = stateAt( size ).catalog;
+          auto         total   = Money::Cents{ 0 };
+          for( auto prefix : prefixesOf( catalog ) )
+          {
+            for( GroceryItemCatalog::Record record = 0; record < catalog.size(); ++record )
+            {
+              if( catalog.upc( record ).value() / PREFIX_SPAN == prefix ) total += catalog.price( record ).cents();
+            }
+          }
+          Benchmark::doNotOptimize( total );
+          return PREFIX_QUERIES;
+        } );
+      }
+    }
+  } prefixRegistrations;
+
+
+
+
+  // Lookups through the GroceryItemDatabase singleton itself, idle and while another thread keeps publishing new versions of it.
+  // Whatever database file is in the working directory is loaded, and a changes file adds grocery items with known UPCs to look
+  // up.  Applying those same changes again is the reload:  each one rebuilds and republishes the whole database.  While reloading,
+  // lookups continue for exactly as long as the reloads take, so the time per lookup is directly comparable with the idle one.
+  constexpr std::size_t CHANGED_ITEMS = 100'000;
+  constexpr unsigned    RELOADS       = 3;
+
+  const std::string & changesFilename()
+  {
+    static const std::string filename = ( std::filesystem::temp_directory_path() / "GroceryItemDatabaseBenchmarks-changes.dat" ).string();
+    return filename;
+  }
+
+  const std::vector<Upc> & instanceLookups()
+  {
+    static const std::vector<Upc> lookups = []
+    {
+      {
+        std::ofstream changes( changesFilename() );
+        for( std::size_t i = 0; i < CHANGED_ITEMS; ++i ) changes << '"' << upcOf( i ).to_string() << R"(", "Brand )" << i % 5'000 << R"(", "Product name of grocery item number )" << i << "\", 1.00\n";
+      }
+      GroceryItemDatabase::instance().applyChanges( changesFilename() );
+
+      std::mt19937_64                            generator( 42 );
+      std::uniform_int_distribution<std::size_t> pick( 0, CHANGED_ITEMS * 10 / 9 );
+      std::vector<Upc>                           result;
+      result.reserve( LOOKUPS );
+      for( std::size_t i = 0; i < LOOKUPS; ++i ) result.push_back( upcOf( pick( generator ) ) );
+      return result;
+    }();
+    return lookups;
+  }
+
+
+
+  const Benchmark::Registration instanceFind( "GroceryItemDatabase/instance/find", []
+  {
+    auto &      database = GroceryItemDatabase::instance();
+    std::size_t found    = 0;
+    for( const auto & upc : instanceLookups() ) if( database.find( upc ) != nullptr ) ++found;
+    Benchmark::doNotOptimize( found );
+    return instanceLookups().size();
+  } );
+
+
+
+  // The same lookups split among checkout lanes looking grocery items up at once, so the time per lookup shows what readers
+  // cost each other
+  const Benchmark::Registration instanceFindConcurrently( "GroceryItemDatabase/instance/find/lanes:4", []
+  {
+    constexpr unsigned LANES = 4;
+
+    auto &                   database = GroceryItemDatabase::instance();
+    const auto &             lookups  = instanceLookups();
+    std::atomic<std::size_t> found    = 0;
+    {
+      std::vector<std::jthread> lanes;
+      for( unsigned lane = 0; lane < LANES; ++lane ) lanes.emplace_back( [&, lane]
+      {
+        std::size_t laneFound = 0;
+        for( auto i = std::size_t{ lane }; i < lookups.size(); i += LANES ) if( database.find( lookups[i] ) != nullptr ) ++laneFound;
+        found.fetch_add( laneFound, std::memory_order_relaxed );
+      } );
+    }
+    Benchmark::doNotOptimize( found.load() );
+    return lookups.size();
+  } );
+
+
+
+  const Benchmark::Registration instanceFindWhileReloading( "GroceryItemDatabase/instance/findWhileReloading", []
+  {
+    auto &       database = GroceryItemDatabase::instance();
+    const auto & lookups  = instanceLookups();
+
+    std::atomic<bool> reloading = true;
+    std::jthread      reloader( [&]
+    {
+      for( unsigned i = 0; i < RELOADS; ++i ) database.applyChanges( changesFilename() );
+      reloading.store( false, std::memory_order_release );
+    } );
+
+    std::size_t lookedUp = 0, found = 0;
+    while( reloading.load( std::memory_order_acquire ) )
+    {
+      for( std::size_t i = 0; i < 1'000; ++i ) if( database.find( lookups[lookedUp++ % lookups.size()] ) != nullptr ) ++found;
+    }
+    Benchmark::doNotOptimize( found );
+    return lookedUp;
+  } );
+}    // namespace
@@ -0,0 +1,83 @@
+#include <cstddef>                                                              // size_t
+#include <string>
+#include <string_view>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "GroceryItemParser.hpp"
+#include "GroceryItemScanner.hpp"
+
+
+
+// Throughput of the grocery item text format's first and second stages, in bytes of text per second, with each instruction set:
+// counting quotes (all the database loader needs to split a file into chunks), handing out every structural character, and
+// extracting every grocery item's fields.  The text is about 16 MB, too large for the caches, written in the database file's format
+// with an escaped quote or backslash in one grocery item in eight.
+namespace  // anonymous
+{
+  constexpr std::size_t ITEMS = 200'000;
+
+  struct InstructionSet
+  {
+    const char *                       name;
+    GroceryItemScanner::InstructionSet value;
+  };
+
+  constexpr InstructionSet INSTRUCTION_SETS[] = { { "Scalar", GroceryItemScanner::InstructionSet::SCALAR },
+                                                  { "SSE2",   GroceryItemScanner::InstructionSet::SSE2   },
+                                                  { "AVX2",   GroceryItemScanner::InstructionSet::AVX2   } };
+
+  const std::string & text()
+  {
+    static const std::string cache = []
+    {
+      std::string result;
+      for( std::size_t i = 0; i < ITEMS; ++i )
+      {
+        std::string_view escape = i % 8 != 0  ?  ""  :  i % 16 == 0  ?  R"( 12\" \\ )"  :  R"( \"Best\" )";
+        ( ( result += '"' ) += std::to_string( 10'000'000'000'000ULL + i * 7 ) ) += R"(","Happy Meadow Dairy Farms","Organic Whole Milk,)";
+        ( ( ( result += escape ) += " Vitamin D - 1 gal #" ) += std::to_string( i ) ) += "\",";
+        ( result += std::to_string( 3 + i % 100 ) ) += ".49\n";
+      }
+      return result;
+    }();
+    return cache;
+  }
+
+
+
+  const struct Registrations
+  {
+    Registrations()
+    {
+      for( const auto & instructionSet : INSTRUCTION_SETS )
+      {
+        Benchmark::add( std::string( "GroceryItemScanner/countQuotes/" ) + instructionSet.name, [isa = instructionSet.value]
+        {
+          auto count = GroceryItemScanner::countQuotes( text(), isa );
+          Benchmark::doNotOptimize( count );
+          return Benchmark::Work{ text().size() / GroceryItemScanner::BLOCK_SIZE, text().size() };
+        } );
+
+        Benchmark::add( std::string( "GroceryItemScanner/structurals/" ) + instructionSet.name, [isa = instructionSet.value]
+        {
+          GroceryItemScanner scanner( text(), isa );
+          std::size_t        count = 0;
+          while( scanner.next() != GroceryItemScanner::npos ) ++count;
+          Benchmark::doNotOptimize( count );
+          return Benchmark::Work{ count, text().size() };
+        } );
+
+        Benchmark::add( std::string( "GroceryItemScanner/extractGroceryItem/" ) + instructionSet.name, [isa = instructionSet.value]
+        {
+          std::string_view   rest = text();
+          GroceryItemScanner scanner( rest, isa );
+          GroceryItemFields  fields;
+          std::size_t        count = 0;
+          while( extractGroceryItem( rest, fields, scanner ) ) ++count;
+          Benchmark::doNotOptimize( count );
+          return Benchmark::Work{ count, text().size() };
+        } );
+      }
+    }
+  } registrations;
+}    // namespace
@@ -0,0 +1,293 @@
+#include <cstddef>                                                              // size_t
+#include <cstdint>                                                              // uint64_t
+#include <filesystem>                                                           // temp_directory_path(), remove()
+#include <fstream>                                                              // ifstream, ofstream
+#include <memory>                                                               // unique_ptr, make_unique()
+#include <random>                                                               // mt19937_64, uniform_int_distribution
+#include <sstream>                                                              // istringstream, ostringstream
+#include <string>
+#include <utility>                                                              // move()
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "GroceryStore.hpp"
+#include "Inventory.hpp"
+#include "InventoryJournal.hpp"
+#include "InventoryLoader.hpp"
+#include "ShoppingCart.hpp"
+#include "Upc.hpp"
+
+
+
+// Store start up and checkout.  The inventory file is synthetic, the size of the one the store ships with, so loading it is
+// measured without disk I/O.  Checkout runs against the real store:  its inventory and database files must be in the working
+// directory.
+//
+// Durable stores work from copies of their inventory files in the temporary directory.  Recovery is a journaled store's start up
+// with a full checkpoint interval's worth of changes left in its log, the most it replays.  Checkout with and without durability
+// starts from a copy of the store's inventory stocked deeply enough that no pass sells out, so every sale is logged and committed.
+namespace  // anonymous
+{
+  constexpr std::size_t         INVENTORY_RECORDS = 104'361;
+  constexpr std::size_t         CUSTOMER_COPIES   = 200;                        // Each of the store's sample shoppers comes back this many times
+  constexpr Inventory::Quantity DEEP_STOCK        = 1'000'000;
+
+  std::string temporaryFilename( const std::string & name )
+  {
+    auto filename = ( std::filesystem::temp_directory_path() / name ).string();
+    for( const auto & file : { filename, InventoryJournal::logFilename( filename ), InventoryJournal::retiredLogFilename( filename ) } )
+    {
+      std::filesystem::remove( file );
+    }
+    return filename;
+  }
+
+
+
+  const Benchmark::Registration inventoryLoad( "Inventory/load", []
+  {
+    static const std::string file = []
+    {
+      std::ostringstream stream;
+      for( std::size_t i = 0; i < INVENTORY_RECORDS; ++i ) stream << std::to_string( 10'000'000'000'000ULL + i * 7'919'993ULL ) << "   " << i % 50 << '\n';
+      return stream.str();
+    }();
+
+    std::istringstream stream( file );
+    auto result = loadInventory( stream, "synthetic" );
+    Benchmark::doNotOptimize( result.inventory.size() );
+    return result.records;
+  } );
+
+
+
+  const Benchmark::Registration inventoryRecover( "GroceryStore/recover", []
+  {
+    static const std::string file = []
+    {
+      auto filename = temporaryFilename( "GroceryStoreBenchmarks-recover.dat" );
+      {
+        std::ofstream stream( filename );
+        for( std::size_t i = 0; i < INVENTORY_RECORDS; ++i ) stream << std::to_string( 10'000'000'000'000ULL + i * 7'919'993ULL ) << "   " << i % 50 << '\n';
+      }
+
+      GroceryStore store( filename, MergePolicy::FIRST_WINS, Durability::JOURNALED );
+      for( std::size_t i = 0; i < InventoryJournal::DEFAULT_CHECKPOINT_INTERVAL; ++i )
+      {
+        store.inventory().restock( *Upc::fromValue( 10'000'000'000'000ULL + i * 7 % INVENTORY_RECORDS * 7'919'993ULL ), 1 );
+      }
+      return filename;
+    }();
+
+    GroceryStore store( file, MergePolicy::FIRST_WINS, Durability::JOURNALED );
+    Benchmark::doNotOptimize( store.inventory().size() );
+    return std::size_t{ 1 };
+  } );
+
+
+
+  // A store, and a crowd of customers built from its sample shoppers, made on the untimed warm up pass
+  struct Checkout
+  {
+    GroceryStore                store;
+    GroceryStore::ShoppingCarts customers;
+  };
+
+  std::unique_ptr<Checkout> makeCheckout( std::unique_ptr<Checkout> checkout )
+  {
+    for( const auto & [name, cart] : checkout->store.makeShoppingCarts() )
+    {
+      for( std::size_t i = 0; i < CUSTOMER_COPIES; ++i ) checkout->customers.emplace( ( name + " #" ).append( std::to_string( i ) ), cart );
+    }
+    return checkout;
+  }
+
+  Checkout & checkout()
+  {
+    static std::unique_ptr<Checkout> state = makeCheckout( std::make_unique<Checkout>() );
+    return *state;
+  }
+
+  Checkout & stockedCheckout( Durability durability )
+  {
+    auto make = [durability]
+    {
+      auto filename = temporaryFilename( durability == Durability::JOURNALED  ?  "GroceryStoreBenchmarks-journaled.dat"  :  "GroceryStoreBenchmarks-unjournaled.dat" );
+
+      std::ifstream inventory( "GroceryStoreInventory.dat" );
+      std::ofstream stocked( filename );
+      for( const auto & [upc, quantity] : loadInventory( inventory, "GroceryStoreInventory.dat" ).inventory.snapshot() ) stocked << upc.to_string() << ' ' << DEEP_STOCK << '\n';
+      stocked.close();
+
+      return makeCheckout( std::make_unique<Checkout>( Checkout{ GroceryStore( filename, MergePolicy::FIRST_WINS, durability ), {} } ) );
+    };
+
+    static std::unique_ptr<Checkout> journaled, unjournaled;
+    auto & state = durability == Durability::JOURNALED  ?  journaled  :  unjournaled;
+    if( state == nullptr ) state = make();
+    return *state;
+  }
+
+
+
+  template<typename State>
+  Benchmark::Function ringUp( State state, unsigned checkoutLanes )
+  {
+    return [state, checkoutLanes]
+    {
+      auto & [store, customers] = state();
+      std::ostringstream receipts;
+      auto sold = store.ringUpCustomers( customers, receipts, checkoutLanes );
+      Benchmark::doNotOptimize( sold.size() );
+      return customers.size();
+    };
+  }
+
+  const struct Registrations
+  {
+    Registrations()
+    {
+      for( unsigned lanes : { 1U, 4U } )
+      {
+        auto suffix = "lanes:" + std::to_string( lanes );
+        Benchmark::add( "GroceryStore/ringUpCustomers/"             + suffix, ringUp( []() -> Checkout & { return checkout(); },                                   lanes ) );
+        Benchmark::add( "GroceryStore/ringUpCustomers/unjournaled/" + suffix, ringUp( []() -> Checkout & { return stockedCheckout( Durability::NONE      ); }, lanes ) );
+        Benchmark::add( "GroceryStore/ringUpCustomers/journaled/"   + suffix, ringUp( []() -> Checkout & { return stockedCheckout( Durability::JOURNALED ); }, lanes ) );
+      }
+    }
+  } registrations;
+
+
+
+
+  // A million customers, built from the store's sample shoppers and rung up in crowds of ten thousand so their receipts needn't all
+  // be held at once.  What it costs to carry a cart shows up in the allocations per customer, as much as in the time.
+  constexpr std::size_t CROWD_CUSTOMERS = 1'000'000;
+  constexpr std::size_t CROWD_SIZE      = 10'000;
+
+  GroceryStore::ShoppingCarts makeCrowd( std::size_t crowd )
+  {
+    static const auto samples = checkout().store.makeShoppingCarts();
+
+    GroceryStore::ShoppingCarts customers;
+    for( std::size_t i = 0; i < CROWD_SIZE; )
+    {
+      for( auto sample = samples.begin();  sample != samples.end()  &&  i < CROWD_SIZE;  ++sample, ++i )
+      {
+        customers.emplace( ( sample->first + " #" ).append( std::to_string( crowd * CROWD_SIZE + i ) ), sample->second );
+      }
+    }
+    return customers;
+  }
+
+  const Benchmark::Registration buildShoppingCarts( "GroceryStore/shoppingCarts/build", []
+  {
+    for( std::size_t crowd = 0; crowd < CROWD_CUSTOMERS / CROWD_SIZE; ++crowd ) Benchmark::doNotOptimize( makeCrowd( crowd ).size() );
+    return CROWD_CUSTOMERS;
+  } );
+
+  const Benchmark::Registration buildAndRingUpShoppingCarts( "GroceryStore/shoppingCarts/buildAndRingUp", []
+  {
+    auto & store = stockedCheckout( Durability::NONE ).store;
+    for( std::size_t crowd = 0; crowd < CROWD_CUSTOMERS / CROWD_SIZE; ++crowd )
+    {
+      std::ostringstream receipts;
+      auto sold = store.ringUpCustomers( makeCrowd( crowd ), receipts );
+      Benchmark::doNotOptimize( sold.size() );
+    }
+    return CROWD_CUSTOMERS;
+  } );
+
+
+
+
+  // Bulk customers:  a hundred baskets of 500 grocery items each, a hundred to five hundred units a line, rung up against a store
+  // stocked deeply enough that nothing sells out.  Throughput is in cart lines.
+  constexpr std::size_t BULK_CUSTOMERS = 100;
+  constexpr std::size_t BULK_LINES     = 500;
+
+  const GroceryStore::ShoppingCarts & bulkCustomers()
+  {
+    static const GroceryStore::ShoppingCarts customers = []
+    {
+      auto                                                  items = stockedCheckout( Durability::NONE ).store.inventory().snapshot();
+      std::mt19937_64                                       generator( 42 );
+      std::uniform_int_distribution<std::size_t>            pick ( 0, items.size() - 1 );
+      std::uniform_int_distribution<ShoppingCart::Quantity> units( 100, 500 );
+
+      GroceryStore::ShoppingCarts carts;
+      for( std::size_t i = 0; i < BULK_CUSTOMERS; ++i )
+      {
+        ShoppingCart cart;
+        for( std::size_t line = 0; line < BULK_LINES; ++line ) cart.add( items[pick( generator )].first, units( generator ) );
+        cart.close();
+        carts.emplace( "Bulk Buyer #" + std::to_string( i ), std::move( cart ) );
+      }
+      return carts;
+    }();
+    return customers;
+  }
+
+  const struct BulkRegistrations
+  {
+    BulkRegistrations()
+    {
+      for( unsigned lanes : { 1U, 4U } ) Benchmark::add( "GroceryStore/ringUpCustomers/bulk/lanes:" + std::to_string( lanes ), [lanes]
+      {
+        auto & customers = bulkCustomers();
+        auto & store     = stockedCheckout( Durability::NONE ).store;
+
+        std::ostringstream receipts;
+        auto sold = store.ringUpCustomers( customers, receipts, lanes );
+        Benchmark::doNotOptimize( sold.size() );
+
+        std::size_t lines = 0;
+        for( const auto & [name, cart] : customers ) lines += cart.size();
+        return lines;
+      } );
+    }
+  } bulkRegistrations;
+
+
+
+
+  // End of day re-ordering after a busy day:  100,000 distinct grocery items sold, one in twenty of them no longer carried and
+  // about half of the rest below the re-order threshold.  Re-ordering restocks the inventory and empties the list of grocery items
+  // sold, so each pass starts by restoring both, which costs a small fraction of the pass.
+  constexpr std::size_t SOLD_SKUS = 100'000;
+
+  struct EndOfDay
+  {
+    GroceryStore                   store;
+    std::vector<Inventory::Item>   stock;                                       // The inventory each pass starts from
+    GroceryStore::GroceryItemsSold sold;
+  };
+
+  EndOfDay & endOfDay()
+  {
+    static std::unique_ptr<EndOfDay> state = []
+    {
+      auto result = std::make_unique<EndOfDay>();
+      auto items  = result->store.inventory().snapshot();
+      for( std::size_t i = 0; i < items.size()  &&  result->sold.size() < SOLD_SKUS; ++i )
+      {
+        result->sold.insert( items[i].first );
+        if( i % 20 != 19 ) result->stock.emplace_back( items[i].first, static_cast<Inventory::Quantity>( i % 30 ) );
+      }
+      return result;
+    }();
+    return *state;
+  }
+
+  const Benchmark::Registration reorderItems( "GroceryStore/reorderItems", []
+  {
+    auto & [store, stock, sold] = endOfDay();
+    store.inventory() = Inventory( stock );
+    auto todaysSales  = sold;
+
+    std::ostringstream report;
+    store.reorderItems( todaysSales, report );
+    Benchmark::doNotOptimize( report.str().size() );
+    return sold.size();
+  } );
+}    // namespace
@@ -0,0 +1,135 @@
+#include <cstddef>                                                              // size_t
+#include <cstdint>                                                              // uint64_t
+#include <map>
+#include <memory>                                                               // shared_ptr, make_shared()
+#include <mutex>
+#include <random>                                                               // mt19937_64, uniform_int_distribution
+#include <string>
+#include <thread>                                                               // jthread
+#include <utility>                                                              // move()
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "Inventory.hpp"
+#include "Upc.hpp"
+
+
+
+// Checkout lanes selling from one shared inventory.  Each lane sells a random stream of grocery items; the work is the same
+// regardless of lane count, so throughput rising with lanes shows how well the inventory scales under contention.  The baseline is
+// the store's previous design:  an ordered map guarded by a single lock.
+namespace  // anonymous
+{
+  constexpr std::size_t ITEMS = 100'000;                                        // Distinct grocery items carried
+  constexpr std::size_t SALES = 2'000'000;                                      // Sales per pass, split across the lanes
+  constexpr unsigned    STOCK = 1'000'000;
+
+  const std::vector<Upc> & upcs()
+  {
+    static const std::vector<Upc> keys = []
+    {
+      std::vector<Upc> result;
+      result.reserve( ITEMS );
+      for( std::uint64_t i = 0; i < ITEMS; ++i ) result.push_back( *Upc::fromValue( 10'000'000'000'000ULL + i * 7 ) );
+      return result;
+    }();
+    return keys;
+  }
+
+  // The grocery items each lane sells, the same every pass
+  std::vector<std::vector<Upc>> salesFor( unsigned lanes )
+  {
+    std::vector<std::vector<Upc>> sales( lanes );
+    for( unsigned lane = 0; lane < lanes; ++lane )
+    {
+      std::mt19937_64                            generator( lane + 1 );
+      std::uniform_int_distribution<std::size_t> pick( 0, ITEMS - 1 );
+
+      sales[lane].reserve( SALES / lanes );
+      for( std::size_t i = 0; i < SALES / lanes; ++i ) sales[lane].push_back( upcs()[pick( generator )] );
+    }
+    return sales;
+  }
+
+  template<typename Sell>
+  std::size_t runLanes( const std::vector<std::vector<Upc>> & sales, Sell sell )
+  {
+    std::size_t count = 0;
+    {
+      std::vector<std::jthread> workers;
+      for( const auto & lane : sales )
+      {
+        workers.emplace_back( [&lane, &sell] { for( const auto & upc : lane ) sell( upc ); } );
+        count += lane.size();
+      }
+    }
+    return count;
+  }
+
+
+
+  // Setup happens on the untimed warm up pass and is kept for the timed ones.  STOCK is large enough that no pass sells out.
+  struct ShardedState
+  {
+    std::vector<std::vector<Upc>> sales;
+    Inventory                     inventory;
+  };
+
+  Benchmark::Function shardedInventory( unsigned lanes )
+  {
+    return [lanes, state = std::shared_ptr<ShardedState>()]() mutable
+    {
+      if( !state )
+      {
+        std::vector<Inventory::Item> items;
+        items.reserve( ITEMS );
+        for( const auto & upc : upcs() ) items.emplace_back( upc, STOCK );
+        state = std::make_shared<ShardedState>( ShardedState{ salesFor( lanes ), Inventory( std::move( items ) ) } );
+      }
+
+      return runLanes( state->sales, [&inventory = state->inventory]( const Upc & upc ) { inventory.decrementIfAvailable( upc ); } );
+    };
+  }
+
+
+
+  struct LockedMapState
+  {
+    std::vector<std::vector<Upc>> sales;
+    std::map<Upc, unsigned>       inventory;
+    std::mutex                    mutex;
+  };
+
+  Benchmark::Function lockedMap( unsigned lanes )
+  {
+    return [lanes, state = std::shared_ptr<LockedMapState>()]() mutable
+    {
+      if( !state )
+      {
+        state        = std::make_shared<LockedMapState>();
+        state->sales = salesFor( lanes );
+        for( const auto & upc : upcs() ) state->inventory.emplace( upc, STOCK );
+      }
+
+      return runLanes( state->sales, [&state = *state]( const Upc & upc )
+      {
+        std::lock_guard lock( state.mutex );
+        if( auto item = state.inventory.find( upc );  item != state.inventory.end()  &&  item->second > 0 ) --item->second;
+      } );
+    };
+  }
+
+
+
+  const struct Registrations
+  {
+    Registrations()
+    {
+      for( unsigned lanes : { 1U, 2U, 4U, 8U } )
+      {
+        Benchmark::add( "Inventory/decrementIfAvailable/lanes:"  + std::to_string( lanes ), shardedInventory( lanes ) );
+        Benchmark::add( "Inventory/lockedMapBaseline/lanes:"     + std::to_string( lanes ), lockedMap       ( lanes ) );
+      }
+    }
+  } registrations;
+}    // namespace
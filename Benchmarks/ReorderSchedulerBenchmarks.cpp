@@ -0,0 +1,112 @@
+#include <chrono>                                                               // milliseconds
+#include <cstddef>                                                              // size_t
+#include <cstdint>                                                              // uint64_t
+#include <memory>                                                               // unique_ptr, make_unique()
+#include <optional>
+#include <random>                                                               // mt19937_64, uniform_int_distribution
+#include <string>
+#include <thread>                                                               // jthread
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "Inventory.hpp"
+#include "ReorderScheduler.hpp"
+#include "Upc.hpp"
+
+
+
+// Checkout lanes selling while a scheduler re-orders in the background.  Every grocery item starts at the re-order threshold, so
+// every sale reports low stock until the item is restocked, and sales keep driving items back below it:  the most re-ordering work
+// a lane can cause.  The baseline sells from an inventory stocked too deeply to ever need re-ordering, with nobody observing it, so
+// the difference is everything re-ordering adds to checkout.
+namespace  // anonymous
+{
+  constexpr std::size_t         ITEMS     = 100'000;                            // Distinct grocery items carried
+  constexpr std::size_t         SALES     = 2'000'000;                          // Sales per pass, split across the lanes
+  constexpr Inventory::Quantity THRESHOLD = 15;
+  constexpr Inventory::Quantity LOT_COUNT = 20;
+  constexpr Inventory::Quantity STOCK     = 1'000'000;
+
+  std::vector<Inventory::Item> itemsAt( Inventory::Quantity quantity )
+  {
+    std::vector<Inventory::Item> items;
+    items.reserve( ITEMS );
+    for( std::uint64_t i = 0; i < ITEMS; ++i ) items.emplace_back( *Upc::fromValue( 10'000'000'000'000ULL + i * 7'919 ), quantity );
+    return items;
+  }
+
+  // The grocery items each lane sells, the same every pass
+  std::vector<std::vector<Upc>> salesFor( unsigned lanes )
+  {
+    auto                          items = itemsAt( 0 );
+    std::vector<std::vector<Upc>> sales( lanes );
+    for( unsigned lane = 0; lane < lanes; ++lane )
+    {
+      std::mt19937_64                            generator( lane + 1 );
+      std::uniform_int_distribution<std::size_t> pick( 0, ITEMS - 1 );
+
+      sales[lane].reserve( SALES / lanes );
+      for( std::size_t i = 0; i < SALES / lanes; ++i ) sales[lane].push_back( items[pick( generator )].first );
+    }
+    return sales;
+  }
+
+  std::size_t sell( Inventory & inventory, const std::vector<std::vector<Upc>> & sales )
+  {
+    {
+      std::vector<std::jthread> lanes;
+      for( const auto & lane : sales ) lanes.emplace_back( [&inventory, &lane]
+      {
+        for( const auto & upc : lane ) inventory.decrementIfAvailable( upc );
+      } );
+    }
+    return sales.size() * sales.front().size();
+  }
+
+
+
+  struct Replenished
+  {
+    Inventory                       inventory;
+    std::optional<ReorderScheduler> scheduler;                                  // Declared after the inventory it restocks
+  };
+
+  std::unique_ptr<Replenished> makeReplenished()
+  {
+    auto state = std::make_unique<Replenished>();
+    state->inventory = Inventory( itemsAt( THRESHOLD ) );
+    state->scheduler.emplace( state->inventory, THRESHOLD, LOT_COUNT, std::chrono::milliseconds( 1 ) );
+    state->inventory.observe( [scheduler = &*state->scheduler]( const Upc & upc, std::optional<Inventory::Quantity> quantity ) noexcept
+    {
+      if( quantity  &&  *quantity < THRESHOLD ) scheduler->lowStock( upc );
+    } );
+    return state;
+  }
+
+
+
+  const struct Registrations
+  {
+    Registrations()
+    {
+      for( unsigned lanes : { 1U, 4U } )
+      {
+        auto suffix = "lanes:" + std::to_string( lanes );
+
+        Benchmark::add( "ReorderScheduler/sell/unobserved/" + suffix, [lanes]
+        {
+          static auto       sales     = salesFor( lanes );
+          static Inventory  inventory( itemsAt( STOCK ) );
+          return sell( inventory, sales );
+        } );
+
+        Benchmark::add( "ReorderScheduler/sell/replenished/" + suffix, [lanes]
+        {
+          static auto sales = salesFor( lanes );
+          static auto state = makeReplenished();
+          return sell( state->inventory, sales );
+        } );
+      }
+    }
+  } registrations;
+}    // namespace
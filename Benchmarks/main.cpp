@@ -0,0 +1,10 @@
+#include "Benchmarks/Benchmark.hpp"
+
+
+
+// Usage:  project_benchmarks [filter]
+//   Runs every benchmark whose name contains filter, or all of them if no filter is given
+int main( int argc, char * argv[] )
+{
+  return Benchmark::run( argc, argv );
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <bit>                                                                  // bit_ceil()
+#include <cstddef>                                                              // size_t
+#include <cstdint>                                                              // intptr_t
+#include <memory>                                                               // unique_ptr, make_unique()
+#include <optional>
+#include <utility>                                                              // move()
+
+
+
+// A fixed capacity, lock-free, first in first out queue that any number of threads may push to and pop from at once (Dmitry Vyukov's
+// bounded MPMC queue).  Each cell carries a sequence number recording whose turn it is:  a pusher claims the cell at the tail by
+// advancing the tail with a single compare and swap, fills it, and then publishes it by bumping the cell's sequence number, which is
+// all a popper waits for.  Nobody ever waits on a lock, so a thread that pushes never blocks behind one that pops.  Pushing to a full
+// queue fails rather than waits.
+template<typename T>
+class BoundedQueue
+{
+  public:
+    explicit BoundedQueue( std::size_t capacity )                               // Rounded up to a power of 2
+      : _mask ( std::bit_ceil( capacity < 2  ?  std::size_t{ 2 }  :  capacity ) - 1 ),
+        _cells( std::make_unique<Cell[]>( _mask + 1 ) )
+    {
+      for( std::size_t i = 0; i <= _mask; ++i ) _cells[i].sequence.store( i, std::memory_order_relaxed );
+    }
+
+    BoundedQueue( const BoundedQueue & )             = delete;                  // intentionally prohibit making copies
+    BoundedQueue & operator=( const BoundedQueue & ) = delete;                  // intentionally prohibit copy assignments
+
+
+    // Returns false, leaving the queue unchanged, if the queue is full
+    bool push( T value ) noexcept
+    {
+      auto position = _tail.load( std::memory_order_relaxed );
+      for( ;; )
+      {
+        auto & cell = _cells[position & _mask];
+        auto   lag  = static_cast<std::intptr_t>( cell.sequence.load( std::memory_order_acquire ) ) - static_cast<std::intptr_t>( position );
+
+        if     ( lag == 0 ) { if( _tail.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) break; }
+        else if( lag <  0 ) return false;                                       // the cell still holds a value from a lap ago
+        else                position = _tail.load( std::memory_order_relaxed ); // another pusher claimed the cell first
+      }
+
+      auto & cell = _cells[position & _mask];
+      cell.value  = std::move( value );
+      cell.sequence.store( position + 1, std::memory_order_release );
+      return true;
+    }
+
+
+    // Returns nothing if the queue is empty
+    std::optional<T> pop() noexcept
+    {
+      auto position = _head.load( std::memory_order_relaxed );
+      for( ;; )
+      {
+        auto & cell = _cells[position & _mask];
+        auto   lag  = static_cast<std::intptr_t>( cell.sequence.load( std::memory_order_acquire ) ) - static_cast<std::intptr_t>( position + 1 );
+
+        if     ( lag == 0 ) { if( _head.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) break; }
+        else if( lag <  0 ) return std::nullopt;                                // the cell hasn't been filled yet
+        else                position = _head.load( std::memory_order_relaxed ); // another popper emptied the cell first
+      }
+
+      auto & cell  = _cells[position & _mask];
+      auto   value = std::move( cell.value );
+      cell.sequence.store( position + _mask + 1, std::memory_order_release );
+      return value;
+    }
+
+
+    // Queries
+    std::size_t capacity() const noexcept { return _mask + 1; }
+
+    std::size_t size() const noexcept                                           // Exact only while nobody pushes or pops
+    {
+      auto head = _head.load( std::memory_order_relaxed );
+      auto tail = _tail.load( std::memory_order_relaxed );
+      return tail > head  ?  tail - head  :  0;
+    }
+
+  private:
+    struct Cell
+    {
+      std::atomic<std::size_t> sequence;
+      T                        value{};
+    };
+
+    const std::size_t                    _mask;
+    std::unique_ptr<Cell[]>              _cells;
+    alignas( 64 ) std::atomic<std::size_t> _tail = 0;                           // Next position to push.  On its own cache line, apart from
+    alignas( 64 ) std::atomic<std::size_t> _head = 0;                           // the next position to pop, so pushers and poppers don't false share
+};
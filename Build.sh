@@ -339,7 +339,9 @@ fi
 # temporarily ignore spaces when globing words into file names
 temp=$IFS
   IFS=$'\n'
-  sourceFiles=( $(find -L ./ -path ./.\* -prune -o -name "*.cpp" -print) )              # create array of source files skipping hidden folders (folders that start with a dot)
+  sourceFiles=( $(find -L ./ -path ./.\* -prune -o -path ./Benchmarks -prune -o -path ./Tools -prune -o -name "*.cpp" -print) )              # create array of source files skipping hidden folders (folders that start with a dot), the benchmarks, and the tools
+  benchmarkFiles=( $(find -L ./ -path ./.\* -prune -o -path ./main.cpp -prune -o -path ./RegressionTests -prune -o -path ./Tools -prune -o -name "*.cpp" -print) )   # the benchmarks replace main() and skip the regression tests
+  generatorFiles=( ./Tools/GenerateDataset.cpp ./GroceryItem.cpp ./GroceryItemParser.cpp ./GroceryItemScanner.cpp )           # the dataset generator needs only GroceryItem and what its extraction operator uses
 IFS=$temp
 
 echo "Compiling in \"$PWD\" ..."
@@ -419,3 +421,19 @@ if $GccCommand -include "${complianceHelperFile_path}" -o "${executableFileName}
 else
    exit 1
 fi
+
+echo ""
+
+if $GccCommand -include "${complianceHelperFile_path}" -o "${executableFileName}_benchmarks"  "${benchmarkFiles[@]}"; then
+   echo -e "\nSuccessfully created  \"${executableFileName}_benchmarks\""
+else
+   exit 1
+fi
+
+echo ""
+
+if $GccCommand -include "${complianceHelperFile_path}" -o "${executableFileName}_generator"  "${generatorFiles[@]}"; then
+   echo -e "\nSuccessfully created  \"${executableFileName}_generator\""
+else
+   exit 1
+fi
@@ -1,12 +1,17 @@
-#include <cmath>                                                      // abs(), pow()
-#include <compare>                                                    // weak_ordering
+#include <compare>                                                    // strong_ordering
 #include <iomanip>                                                    // quoted(), ios::failbit
+#include <cstddef>                                                    // size_t
+#include <ios>                                                        // ios_base, streamsize
 #include <iostream>                                                   // istream, ostream, ws()
+#include <locale>
+#include <streambuf>
 #include <string>
-#include <type_traits>                                                // is_floating_point_v, common_type_t
+#include <string_view>
 #include <utility>                                                    // move()
 
 #include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+#include "Money.hpp"
 
 
 
@@ -15,30 +20,19 @@
 *******************************************************************************/
 namespace    // unnamed, anonymous namespace
 {
-  // Avoid direct equality comparisons on floating point numbers. Two values are equal if they are "close enough", which is
-  // represented by Epsilon.  Usually, this is a pretty small number, but since we are dealing with money (only two, maybe three
-  // decimal places) we can be a bit more tolerant.  Two floating point values are considered equal if they are within EPSILON of
-  // each other.
-  template< typename T,  typename U >   requires std::is_floating_point_v<std::common_type_t<T, U> >
-  constexpr bool floating_point_is_equal( T const lhs,  U const rhs,  double const EPSILON = 1e-4 ) noexcept
+  // The characters a stream has read into its buffer but not yet extracted.  std::streambuf shows its get area only to classes
+  // derived from it, so the member functions are named through one.
+  struct GetArea : std::streambuf
   {
-    ///////////////////////// TO-DO (1) //////////////////////////////
-      ///  Write the lines of code that compare two floating point numbers.  Return true when the left hand side (lhs) and the right
-      ///  hand side (rhs) are within Epsilon, and false otherwise.
-      ///
-      ///  See: "Floating point equality" in https://www.learncpp.com/cpp-tutorial/relational-operators-and-floating-point-comparisons/
-      ///
-      ///  Hint:  Avoid writing code that looks like this:
-      ///           if( some expression that is true ) return the constant "true"
-      ///           else                               return the constant "false"
-      ///         for example, avoid:
-      ///           if (a < b) return true;
-      ///           else       return false;
-      ///         do this instead:
-      ///           return a < b;
-    return std::abs(lhs - rhs) <= EPSILON;
-    /////////////////////// END-TO-DO (1) ////////////////////////////
-  }
+    static std::string_view of( std::streambuf * buffer ) noexcept
+    {
+      if( buffer == nullptr ) return {};
+
+      auto first = ( buffer->*&GetArea::gptr  )();
+      auto last  = ( buffer->*&GetArea::egptr )();
+      return { first, static_cast<std::size_t>( last - first ) };
+    }
+  };
 }    // unnamed, anonymous namespace
 
 
@@ -47,12 +41,13 @@ namespace    // unnamed, anonymous namespace
 
 
 
+
 /*******************************************************************************
 **  Constructors, assignments, and destructor
 *******************************************************************************/
 
 // Default and Conversion Constructor
-GroceryItem::GroceryItem( std::string productName, std::string brandName, std::string upcCode, double price )
+GroceryItem::GroceryItem( std::string productName, std::string brandName, std::string upcCode, Money price )
 ///////////////////////// TO-DO (2) //////////////////////////////
   /// Copying the parameters into the object's attributes (member variables) "works" but is not correct.  Be sure to move the parameters into the object's attributes
 :  _upcCode{std::move(upcCode)}, _brandName{std::move(brandName)}, _productName{std::move(productName)}, _price{price} {}
@@ -165,7 +160,7 @@ std::string const & GroceryItem::productName() const &
 
 // price() const    (L-value and, because there is no R-value overload, R-value objects)
 ///////////////////////// TO-DO (11) //////////////////////////////
-double GroceryItem::price() const &
+Money GroceryItem::price() const &
 {
   return _price;
 }
@@ -255,7 +250,7 @@ GroceryItem & GroceryItem::productName(std::string newProductName) &
 
 // price(...)
 ///////////////////////// TO-DO (18) //////////////////////////////
-GroceryItem & GroceryItem::price( double newPrice) &
+GroceryItem & GroceryItem::price( Money newPrice) &
 {
   _price = newPrice;
   return *this;
@@ -274,54 +269,31 @@ GroceryItem & GroceryItem::price( double newPrice) &
 *******************************************************************************/
 
 // operator<=>(...)
-std::weak_ordering GroceryItem::operator<=>( const GroceryItem & rhs ) const noexcept
+std::strong_ordering GroceryItem::operator<=>( const GroceryItem & rhs ) const noexcept
 {
   // Design decision:  A very simple and convenient defaulted 3-way comparison operator
   //                         auto operator<=>( const GroceryItem & ) const = default;
   //                   in the class definition (header file) would get very close to what is needed and would allow both the <=> and
-  //                   the == operators defined here to be skipped.  The physical ordering of the attributes in the class definition
-  //                   would have to be changed (easy enough in this case) but the default directly compares floating point types
-  //                   (price) for equality, and that should be avoided, in general. For example, if x and y are of type double,
-  //                   then  x < y  is okay but  x == y  is not.  So these (operator<=> and operator==) explicit definitions are
-  //                   provided.
-  //
-  //                   Also, many ordering (sorting) algorithms, like those used in std::map and std::set, require at least a weak
-  //                   ordering of elements. operator<=> provides only a partial ordering when comparing floating point numbers.
+  //                   the == operators defined here to be skipped, but only if the physical ordering of the attributes in the class
+  //                   definition were changed to match the order items are sorted.  So these (operator<=> and operator==) explicit
+  //                   definitions are provided.
   //
-  // Weak order:       Objects that compare equal but are not substitutable (identical).  For example, since _price can be within
-  //                   EPSILON, GroceryItem("ProductName", "BrandName", "UPC", 9.99999) and GroceryItem("ProductName", "BrandName",
-  //                   "UPC", 10.00001) are equal but they are not identical.  If you ignore case when comparing strings, as another
-  //                   example, GroceryItem("ProductName") and GroceryItem("productName") are equal but they are not identical.
+  // Strong order:     Objects that compare equal are substitutable (identical).  Price is Money, an exact number of cents, so unlike a
+  //                   floating point number it needs no Epsilon and every attribute, price included, is totally ordered.
   //
-  // See std::weak_ordering    at https://en.cppreference.com/w/cpp/utility/compare/weak_ordering and
-  //     std::partial_ordering at https://en.cppreference.com/w/cpp/utility/compare/partial_ordering
+  // See std::strong_ordering  at https://en.cppreference.com/w/cpp/utility/compare/strong_ordering
   //     The Three-Way Comparison Operator at  http://modernescpp.com/index.php/c-20-the-three-way-comparison-operator
   //     Spaceship (Three way comparison) Operator Demystified https://youtu.be/S9ShnAFmiWM
   //
   //
-  // Grocery items are equal if all attributes are equal (or within Epsilon for floating point numbers, like price). Grocery items are ordered
-  // (sorted) by UPC code, product name, brand name, then price.
+  // Grocery items are equal if all attributes are equal. Grocery items are ordered (sorted) by UPC code, product name, brand name, then
+  // price.
 
   ///////////////////////// TO-DO (19) //////////////////////////////
- auto cheker{_upcCode <=> rhs._upcCode};
-  if (cheker != 0){
-    return cheker;
-  }
-   cheker = _productName <=> rhs._productName;
-  if (cheker != 0) {
-    return cheker;
-  }
-  cheker = _brandName <=> rhs._brandName; 
-  if (cheker != 0){
-    return cheker;
-  } 
-  if ( _price > rhs._price ) {
-    return std::weak_ordering::greater;
-  } 
-  if (_price < rhs._price) {
-    return std::weak_ordering::less;
-  }
-  return std::weak_ordering::equivalent;
+  if( auto result = _upcCode     <=> rhs._upcCode;     result != 0 ) return result;
+  if( auto result = _productName <=> rhs._productName; result != 0 ) return result;
+  if( auto result = _brandName   <=> rhs._brandName;   result != 0 ) return result;
+  return _price <=> rhs._price;
   /////////////////////// END-TO-DO (19) ////////////////////////////
 }
 
@@ -335,7 +307,7 @@ bool GroceryItem::operator==( const GroceryItem & rhs ) const noexcept
   // quickest and then the most likely to be different first.
 
   ///////////////////////// TO-DO (20) //////////////////////////////
-return floating_point_is_equal(_price, rhs._price) && _upcCode == rhs._upcCode && _brandName == rhs._brandName && _productName == rhs._productName;
+return _price == rhs._price && _upcCode == rhs._upcCode && _brandName == rhs._brandName && _productName == rhs._productName;
 
   /////////////////////// END-TO-DO (20) ////////////////////////////
 }
@@ -371,6 +343,22 @@ std::istream & operator>>( std::istream & stream, GroceryItem & groceryItem )
     /// Hint:  Use std::quoted to read and write quoted strings.  See
     ///        1) https://en.cppreference.com/w/cpp/io/manip/quoted
     ///        2) https://www.youtube.com/watch?v=Mu-GUZuU31A
+
+    // A record entirely within what the stream has already buffered is extracted in place by the same rules, and its characters
+    // skipped.  The price must be followed by something buffered, or more digits might have been waiting in the stream.
+    if( stream.good()  &&  ( stream.flags() & std::ios_base::skipws )  &&  stream.getloc() == std::locale::classic() )
+    {
+      auto buffered = GetArea::of( stream.rdbuf() );
+      auto rest     = buffered;
+      GroceryItem extracted;
+      if( extractGroceryItem( rest, extracted )  &&  !rest.empty() )
+      {
+        stream.ignore( static_cast<std::streamsize>( buffered.size() - rest.size() ) );
+        groceryItem = std::move( extracted );
+        return stream;
+      }
+    }
+
     GroceryItem holder;
     char trash{'a'};
     stream >> std::quoted(holder._upcCode) >> trash >> std::quoted(holder._brandName) >> trash >> std::quoted(holder._productName) >> trash >> holder._price;
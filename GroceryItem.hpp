@@ -1,9 +1,11 @@
 #pragma once                                                                  // include guard
 
-#include <compare>                                                            // std::weak_ordering
+#include <compare>                                                            // std::strong_ordering
 #include <iostream>
 #include <string>
 
+#include "Money.hpp"
+
 
 
 
@@ -18,7 +20,7 @@ class GroceryItem
     GroceryItem( std::string productName = {},                                // Default and Conversion (from string to GroceryItem) constructor
                  std::string brandName   = {},                                // String parameters intentionally passed by value.  Not perfect, but very very
                  std::string upcCode     = {},                                // good when combined with move semantics.  See https://youtu.be/PNRju6_yn3o
-                 double      price       = 0.0 );
+                 Money       price       = {} );
 
     GroceryItem & operator=( GroceryItem const  & rhs   ) &;                  // Assignment operators available only for l-values (that's what the trailing "&" means), and then
     GroceryItem & operator=( GroceryItem       && rhs   ) & noexcept;         // the 'Rule of 5' says if you define one, then you should define them all
@@ -31,7 +33,7 @@ class GroceryItem
     std::string const & upcCode    () const &;                                // Returns object's state by constant reference for l-value objects and by value for r-value objects
     std::string const & brandName  () const &;                                // The "const &" at the end says these functions will be called for l-value objects and r-value objects
     std::string const & productName() const &;                                // that (listen carefully) haven't been overloaded.
-    double              price      () const &;                                //
+    Money               price      () const &;                                //
                                                                               //
     std::string         upcCode    ()       &&;                               // Overloads that return an r-value object's state by value (unsafe to return an r-value's state by reference)
     std::string         brandName  ()       &&;                               // The "&&" at the end says these functions will be called only for r-value objects
@@ -42,16 +44,16 @@ class GroceryItem
     GroceryItem & upcCode    ( std::string newUpcCode     ) &;                // String parameters intentionally passed by value
     GroceryItem & brandName  ( std::string newBrandName   ) &;                // Modifiers available for l-values only         (The & at the end says these functions will be called only for l-values)
     GroceryItem & productName( std::string newProductName ) &;                // OK:     GroceryItem b; b.price(13.99);        (b is an l-value, i.e. a named object)
-    GroceryItem & price      ( double      newPrice       ) &;                // Error:  GroceryItem{}.price(13.99);           (The default constructed GrocerItem is an r-value, i.e., an unnamed temporary object)
+    GroceryItem & price      ( Money       newPrice       ) &;                // Error:  GroceryItem{}.price(13.99);           (The default constructed GrocerItem is an r-value, i.e., an unnamed temporary object)
 
 
     // Relational Operators
-    std::weak_ordering operator<=>( GroceryItem const & rhs ) const noexcept;
-    bool               operator== ( GroceryItem const & rhs ) const noexcept;
+    std::strong_ordering operator<=>( GroceryItem const & rhs ) const noexcept;
+    bool                 operator== ( GroceryItem const & rhs ) const noexcept;
 
   private:
     std::string _upcCode;                                                     // a 12 or 14-digit international Universal Product Code uniquely identifying this item (Ex: 051600080015, 05017402006207)
     std::string _brandName;                                                   // the product manufacturer's brand name (Ex: Heinz, Boston Market)
     std::string _productName;                                                 // the name of the product (Ex: Heinz Tomato Ketchup - 2 Ct, Boston Market Spaghetti With Meatballs)
-    double      _price{ 0.0 };                                                // the cost of the item in US Dollars (Ex:  2.29, 1.19)
+    Money       _price;                                                       // the cost of the item in US Dollars, exact to the cent (Ex:  2.29, 1.19)
 };
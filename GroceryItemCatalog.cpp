@@ -0,0 +1,311 @@
+#include <algorithm>                                                    // clamp(), fill_n(), lower_bound(), max(), min(), upper_bound()
+#include <atomic>                                                       // atomic_ref
+#include <bit>                                                          // bit_ceil(), countr_zero()
+#include <cstddef>                                                      // ptrdiff_t, size_t
+#include <cstdint>                                                      // uint32_t, uint64_t
+#include <functional>                                                   // hash
+#include <memory>                                                       // make_shared()
+#include <string>
+#include <string_view>
+#include <thread>                                                       // jthread, hardware_concurrency()
+#include <utility>                                                      // move()
+#include <vector>
+
+#include "GroceryItemCatalog.hpp"
+#include "Money.hpp"
+#include "Upc.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  constexpr std::size_t MINIMUM_INDEX_RUN = 1 << 18;                    // Not worth starting a thread for fewer than this many grocery items
+  constexpr std::size_t PROBE_GROUP       = 32;                         // UPCs whose home slots are prefetched together by a batched find
+
+
+
+  // The high bits of a Fibonacci hash are the best mixed, so they select the slot
+  std::size_t homeSlot( std::uint64_t key, std::size_t capacity ) noexcept
+  { return std::hash<Upc>{}( *Upc::fromValue( key ) ) >> ( 64 - std::countr_zero( capacity ) ); }
+}    // unnamed, anonymous namespace
+
+
+
+
+// Storage owned by a catalog made with a Builder.  A catalog mapped from a snapshot refers to the snapshot's bytes instead.
+struct GroceryItemCatalog::Columns
+{
+  std::vector<std::uint64_t> upcs;
+  std::vector<Money::Cents>  prices;
+  std::vector<std::uint32_t> brands;
+  std::vector<std::uint64_t> productOffsets{ 0 };
+  std::string                productText;
+  std::vector<std::uint64_t> brandOffsets{ 0 };
+  std::string                brandText;
+  std::vector<Slot>          index;
+};
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Queries
+*******************************************************************************/
+std::size_t GroceryItemCatalog::size() const noexcept
+{ return _upcs.size(); }
+
+
+
+std::size_t GroceryItemCatalog::brandCount() const noexcept
+{ return _brandOffsets.empty() ? 0 : _brandOffsets.size() - 1; }
+
+
+
+std::size_t GroceryItemCatalog::memoryUsage() const noexcept
+{
+  return _upcs          .size_bytes()  +  _prices      .size_bytes()  +  _brands   .size_bytes()
+       + _productOffsets.size_bytes()  +  _productText .size_bytes()
+       + _brandOffsets  .size_bytes()  +  _brandText   .size_bytes()  +  _index    .size_bytes();
+}
+
+
+
+GroceryItemCatalog::Record GroceryItemCatalog::find( const Upc & upc ) const noexcept
+{
+  if( _index.empty() ) return NOT_FOUND;
+
+  auto mask = _index.size() - 1;
+  for( auto slot = homeSlot( upc.value(), _index.size() );  ;  slot = ( slot + 1 ) & mask )
+  {
+    if( _index[slot].key == upc.value() ) return _index[slot].record;
+    if( _index[slot].key == EMPTY_SLOT  ) return NOT_FOUND;
+  }
+}
+
+
+
+// Looking up UPCs one at a time serializes the cache misses:  each probe waits on memory before the next can start.  Here the home
+// slots of a whole group of UPCs are computed and prefetched first, so their misses are in flight together, and then the group is
+// probed with most of its slots already on the way into cache.
+void GroceryItemCatalog::find( std::span<const Upc> upcs, std::span<Record> records ) const noexcept
+{
+  if( _index.empty() )
+  {
+    std::fill_n( records.begin(), upcs.size(), NOT_FOUND );
+    return;
+  }
+
+  auto        mask = _index.size() - 1;
+  std::size_t homeSlots[PROBE_GROUP];
+
+  for( std::size_t first = 0;  first < upcs.size();  first += PROBE_GROUP )
+  {
+    auto count = std::min( PROBE_GROUP, upcs.size() - first );
+
+    for( std::size_t i = 0; i < count; ++i )
+    {
+      homeSlots[i] = homeSlot( upcs[first + i].value(), _index.size() );
+      __builtin_prefetch( &_index[homeSlots[i]] );
+    }
+
+    for( std::size_t i = 0; i < count; ++i )
+    {
+      auto key = upcs[first + i].value();
+      for( auto slot = homeSlots[i];  ;  slot = ( slot + 1 ) & mask )
+      {
+        if( _index[slot].key == key        ) { records[first + i] = _index[slot].record;  break; }
+        if( _index[slot].key == EMPTY_SLOT ) { records[first + i] = NOT_FOUND;            break; }
+      }
+    }
+  }
+}
+
+
+
+// The UPCs are already sorted, so they serve as the ordered index:  two binary searches bound the grocery items in range, however
+// many there are, and they are then read straight from the columns in order.
+GroceryItemCatalog::Records GroceryItemCatalog::range( const Upc & first, const Upc & last ) const noexcept
+{
+  if( last < first ) return {};
+
+  auto begin = std::lower_bound( _upcs.begin(), _upcs.end(), first.value() );
+  auto end   = std::upper_bound( begin,         _upcs.end(), last .value() );
+  return { static_cast<Record>( begin - _upcs.begin() ), static_cast<Record>( end - _upcs.begin() ) };
+}
+
+
+
+// Steps of 1, 2, 4, ... from the hint find a stretch of UPCs that ends at or after upc, then a binary search within it.  A search
+// costs the logarithm of the distance moved rather than of the catalog's size.  A UPC before the hint starts over from the beginning.
+GroceryItemCatalog::Record GroceryItemCatalog::lowerBound( const Upc & upc, Record hint ) const noexcept
+{
+  std::size_t first = hint <= _upcs.size()  &&  ( hint == 0  ||  _upcs[hint - 1] < upc.value() )  ?  hint  :  0;
+
+  std::size_t step = 1;
+  while( first + step <= _upcs.size()  &&  _upcs[first + step - 1] < upc.value() )
+  {
+    first += step;
+    step  *= 2;
+  }
+
+  auto begin = _upcs.begin() + static_cast<std::ptrdiff_t>( first );
+  auto end   = _upcs.begin() + static_cast<std::ptrdiff_t>( std::min( first + step, _upcs.size() ) );
+  return static_cast<Record>( std::lower_bound( begin, end, upc.value() ) - _upcs.begin() );
+}
+
+
+
+Upc GroceryItemCatalog::upc( Record record ) const noexcept
+{ return *Upc::fromValue( _upcs[record] ); }
+
+
+
+std::string_view GroceryItemCatalog::brandName( Record record ) const noexcept
+{
+  auto brand = _brands[record];
+  return { _brandText.data() + _brandOffsets[brand], _brandOffsets[brand + 1] - _brandOffsets[brand] };
+}
+
+
+
+std::string_view GroceryItemCatalog::productName( Record record ) const noexcept
+{ return { _productText.data() + _productOffsets[record], _productOffsets[record + 1] - _productOffsets[record] }; }
+
+
+
+Money GroceryItemCatalog::price( Record record ) const noexcept
+{ return Money::fromCents( _prices[record] ); }
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Builder
+*******************************************************************************/
+GroceryItemCatalog::Builder::Builder()
+  : _columns( std::make_shared<Columns>() )
+{}
+
+
+
+GroceryItemCatalog::Builder::Builder( const GroceryItemCatalog & base )
+  : Builder()
+{
+  reserve( base.size(), base._productText.size() );
+  for( std::size_t brand = 0; brand < base.brandCount(); ++brand )
+  {
+    internBrand( { base._brandText.data() + base._brandOffsets[brand], base._brandOffsets[brand + 1] - base._brandOffsets[brand] } );
+  }
+}
+
+
+
+void GroceryItemCatalog::Builder::reserve( std::size_t groceryItems, std::size_t productTextSize )
+{
+  _columns->upcs          .reserve( groceryItems     );
+  _columns->prices        .reserve( groceryItems     );
+  _columns->brands        .reserve( groceryItems     );
+  _columns->productOffsets.reserve( groceryItems + 1 );
+  _columns->productText   .reserve( productTextSize  );
+}
+
+
+
+std::uint32_t GroceryItemCatalog::Builder::internBrand( std::string_view brandName )
+{
+  if( auto existing = _brandIds.find( brandName );  existing != _brandIds.end() ) return existing->second;
+
+  auto brand = static_cast<std::uint32_t>( _brandIds.size() );
+  _brandIds.emplace( brandName, brand );
+  _columns->brandText += brandName;
+  _columns->brandOffsets.push_back( _columns->brandText.size() );
+  return brand;
+}
+
+
+
+void GroceryItemCatalog::Builder::append( const Upc & upc, std::uint32_t brand, std::string_view productName, Money price )
+{
+  _columns->upcs       .push_back( upc.value()   );
+  _columns->prices     .push_back( price.cents() );
+  _columns->brands     .push_back( brand         );
+  _columns->productText.append   ( productName   );
+  _columns->productOffsets.push_back( _columns->productText.size() );
+}
+
+
+
+void GroceryItemCatalog::Builder::append( const Upc & upc, std::string_view brandName, std::string_view productName, Money price )
+{ append( upc, internBrand( brandName ), productName, price ); }
+
+
+
+// The base catalog's brand names were interned first and in order, so its brand numbers are this builder's too
+void GroceryItemCatalog::Builder::append( const GroceryItemCatalog & base, Record record )
+{
+  _columns->upcs       .push_back( base._upcs  [record]   );
+  _columns->prices     .push_back( base._prices[record]   );
+  _columns->brands     .push_back( base._brands[record]   );
+  _columns->productText.append   ( base.productName( record ) );
+  _columns->productOffsets.push_back( _columns->productText.size() );
+}
+
+
+
+// Sizes the hash index for the grocery items appended and inserts them all.  Larger catalogs are split into runs inserted
+// concurrently, claiming slots with an atomic compare and swap on the slot's key.
+GroceryItemCatalog GroceryItemCatalog::Builder::build() &&
+{
+  auto & columns  = *_columns;
+  auto   count    = columns.upcs.size();
+  auto   capacity = std::max<std::size_t>( std::bit_ceil( count + count / 3 + 1 ), 16 );
+  columns.index.assign( capacity, Slot{} );
+
+  auto insert = [&columns, mask = capacity - 1]( std::size_t first, std::size_t last ) noexcept
+  {
+    for( auto record = first;  record < last;  ++record )
+    {
+      auto key = columns.upcs[record];
+      for( auto slot = homeSlot( key, columns.index.size() );  ;  slot = ( slot + 1 ) & mask )
+      {
+        auto empty = EMPTY_SLOT;
+        if( std::atomic_ref<std::uint64_t>( columns.index[slot].key ).compare_exchange_strong( empty, key, std::memory_order_relaxed ) )
+        {
+          columns.index[slot].record = static_cast<Record>( record );
+          break;
+        }
+      }
+    }
+  };
+
+  auto threadCount = std::clamp<std::size_t>( count / MINIMUM_INDEX_RUN, 1, std::max( 1u, std::thread::hardware_concurrency() ) );
+  {
+    std::vector<std::jthread> workers;
+    for( std::size_t i = 0; i < threadCount; ++i ) workers.emplace_back( insert, count * i / threadCount, count * ( i + 1 ) / threadCount );
+  }                                                                     // joining the workers publishes every slot written
+
+  GroceryItemCatalog catalog;
+  catalog._upcs           = columns.upcs;
+  catalog._prices         = columns.prices;
+  catalog._brands         = columns.brands;
+  catalog._productOffsets = columns.productOffsets;
+  catalog._productText    = columns.productText;
+  catalog._brandOffsets   = columns.brandOffsets;
+  catalog._brandText      = columns.brandText;
+  catalog._index          = columns.index;
+  catalog._storage        = std::move( _columns );
+
+  _brandIds.clear();
+  return catalog;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>                                                              // size_t
+#include <cstdint>                                                              // uint32_t, uint64_t
+#include <functional>                                                           // equal_to, hash
+#include <memory>                                                               // shared_ptr
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Money.hpp"
+#include "Upc.hpp"
+
+
+
+// An immutable, columnar (structure of arrays) collection of grocery items sorted by UPC, with a hash index for constant time lookup.
+//   o  UPCs and prices are dense arrays
+//   o  Brand names repeat heavily, so each distinct brand name is stored once in a dictionary and grocery items refer to it by number
+//   o  Product names are stored back to back in one contiguous arena
+// A catalog is either built from parsed grocery items with a Builder, or mapped directly from a snapshot file with no per-item work
+// at all.  Copies are cheap and share the same underlying storage.
+class GroceryItemCatalog
+{
+  public:
+    using Record = std::uint32_t;                                               // Position of a grocery item in the catalog
+    inline static constexpr Record NOT_FOUND = ~Record{ 0 };
+
+    class Builder;
+
+    struct Records                                                              // Consecutive positions [begin, end)
+    {
+      Record begin = 0;
+      Record end   = 0;
+    };
+
+    // The text file a catalog was built from, used to detect stale snapshots
+    struct Source
+    {
+      std::string   filename;
+      std::uint64_t size     = 0;
+      std::int64_t  modified = 0;                                               // Last write time, in file clock ticks
+    };
+
+    // Queries
+    std::size_t      size       (                     ) const noexcept;        // Number of grocery items
+    Record           find       ( const Upc & upc     ) const noexcept;        // Position of the grocery item with this UPC, or NOT_FOUND
+    void             find       ( std::span<const Upc> upcs,                    // Batched find:  records[i] is the position of upcs[i], or
+                                  std::span<Record>    records ) const noexcept;  // NOT_FOUND.  records must be at least as long as upcs
+    Records          range      ( const Upc & first,                            // Positions of the grocery items whose UPCs lie between first and
+                                  const Upc & last    ) const noexcept;        // last inclusive, found by binary search of the sorted UPCs
+    Record           lowerBound ( const Upc & upc,                              // Position of the first grocery item whose UPC isn't less than upc,
+                                  Record      hint    ) const noexcept;        // galloping forward from hint, so searches for increasing UPCs
+                                                                                // merge with the sorted UPCs.  size() if there is none
+
+    Upc              upc        ( Record record       ) const noexcept;        // Attributes of the grocery item at a position
+    std::string_view brandName  ( Record record       ) const noexcept;
+    std::string_view productName( Record record       ) const noexcept;
+    Money            price      ( Record record       ) const noexcept;
+
+    std::size_t      brandCount (                     ) const noexcept;        // Number of distinct brand names
+    std::size_t      memoryUsage(                     ) const noexcept;        // Bytes of column and index storage
+
+
+    // Snapshot persistence
+    bool writeSnapshot( const std::string & filename, const Source & source ) const;                   // Returns true on success
+    static bool mapSnapshot( const std::string & filename, GroceryItemCatalog & catalog, Source & source );  // Returns false, leaving catalog unchanged,
+                                                                                                       // if the snapshot is damaged
+  private:
+    // A slot pairs a packed UPC with the position of its grocery item, so a successful probe usually touches exactly one cache line
+    // of the index.  The index is an open addressing (linear probing) hash table whose capacity is a power of 2 at most 75% full.
+    inline static constexpr std::uint64_t EMPTY_SLOT = ~0ULL;                   // No UPC packs to this value
+
+    struct Slot
+    {
+      std::uint64_t key    = EMPTY_SLOT;                                        // Upc::value() of the grocery item
+      Record        record = 0;
+    };
+
+    struct Columns;                                                             // Owned storage for catalogs made by a Builder
+
+    std::shared_ptr<const void>    _storage;                                    // Keeps alive whatever the spans refer to:  a Columns object or a memory mapped snapshot
+
+    std::span<const std::uint64_t> _upcs;                                       // Upc::value() of each grocery item, ascending
+    std::span<const Money::Cents>  _prices;
+    std::span<const std::uint32_t> _brands;                                     // Each grocery item's position in the brand name dictionary
+    std::span<const std::uint64_t> _productOffsets;                             // Product name i is _productText[ _productOffsets[i], _productOffsets[i+1] )
+    std::span<const char>          _productText;
+    std::span<const std::uint64_t> _brandOffsets;                               // Brand name i is _brandText[ _brandOffsets[i], _brandOffsets[i+1] )
+    std::span<const char>          _brandText;
+    std::span<const Slot>          _index;
+};
+
+
+
+
+// Accumulates grocery items in increasing UPC order, then builds a catalog
+class GroceryItemCatalog::Builder
+{
+  public:
+    Builder();
+    explicit Builder( const GroceryItemCatalog & base );                        // Starts with base's brand name dictionary, and room for base's
+                                                                                // grocery items, so they can be copied with append( base, record )
+    void          reserve    ( std::size_t groceryItems, std::size_t productTextSize );
+    std::uint32_t internBrand( std::string_view brandName );                    // Returns the brand name's position in the dictionary, adding it if new
+    void          append     ( const Upc & upc, std::uint32_t brand,       std::string_view productName, Money  price );   // UPCs must be appended
+    void          append     ( const Upc & upc, std::string_view brandName, std::string_view productName, Money  price );   // in strictly increasing order
+    void          append     ( const GroceryItemCatalog & base, Record record );                                           // Copies a grocery item from the
+                                                                                                                            // catalog this builder started with
+
+    GroceryItemCatalog build() &&;                                              // Builds the hash index, concurrently for larger catalogs
+
+  private:
+    struct TransparentHash
+    {
+      using is_transparent = void;
+      std::size_t operator()( std::string_view text ) const noexcept { return std::hash<std::string_view>{}( text ); }
+    };
+
+    std::shared_ptr<Columns>                                                        _columns;
+    std::unordered_map<std::string, std::uint32_t, TransparentHash, std::equal_to<>> _brandIds;
+};
@@ -0,0 +1,276 @@
+#include <bit>                                                          // has_single_bit(), rotl()
+#include <cstddef>                                                      // size_t
+#include <cstdint>                                                      // uint32_t, uint64_t, int64_t
+#include <cstring>                                                      // memcpy(), memcmp()
+#include <filesystem>                                                   // rename(), remove()
+#include <fstream>                                                      // ofstream, fstream
+#include <iostream>                                                     // cerr
+#include <memory>                                                       // make_shared()
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>                                                 // error_code
+#include <utility>                                                      // move()
+
+#include "GroceryItemCatalog.hpp"
+#include "MemoryMappedFile.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // Snapshot file layout (native byte order).  Every section begins on an 8 byte boundary so it can be used in place, straight out of
+  // the mapped file, and a section's offset follows from the counts in the header alone.
+  //
+  //    +--------------------+   Fixed size header identifying the format, the text file the snapshot was made from, and the
+  //    |  Header            |   checksum of everything that follows
+  //    +--------------------+
+  //    |  Source name       |   The text file's name
+  //    |  UPCs              |   uint64_t [recordCount], ascending
+  //    |  Prices            |   int64_t  [recordCount], in cents
+  //    |  Brands            |   uint32_t [recordCount], positions in the brand name dictionary
+  //    |  Product offsets   |   uint64_t [recordCount + 1]
+  //    |  Brand offsets     |   uint64_t [brandCount  + 1]
+  //    |  Index             |   Slot     [indexCapacity]
+  //    |  Product text      |   char     [productTextSize]
+  //    |  Brand text        |   char     [brandTextSize]
+  //    +--------------------+
+  constexpr char          MAGIC[8] = { 'G', 'I', 'D', 'B', 'S', 'N', 'A', 'P' };
+  constexpr std::uint32_t VERSION  = 3;
+  constexpr std::size_t   ALIGNMENT = 8;
+
+  struct Header
+  {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t slotSize;                                             // Guards against a change in Slot's layout without a version change
+    std::uint64_t recordCount;
+    std::uint64_t brandCount;
+    std::uint64_t indexCapacity;
+    std::uint64_t productTextSize;
+    std::uint64_t brandTextSize;
+    std::uint64_t sourceSize;                                           // Size and last write time of the text file this snapshot reflects.  If
+    std::int64_t  sourceModified;                                       // either differ from the text file's current values, the snapshot is stale
+    std::uint64_t checksum;                                             // Of everything after the header
+    std::uint32_t sourceNameLength;
+    std::uint32_t reserved;
+  };
+
+  static_assert( sizeof( Header ) == 88  &&  sizeof( Header ) % ALIGNMENT == 0, "Snapshot layout must not depend on the compiler" );
+
+
+
+  // Byte offset of each section from the beginning of the file
+  struct Layout
+  {
+    std::size_t sourceName, upcs, prices, brands, productOffsets, brandOffsets, index, productText, brandText, end;
+  };
+
+  Layout layout( const Header & header, std::size_t slotSize ) noexcept
+  {
+    auto next = []( std::size_t offset, std::size_t bytes ) { return ( offset + bytes + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT; };
+
+    Layout sections{};
+    sections.sourceName     = sizeof( Header );
+    sections.upcs           = next( sections.sourceName,     header.sourceNameLength                          );
+    sections.prices         = next( sections.upcs,           header.recordCount          * sizeof( std::uint64_t ) );
+    sections.brands         = next( sections.prices,         header.recordCount          * sizeof( std::int64_t  ) );
+    sections.productOffsets = next( sections.brands,         header.recordCount          * sizeof( std::uint32_t ) );
+    sections.brandOffsets   = next( sections.productOffsets, ( header.recordCount + 1 )  * sizeof( std::uint64_t ) );
+    sections.index          = next( sections.brandOffsets,   ( header.brandCount  + 1 )  * sizeof( std::uint64_t ) );
+    sections.productText    = next( sections.index,          header.indexCapacity        * slotSize                );
+    sections.brandText      = next( sections.productText,    header.productTextSize                            );
+    sections.end            = next( sections.brandText,      header.brandTextSize                              );
+    return sections;
+  }
+
+
+
+  // A fast, non-cryptographic checksum.  Good at detecting truncation and corruption, not tampering.  Four independent lanes keep
+  // several multiplies in flight at once, so a large snapshot is verified at close to memory bandwidth.
+  std::uint64_t checksum( std::string_view bytes ) noexcept
+  {
+    constexpr std::uint64_t K1 = 0x9E37'79B9'7F4A'7C15ULL;
+    constexpr std::uint64_t K2 = 0xC2B2'AE3D'27D4'EB4FULL;
+    constexpr std::size_t   WORD = sizeof( std::uint64_t );
+
+    std::uint64_t lanes[4] = { bytes.size() * K1,  bytes.size() * K2,  ~bytes.size() * K1,  ~bytes.size() * K2 };
+
+    auto mix = []( std::uint64_t hash, const char * word ) noexcept
+    {
+      std::uint64_t value;
+      std::memcpy( &value, word, WORD );
+      return std::rotl( hash ^ ( value * K2 ), 31 ) * K1;
+    };
+
+    std::size_t i = 0;
+    for( ;  i + 4 * WORD <= bytes.size();  i += 4 * WORD )
+    {
+      for( std::size_t lane = 0; lane < 4; ++lane ) lanes[lane] = mix( lanes[lane], bytes.data() + i + lane * WORD );
+    }
+
+    std::uint64_t hash = lanes[0] ^ std::rotl( lanes[1], 17 ) ^ std::rotl( lanes[2], 34 ) ^ std::rotl( lanes[3], 51 );
+    for( ;  i + WORD <= bytes.size();  i += WORD ) hash = mix( hash, bytes.data() + i );
+
+    char tail[WORD] = {};
+    std::memcpy( tail, bytes.data() + i, bytes.size() - i );
+    hash = mix( hash, tail );
+
+    return hash ^ ( hash >> 29 );
+  }
+
+
+
+  // Views count objects of type T in place, beginning offset bytes into the mapped file
+  template<typename T>
+  std::span<const T> section( std::string_view bytes, std::size_t offset, std::size_t count ) noexcept
+  { return { static_cast<const T *>( static_cast<const void *>( bytes.data() + offset ) ), count }; }
+
+
+
+  // Writes a section's bytes followed by zero padding up to where the next section begins
+  template<typename T>
+  void writeSection( std::ostream & stream, std::span<const T> items, std::size_t & offset, std::size_t next )
+  {
+    stream.write( static_cast<const char *>( static_cast<const void *>( items.data() ) ), static_cast<std::streamsize>( items.size_bytes() ) );
+    offset += items.size_bytes();
+
+    constexpr char padding[ALIGNMENT] = {};
+    stream.write( padding, static_cast<std::streamsize>( next - offset ) );
+    offset = next;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Snapshot persistence
+*******************************************************************************/
+bool GroceryItemCatalog::mapSnapshot( const std::string & filename, GroceryItemCatalog & catalog, Source & source )
+{
+  auto file  = std::make_shared<MemoryMappedFile>( filename, MemoryMappedFile::AccessPattern::NORMAL );
+  auto bytes = file->view();
+
+  Header header{};
+  if( bytes.size() < sizeof( header ) ) return false;
+  std::memcpy( &header, bytes.data(), sizeof( header ) );
+
+  if(    std::memcmp( header.magic, MAGIC, sizeof( MAGIC ) ) != 0
+      || header.version  != VERSION
+      || header.slotSize != sizeof( Slot ) ) return false;
+
+  // Bounding every count by the file's size first guarantees computing the layout can't overflow
+  if(    header.recordCount     > bytes.size()  ||  header.recordCount >= NOT_FOUND
+      || header.brandCount      > bytes.size()
+      || header.indexCapacity   > bytes.size()  ||  !std::has_single_bit( header.indexCapacity )  ||  header.indexCapacity <= header.recordCount
+      || header.productTextSize > bytes.size()
+      || header.brandTextSize   > bytes.size() ) return false;
+
+  auto sections = layout( header, sizeof( Slot ) );
+  if(    sections.end != bytes.size()
+      || checksum( bytes.substr( sizeof( header ) ) ) != header.checksum ) return false;
+
+  GroceryItemCatalog mapped;
+  mapped._upcs           = section<std::uint64_t>( bytes, sections.upcs,           header.recordCount     );
+  mapped._prices         = section<std::int64_t >( bytes, sections.prices,         header.recordCount     );
+  mapped._brands         = section<std::uint32_t>( bytes, sections.brands,         header.recordCount     );
+  mapped._productOffsets = section<std::uint64_t>( bytes, sections.productOffsets, header.recordCount + 1 );
+  mapped._brandOffsets   = section<std::uint64_t>( bytes, sections.brandOffsets,   header.brandCount  + 1 );
+  mapped._index          = section<Slot         >( bytes, sections.index,          header.indexCapacity   );
+  mapped._productText    = section<char         >( bytes, sections.productText,    header.productTextSize );
+  mapped._brandText      = section<char         >( bytes, sections.brandText,      header.brandTextSize   );
+
+  // The checksum catches damage, these catch a writer that got the offsets wrong
+  if(    mapped._productOffsets.front() != 0  ||  mapped._productOffsets.back() != header.productTextSize
+      || mapped._brandOffsets  .front() != 0  ||  mapped._brandOffsets  .back() != header.brandTextSize ) return false;
+
+  source.filename = bytes.substr( sections.sourceName, header.sourceNameLength );
+  source.size     = header.sourceSize;
+  source.modified = header.sourceModified;
+
+  mapped._storage = std::move( file );
+  catalog         = std::move( mapped );
+  return true;
+}
+
+
+
+
+bool GroceryItemCatalog::writeSnapshot( const std::string & filename, const Source & source ) const
+{
+  Header header{};
+  std::memcpy( header.magic, MAGIC, sizeof( MAGIC ) );
+  header.version          = VERSION;
+  header.slotSize         = sizeof( Slot );
+  header.recordCount      = size();
+  header.brandCount       = brandCount();
+  header.productTextSize  = _productText.size();
+  header.brandTextSize    = _brandText.size();
+  header.sourceSize       = source.size;
+  header.sourceModified   = source.modified;
+  header.sourceNameLength = static_cast<std::uint32_t>( source.filename.size() );
+
+  // Even an empty catalog's snapshot must map back to a well formed catalog
+  const std::uint64_t noOffsets[] = { 0 };
+  const Slot          noSlots  [16] = {};
+  auto productOffsets = _productOffsets.empty() ? std::span<const std::uint64_t>( noOffsets ) : _productOffsets;
+  auto brandOffsets   = _brandOffsets  .empty() ? std::span<const std::uint64_t>( noOffsets ) : _brandOffsets;
+  auto index          = _index         .empty() ? std::span<const Slot         >( noSlots   ) : _index;
+  header.indexCapacity = index.size();
+
+  auto sections = layout( header, sizeof( Slot ) );
+
+  // Write to a temporary file and then rename it into place so no one ever maps a partially written snapshot.  The checksum is
+  // computed by mapping what was written, then patched into the header.
+  auto temporaryFilename = filename + ".tmp";
+  auto failed = [&]( const std::string & reason )
+  {
+    std::cerr << "Warning:  Could not write grocery item database snapshot \"" << filename << "\":  " << reason << "\n\n";
+    std::error_code error;
+    std::filesystem::remove( temporaryFilename, error );
+    return false;
+  };
+
+  {
+    std::ofstream fout( temporaryFilename, std::ios::binary | std::ios::trunc );
+    std::size_t   offset = 0;
+    writeSection( fout, std::span<const Header>( &header, 1 ),   offset, sections.sourceName     );
+    writeSection( fout, std::span<const char>( source.filename ), offset, sections.upcs           );
+    writeSection( fout, _upcs,                                   offset, sections.prices         );
+    writeSection( fout, _prices,                                 offset, sections.brands         );
+    writeSection( fout, _brands,                                 offset, sections.productOffsets );
+    writeSection( fout, productOffsets,                          offset, sections.brandOffsets   );
+    writeSection( fout, brandOffsets,                            offset, sections.index          );
+    writeSection( fout, index,                                   offset, sections.productText    );
+    writeSection( fout, _productText,                            offset, sections.brandText      );
+    writeSection( fout, _brandText,                              offset, sections.end            );
+
+    if( !fout.flush() ) return failed( "write failed" );
+  }
+
+  {
+    MemoryMappedFile written( temporaryFilename );
+    if( written.size() != sections.end ) return failed( "write was incomplete" );
+    header.checksum = checksum( written.view().substr( sizeof( header ) ) );
+  }
+
+  {
+    std::fstream patch( temporaryFilename, std::ios::binary | std::ios::in | std::ios::out );
+    patch.write( static_cast<const char *>( static_cast<const void *>( &header ) ), sizeof( header ) );
+    if( !patch.flush() ) return failed( "write failed" );
+  }
+
+  std::error_code error;
+  std::filesystem::rename( temporaryFilename, filename, error );
+  if( error ) return failed( error.message() );
+
+  return true;
+}
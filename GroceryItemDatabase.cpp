@@ -3,24 +3,253 @@
   /// Hint:  Include what you use, use what you include
   ///
   /// Do not put anything else in this section, i.e. comments, classes, functions, etc.  Only #include directives
+  #include <algorithm>
+  #include <array>
+  #include <atomic>
+  #include <cerrno>
+  #include <chrono>
+  #include <cstddef>
+  #include <cstdint>
+  #include <cstring>
+  #include <deque>
   #include <filesystem>
   #include <fstream>
+  #include <iomanip>
+  #include <iostream>
+  #include <memory>
+  #include <memory_resource>
+  #include <mutex>
+  #include <queue>
+  #include <shared_mutex>
+  #include <span>
+  #include <sstream>
   #include <string>
+  #include <string_view>
+  #include <system_error>
+  #include <thread>
+  #include <unordered_map>
+  #include <utility>
+  #include <vector>
 
+  #include <fcntl.h>
+  #include <unistd.h>
 
   #include <GroceryItemDatabase.hpp>
   #include <GroceryItem.hpp>
+  #include <GroceryItemCatalog.hpp>
+  #include <GroceryItemParser.hpp>
+  #include <GroceryItemScanner.hpp>
+  #include <MemoryMappedFile.hpp>
+  #include <Upc.hpp>
 /////////////////////// END-TO-DO (1) ////////////////////////////
 
 
 
-// Return a reference to the one and only instance of the database
-GroceryItemDatabase & GroceryItemDatabase::instance()
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
 {
-  // Want to probe for persistent database file only the first time called.  By making a (Lambda) function that returns the results
-  // of the probe and then calling that when fist construction the instance ensure all this probing stuff happens only the first
-  // time instance() is called.
-  auto getFileName = []()
+  using Clock = std::chrono::steady_clock;
+
+  constexpr std::size_t MINIMUM_CHUNK_SIZE = 1 << 20;                           // Not worth starting a thread for less than this many bytes
+  constexpr std::size_t QUOTES_PER_RECORD  = 6;                                 // UPC, brand name, and product name are each enclosed in quotes
+  constexpr char        WHITESPACE[]       = " \t\n\v\f\r";
+
+
+
+  // A grocery item as parsed from a chunk.  The product name refers directly into the mapped file, or to the chunk's unescaped copy.
+  struct ParsedItem
+  {
+    Upc              upc;
+    Money            price;
+    std::string_view productName;
+    std::uint32_t    brand   = 0;                                               // Position in the chunk's brand names
+    bool             deleted = false;                                           // A deletion from a changes file, which has only a UPC
+  };
+
+
+
+  // A contiguous run of whole records, parsed independently of all other chunks
+  struct Chunk
+  {
+    std::string_view              text;                                         // From the start of its first record to the start of the next chunk's
+    std::vector<ParsedItem>       groceryItems;                                 // Sorted by UPC, and within a UPC in file order
+    std::vector<std::string_view> brandNames;                                   // Each distinct brand name in the chunk, interned as they're parsed
+    std::deque<std::string>       unescaped;                                    // Fields whose escapes were removed; a deque never moves its elements
+    std::size_t                   parsed   = 0;                                 // Records parsed, including those rejected
+    std::size_t                   rejected = 0;                                 // Records whose UPC is malformed
+    bool                          complete = false;                             // True if every record in text parsed
+  };
+
+
+
+  // Moves a tentative chunk boundary forward to just past the next newline not preceded by a backslash.  A chunk never begins in
+  // the middle of an escape sequence, so counting quotes in a chunk does not depend on what came before it.
+  std::size_t alignToLine( std::string_view text, std::size_t position )
+  {
+    while( position < text.size() )
+    {
+      position = text.find( '\n', position );
+      if( position == std::string_view::npos ) return text.size();
+
+      ++position;
+      if( position < 2  ||  text[position - 2] != '\\' ) return position;
+    }
+    return text.size();
+  }
+
+
+
+  // Returns the offset of the first record to begin in text, given the number of unescaped quotes in the file before text.  Every
+  // record has exactly QUOTES_PER_RECORD unescaped quotes, so a record begins at every quote whose position in the file, counting
+  // from zero, is a multiple of QUOTES_PER_RECORD.  This correctly steps over quoted strings that contain escaped quotes and
+  // newlines, neither of which can be recognized as a record boundary by looking at the text alone.
+  std::size_t findRecordStart( std::string_view text, std::size_t quotesBefore ) noexcept
+  {
+    GroceryItemScanner scanner( text );
+    for( auto offset = scanner.next();  offset != GroceryItemScanner::npos;  offset = scanner.next() )
+    {
+      if( text[offset] == '"'  &&  quotesBefore++ % QUOTES_PER_RECORD == 0 ) return offset;
+    }
+    return text.size();
+  }
+
+
+
+  // Parses every record in the chunk, then orders them by UPC so the chunks can be merged in a single linear pass.  Brand names are
+  // interned per chunk here, concurrently, so merging only has to intern each chunk's distinct brand names rather than every record's.
+  // A changes file may also hold deletions, which are parsed as grocery items with only a UPC.
+  void parse( Chunk & chunk, bool changes = false )
+  {
+    // A field refers to its buffer only if escapes were removed, and the buffer is reused by the next extraction
+    auto keep = [&chunk]( std::string_view field, const std::string & buffer )
+    { return field.data() == buffer.data()  ?  std::string_view( chunk.unescaped.emplace_back( field ) )  :  field; };
+
+    std::unordered_map<std::string_view, std::uint32_t> brands;
+    GroceryItemFields                                    fields;
+    GroceryItemScanner                                   scanner( chunk.text );
+
+    auto text = chunk.text;
+    while( true )
+    {
+      std::string_view deletedUpcCode;
+      if( changes  &&  extractDeletion( text, deletedUpcCode, fields.upcCodeBuffer ) )
+      {
+        ++chunk.parsed;
+        scanner.seek( static_cast<std::size_t>( text.data() - chunk.text.data() ) );
+
+        if( auto upc = Upc::parse( deletedUpcCode ) ) chunk.groceryItems.push_back( { *upc, {}, {}, 0, true } );
+        else                                          ++chunk.rejected;
+        continue;
+      }
+
+      if( !extractGroceryItem( text, fields, scanner ) ) break;
+      ++chunk.parsed;
+
+      auto upc = Upc::parse( fields.upcCode );
+      if( !upc )
+      {
+        ++chunk.rejected;
+        continue;
+      }
+
+      auto brand = brands.find( fields.brandName );
+      if( brand == brands.end() )
+      {
+        brand = brands.emplace( keep( fields.brandName, fields.brandNameBuffer ), static_cast<std::uint32_t>( chunk.brandNames.size() ) ).first;
+        chunk.brandNames.push_back( brand->first );
+      }
+
+      chunk.groceryItems.push_back( { *upc, fields.price, keep( fields.productName, fields.productNameBuffer ), brand->second } );
+    }
+
+    chunk.complete = text.find_first_not_of( WHITESPACE ) == std::string_view::npos;
+
+    std::stable_sort( chunk.groceryItems.begin(), chunk.groceryItems.end(),
+                      []( const ParsedItem & lhs, const ParsedItem & rhs ) { return lhs.upc < rhs.upc; } );
+  }
+
+
+
+  // Splits text into chunks beginning on record boundaries, one chunk per thread, and parses them concurrently.  The first chunk
+  // that fails to parse completely, if any, is re-parsed from its beginning through the end of the file on this thread and all
+  // chunks after it are discarded.  This reproduces exactly what a single front to back pass produces, which stops at the first
+  // malformed record.
+  std::vector<Chunk> parseChunks( std::string_view text, GroceryItemDatabase::LoadStatistics & statistics )
+  {
+    auto start = Clock::now();
+
+    auto threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+    threadCount      = static_cast<unsigned>( std::clamp<std::size_t>( text.size() / MINIMUM_CHUNK_SIZE, 1, threadCount ) );
+
+    // Tentative boundaries, evenly spaced and aligned to the start of a line
+    std::vector<std::size_t> lines{ 0 };
+    for( unsigned i = 1; i < threadCount; ++i )
+    {
+      auto boundary = alignToLine( text, std::max( lines.back(), text.size() / threadCount * i ) );
+      if( boundary < text.size() ) lines.push_back( boundary );
+    }
+    lines.push_back( text.size() );
+
+    // Count quotes in each line aligned range concurrently, then turn the counts into the number of quotes before each range
+    std::vector<std::size_t> quotesBefore( lines.size(), 0 );
+    {
+      std::vector<std::jthread> workers;
+      for( std::size_t i = 1; i < lines.size(); ++i )
+      {
+        workers.emplace_back( [&, i] { quotesBefore[i] = GroceryItemScanner::countQuotes( text.substr( lines[i-1], lines[i] - lines[i-1] ) ); } );
+      }
+    }
+    for( std::size_t i = 1; i < quotesBefore.size(); ++i ) quotesBefore[i] += quotesBefore[i-1];
+
+    // Slide each boundary forward to the start of the next record
+    std::vector<std::size_t> boundaries{ 0 };
+    for( std::size_t i = 1; i + 1 < lines.size(); ++i )
+    {
+      auto boundary = lines[i] + findRecordStart( text.substr( lines[i] ), quotesBefore[i] );
+      if( boundary > boundaries.back()  &&  boundary < text.size() ) boundaries.push_back( boundary );
+    }
+    boundaries.push_back( text.size() );
+
+    std::vector<Chunk> chunks( boundaries.size() - 1 );
+    for( std::size_t i = 0; i < chunks.size(); ++i ) chunks[i].text = text.substr( boundaries[i], boundaries[i+1] - boundaries[i] );
+
+    auto partitioned   = Clock::now();
+    statistics.threads = static_cast<unsigned>( chunks.size() );
+
+    {
+      std::vector<std::jthread> workers;
+      for( auto & chunk : chunks ) workers.emplace_back( [&chunk] { parse( chunk ); } );
+    }
+
+    if( auto incomplete = std::find_if( chunks.begin(), chunks.end(), []( const Chunk & chunk ) { return !chunk.complete; } );
+        incomplete != chunks.end() )
+    {
+      auto & chunk     = *incomplete;
+      auto   remainder = text.substr( static_cast<std::size_t>( chunk.text.data() - text.data() ) );
+      chunk            = Chunk{};
+      chunk.text       = remainder;
+      parse( chunk );
+      chunks.erase( incomplete + 1, chunks.end() );
+    }
+
+    statistics.partitionTime = partitioned - start;
+    statistics.parseTime     = Clock::now() - partitioned;
+    for( const auto & chunk : chunks )
+    {
+      statistics.records  += chunk.parsed;
+      statistics.rejected += chunk.rejected;
+    }
+
+    return chunks;
+  }
+
+
+
+  // Returns the name of the most complete text database file in the current working directory, or an empty string if there are none
+  std::string findTextDatabase()
   {
     std::string filename;
 
@@ -33,6 +262,65 @@ GroceryItemDatabase & GroceryItemDatabase::instance()
     else if( filename = "Sample_GroceryItem_Database.dat";   std::filesystem::exists( filename ) ) /* intentionally empty*/ ;
     else     filename.clear();
 
+    return filename;
+  }
+
+
+
+  bool isSnapshot( const std::string & filename )
+  { return std::filesystem::path( filename ).extension() == std::filesystem::path( GroceryItemDatabase::SNAPSHOT_FILENAME ).extension(); }
+
+
+
+  bool writeAll( int fileDescriptor, std::string_view bytes ) noexcept
+  {
+    while( !bytes.empty() )
+    {
+      auto written = ::write( fileDescriptor, bytes.data(), bytes.size() );
+      if( written < 0 )
+      {
+        if( errno == EINTR ) continue;
+        return false;
+      }
+      bytes.remove_prefix( static_cast<std::size_t>( written ) );
+    }
+    return true;
+  }
+
+
+
+  // A file created, renamed, or removed isn't durable until the directory holding it is synced too
+  void syncDirectoryOf( const std::string & filename ) noexcept
+  {
+    auto directory = std::filesystem::path( filename ).parent_path();
+    if( directory.empty() ) directory = ".";
+
+    int fileDescriptor = ::open( directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    if( fileDescriptor < 0 ) return;
+
+    ::fsync( fileDescriptor );
+    ::close( fileDescriptor );
+  }
+}    // unnamed, anonymous namespace
+
+
+
+// Return a reference to the one and only instance of the database
+GroceryItemDatabase & GroceryItemDatabase::instance()
+{
+  // Want to probe for persistent database file only the first time called.  By making a (Lambda) function that returns the results
+  // of the probe and then calling that when fist construction the instance ensure all this probing stuff happens only the first
+  // time instance() is called.
+  auto getFileName = []()
+  {
+    std::string filename;
+
+    // Look for a prioritized list of database files in the current working directory to use.  A binary snapshot loads far faster
+    // than any text file, so it's looked for first.  If the snapshot turns out to be stale or damaged, construction falls back to
+    // the text files.
+    if( filename = SNAPSHOT_FILENAME;   std::filesystem::exists( filename ) ) /* intentionally empty*/ ;
+    else filename = findTextDatabase();
+
     return filename;
   };
 
@@ -46,8 +334,69 @@ GroceryItemDatabase & GroceryItemDatabase::instance()
 // Construction
 GroceryItemDatabase::GroceryItemDatabase( const std::string & filename )
 {
-  std::ifstream fin( filename, std::ios::binary );
-  if( !fin.is_open() ) std::cerr << "Warning:  Could not open persistent grocery item database file \"" << filename << "\".  Proceeding with empty database\n\n";
+  std::lock_guard reloading( _reloadMutex );
+  auto            version = std::make_shared<Version>();
+
+  auto loadTextOrWarn = [&version]( const std::string & textFilename )
+  {
+    bool loaded = loadText( textFilename, *version );
+    if( !loaded ) std::cerr << "Warning:  Could not open persistent grocery item database file \"" << textFilename << "\".  Proceeding with empty database\n\n";
+    return loaded;
+  };
+
+  if( !isSnapshot( filename ) )
+  {
+    loadTextOrWarn( filename );
+    replay( *version );
+    publish( std::move( version ) );
+    return;
+  }
+
+  if( loadSnapshot( filename, *version ) )
+  {
+    replay( *version );
+    publish( std::move( version ) );
+    return;
+  }
+
+  // The snapshot can't be trusted, so rebuild from the text file and refresh the snapshot so the next start up is fast again.  The
+  // snapshot is stamped with the text file alone, so it's written before the changes file is replayed, just as a snapshot is loaded.
+  auto textFilename = findTextDatabase();
+  std::cerr << "Warning:  Grocery item database snapshot \"" << filename << "\" is stale or damaged.  Loading \"" << textFilename << "\" instead\n\n";
+
+  if( loadTextOrWarn( textFilename ) ) writeSnapshot( version->catalog, filename, textFilename );
+  replay( *version );
+  publish( std::move( version ) );
+}
+
+
+
+
+bool GroceryItemDatabase::load( const std::string & filename, Version & version )
+{
+  if( !( isSnapshot( filename )  ?  loadSnapshot( filename, version )  :  loadText( filename, version ) ) ) return false;
+
+  replay( version );
+  return true;
+}
+
+
+
+
+// Loads the database from a text file of grocery items
+bool GroceryItemDatabase::loadText( const std::string & filename, Version & version )
+{
+  // The file is mapped into memory and records are parsed straight from the mapped bytes.  This avoids the stream, locale, and
+  // per-field temporary string overhead of extracting each grocery item through an std::ifstream, which dominates start up time
+  // for the larger databases.  The parsing rules are exactly those of GroceryItem's extraction operator.
+  //
+  // Larger files are split into chunks that are parsed concurrently, one per core, and then merged into the index.
+  auto             start = Clock::now();
+  MemoryMappedFile file( filename );
+  if( !file.is_open() ) return false;
+
+  auto & loadStatistics = version.loadStatistics;
+  version.filename      = filename;
 
   // The file contains grocery items separated by whitespace.  A grocery item has 4 pieces of data delimited with a comma.  (This
   // exactly matches the previous assignment as to how GroceryItems are read)
@@ -70,21 +419,77 @@ GroceryItemDatabase::GroceryItemDatabase( const std::string & filename )
   ///////////////////////// TO-DO (2) //////////////////////////////
     /// Hint:  Use your GroceryItem's extraction operator to read GroceryItems, don't reinvent that here.
     ///        Read grocery items until end of file pushing each grocery item into the data store as they're read.
-  GroceryItem holder;
-  while (fin >> holder)
+  loadStatistics.bytes   = file.size();
+  loadStatistics.mapTime = Clock::now() - start;
+
+  auto chunks = parseChunks( file.view(), loadStatistics );
+
+  // Each chunk is sorted by UPC, so a k-way merge visits every grocery item in UPC order and duplicates are adjacent.  Ties are
+  // broken by chunk so the first occurrence of a UPC in the file wins, just like insert().  Grocery items are appended straight into
+  // the catalog's columns; only each chunk's distinct brand names need interning.
+  auto merging = Clock::now();
+
+  GroceryItemCatalog::Builder builder;
   {
-    _data.insert({holder.upcCode(),holder});
+    std::size_t groceryItems = 0, productTextSize = 0;
+    for( const auto & chunk : chunks )
+    {
+      groceryItems += chunk.groceryItems.size();
+      for( const auto & groceryItem : chunk.groceryItems ) productTextSize += groceryItem.productName.size();
+    }
+    builder.reserve( groceryItems, productTextSize );
   }
-  /////////////////////// END-TO-DO (2) ////////////////////////////
 
-  // Note:  The file is intentionally not explicitly closed.  The file is closed when fin goes out of scope - for whatever
-  //        reason.  More precisely, the object named "fin" is destroyed when it goes out of scope and the file is closed in the
-  //        destructor. See RAII
-}
+  std::vector<std::vector<std::uint32_t>> brands( chunks.size() );            // Chunk's brand name positions to the catalog's
+  for( std::size_t i = 0; i < chunks.size(); ++i )
+  {
+    for( auto brandName : chunks[i].brandNames ) brands[i].push_back( builder.internBrand( brandName ) );
+  }
+
+  using Head = std::pair<std::size_t /*chunk*/, std::size_t /*grocery item*/>;
+  auto later = [&chunks]( const Head & lhs, const Head & rhs )
+  {
+    auto lhsUpc = chunks[lhs.first].groceryItems[lhs.second].upc;
+    auto rhsUpc = chunks[rhs.first].groceryItems[rhs.second].upc;
+    return lhsUpc != rhsUpc  ?  lhsUpc > rhsUpc  :  lhs.first > rhs.first;
+  };
 
+  std::priority_queue<Head, std::vector<Head>, decltype( later )> heads( later );
+  for( std::size_t i = 0; i < chunks.size(); ++i ) if( !chunks[i].groceryItems.empty() ) heads.emplace( i, 0 );
 
+  bool first = true;
+  Upc  previous;
+  while( !heads.empty() )
+  {
+    auto [chunk, index] = heads.top();
+    heads.pop();
 
+    auto & groceryItem = chunks[chunk].groceryItems[index];
+    if( first  ||  groceryItem.upc != previous )
+    {
+      builder.append( groceryItem.upc, brands[chunk][groceryItem.brand], groceryItem.productName, groceryItem.price );
+      previous = groceryItem.upc;
+      first    = false;
+    }
 
+    if( ++index < chunks[chunk].groceryItems.size() ) heads.emplace( chunk, index );
+  }
+  chunks.clear();
+
+  auto indexing = Clock::now();
+  loadStatistics.mergeTime = indexing - merging;
+
+  version.catalog = std::move( builder ).build();
+  loadStatistics.indexTime = Clock::now() - indexing;
+
+  if( loadStatistics.rejected != 0 ) std::cerr << "Warning:  " << loadStatistics.rejected << " grocery item(s) in \"" << filename << "\" ignored because their UPC is not 14 digits\n\n";
+  /////////////////////// END-TO-DO (2) ////////////////////////////
+
+  // Note:  The file is intentionally not explicitly unmapped.  The mapping is released when file goes out of scope - for whatever
+  //        reason.  More precisely, the object named "file" is destroyed when it goes out of scope and the mapping is released in
+  //        the destructor. See RAII
+  return true;
+}
 
 
 
@@ -96,12 +501,501 @@ GroceryItemDatabase::GroceryItemDatabase( const std::string & filename )
   /// In the last assignment you implemented GroceryItemDatabase::find() as a recursive linear search (an O(n) operation).  In this
   /// assignment, implement GroceryItemDatabase::find() as a binary search (an O(log n) operation) by delegating to the std::map's binary
   /// search function find().
-GroceryItem * GroceryItemDatabase::find( const std::string & upc ) {
-  auto checker = _data.find(upc);
-  if(checker == _data.end()) return nullptr;
-  return &checker->second;
+GroceryItemView GroceryItemDatabase::find( const Upc & upc )
+{
+  auto version = current();
+  auto record  = version->catalog.find( upc );
+  return record == GroceryItemCatalog::NOT_FOUND  ?  GroceryItemView()  :  GroceryItemView( std::move( version ), record );
+}
+
+
+
+std::pmr::vector<GroceryItemView> GroceryItemDatabase::findMany( std::span<const Upc> upcs, std::pmr::memory_resource * resource )
+{
+  auto version = current();
+
+  std::pmr::vector<GroceryItemCatalog::Record> records( upcs.size(), resource );
+  version->catalog.find( upcs, records );
+
+  std::pmr::vector<GroceryItemView> groceryItems( resource );
+  groceryItems.reserve( records.size() );
+  for( auto record : records ) groceryItems.push_back( record == GroceryItemCatalog::NOT_FOUND  ?  GroceryItemView()  :  GroceryItemView( version, record ) );
+
+  return groceryItems;
+}
+
+
+
+GroceryItemRange GroceryItemDatabase::range( const Upc & first, const Upc & last )
+{
+  auto version = current();
+  auto records = version->catalog.range( first, last );
+  return GroceryItemRange( std::move( version ), records );
 }
-std::size_t GroceryItemDatabase::size() const{
-return _data.size();
+
+
+
+// The UPCs beginning with a prefix are exactly those between the prefix padded with zeros and the prefix padded with nines, Ex:
+// "0004133" spans "00041330000000" through "00041339999999"
+GroceryItemRange GroceryItemDatabase::findPrefix( std::string_view digits )
+{
+  if( digits.size() > Upc::DIGITS  ||  digits.find_first_not_of( "0123456789" ) != std::string_view::npos ) return {};
+
+  std::uint64_t prefix = 0, span = 1;
+  for( char digit : digits ) prefix = prefix * 10 + static_cast<std::uint64_t>( digit - '0' );
+  for( auto i = digits.size(); i < Upc::DIGITS; ++i ) span *= 10;
+
+  return range( *Upc::fromValue( prefix * span ), *Upc::fromValue( prefix * span + span - 1 ) );
 }
+
+
+
+std::size_t GroceryItemDatabase::size() const
+{ return current()->catalog.size(); }
+
+
+
+GroceryItemDatabase::LoadStatistics GroceryItemDatabase::loadStatistics() const
+{ return current()->loadStatistics; }
+
+
+
+std::size_t GroceryItemDatabase::memoryUsage() const
+{ return current()->catalog.memoryUsage(); }
+
+
+
+std::uint64_t GroceryItemDatabase::version() const
+{ return current()->number; }
 /////////////////////// END-TO-DO (3) ////////////////////////////
+
+
+
+
+
+
+
+
+std::ostream & operator<<( std::ostream & stream, const GroceryItemDatabase::LoadStatistics & statistics )
+{
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+
+  stream << "Loaded "    << statistics.records << " records (" << statistics.bytes << " bytes) using " << statistics.threads << " thread(s):  "
+         << "map "       << Milliseconds( statistics.mapTime       ).count() << " ms, "
+         << "partition " << Milliseconds( statistics.partitionTime ).count() << " ms, "
+         << "parse "     << Milliseconds( statistics.parseTime     ).count() << " ms, "
+         << "merge "     << Milliseconds( statistics.mergeTime     ).count() << " ms, "
+         << "index "     << Milliseconds( statistics.indexTime     ).count() << " ms";
+
+  if( statistics.changes != 0 ) stream << ", then " << statistics.changes << " change(s) in " << Milliseconds( statistics.changeTime ).count() << " ms";
+  return stream;
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Hot reload
+*******************************************************************************/
+thread_local GroceryItemDatabase::Reference GroceryItemDatabase::_reference;
+
+
+
+GroceryItemDatabase::Reference::~Reference()
+{
+  if( database == nullptr ) return;
+
+  std::lock_guard lock( database->_referencesMutex );
+  std::erase( database->_references, this );
+}
+
+
+
+std::shared_ptr<GroceryItemDatabase::Version> GroceryItemDatabase::current() const
+{
+  auto & reference = _reference;
+  while( reference.busy.exchange( true, std::memory_order_acquire ) ) std::this_thread::yield();   // only ever held by a publish for a moment
+
+  auto number = _published.load( std::memory_order_acquire );
+  if( reference.database != this  ||  reference.number != number )
+  {
+    if( reference.database != this )
+    {
+      if( reference.database != nullptr )
+      {
+        std::lock_guard lock( reference.database->_referencesMutex );
+        std::erase( reference.database->_references, &reference );
+      }
+      std::lock_guard lock( _referencesMutex );
+      _references.push_back( &reference );
+      reference.database = this;
+    }
+
+    // A newer version is out.  It's copied only if it's still current once this thread is counted in its slot's readers, which the
+    // publish replacing it waits for.  The thread's own reference keeps the copy alive, and is what this thread's views share.
+    for( ;; number = _published.load() )
+    {
+      auto & slot = _slots[number % _slots.size()];
+      slot.readers.fetch_add( 1 );
+
+      std::shared_ptr<Version> copied;
+      if( _published.load() == number ) copied = slot.version;
+      slot.readers.fetch_sub( 1, std::memory_order_release );
+
+      if( copied != nullptr  ||  number == 0 )
+      {
+        auto * latest     = copied.get();
+        reference.number  = number;
+        reference.version = std::shared_ptr<Version>( latest, [keep = std::move( copied )]( Version * ) noexcept {} );
+        break;
+      }
+    }
+  }
+
+  auto shared = reference.version;
+  reference.busy.store( false, std::memory_order_release );
+  return shared;
+}
+
+
+
+void GroceryItemDatabase::publish( std::shared_ptr<Version> version )
+{
+  auto number = _published.load( std::memory_order_relaxed ) + 1;             // only publish() changes _published, and it's serialized
+  version->number = number;
+
+  // No reader copies out of the slot being filled:  the publish before last emptied it after its last reader left, and readers
+  // arriving since find it isn't current.  A reader counts itself in and then checks _published; a publish stores _published and
+  // then checks the count.  Both sides are sequentially consistent, so at least one of them sees the other:  either the reader
+  // finds it's too late and copies nothing, or the publish waits for it.
+  auto & slot     = _slots[ number      % _slots.size()];
+  auto & replaced = _slots[( number - 1 ) % _slots.size()];
+  slot.version = std::move( version );
+  _published.store( number );
+
+  while( replaced.readers.load() != 0 ) std::this_thread::yield();
+  version = std::move( replaced.version );
+
+  // version is now the one replaced.  A retired version referred to only by the retired list can never be referred to again, since
+  // views are only ever made from the current version or copied from other views, so it's freed here rather than by a reader.
+  if( version != nullptr ) _retired.push_back( std::move( version ) );
+
+  // Threads gone idle still hold the version they last read, so their references are dropped for them.  A thread in the middle of
+  // a lookup is left alone, and brings its reference up to date itself next time.
+  {
+    std::lock_guard lock( _referencesMutex );
+    for( auto * reference : _references )
+    {
+      if( reference->busy.exchange( true, std::memory_order_acquire ) ) continue;
+      if( reference->number != number )
+      {
+        reference->number = 0;
+        reference->version.reset();
+      }
+      reference->busy.store( false, std::memory_order_release );
+    }
+  }
+  std::erase_if( _retired, []( const std::shared_ptr<Version> & retired ) noexcept { return retired.use_count() == 1; } );
+}
+
+
+
+bool GroceryItemDatabase::reload( const std::string & filename )
+{
+  std::lock_guard reloading( _reloadMutex );
+
+  auto source  = filename.empty()  ?  current()->filename  :  filename;
+  auto version = std::make_shared<Version>();
+  if( !load( source, *version ) )
+  {
+    std::cerr << "Warning:  Could not reload the grocery item database from \"" << source << "\".  Keeping the current contents\n\n";
+    return false;
+  }
+
+  publish( std::move( version ) );
+  return true;
+}
+
+
+
+bool GroceryItemDatabase::applyChanges( const std::string & filename )
+{
+  std::lock_guard reloading( _reloadMutex );
+
+  auto base    = current();
+  auto version = std::make_shared<Version>();
+  if( !merge( filename, *base, *version ) ) return false;
+
+  publish( std::move( version ) );
+  return true;
+}
+
+
+
+// Compaction folds the files, not the contents in memory:  the text database file is loaded afresh and the changes file as it is
+// right now merged into it, so nothing applied from another file or changed through a view is ever written.  The result is written
+// to a temporary file, forced to disk, and only then renamed over the original, so a crash part way through leaves the original
+// database file and the changes file as they were.  The changes file is removed last, once what it held is safely in the database file.
+bool GroceryItemDatabase::compact()
+{
+  std::lock_guard reloading( _reloadMutex );
+
+  auto source = current()->filename;
+  auto target = isSnapshot( source )  ?  findTextDatabase()  :  source;
+  if( target.empty() )
+  {
+    std::cerr << "Warning:  No persistent grocery item database file to compact the changes into\n\n";
+    return false;
+  }
+  if( !std::filesystem::exists( CHANGES_FILENAME ) ) return true;               // nothing to fold in
+
+  auto base   = std::make_shared<Version>();
+  auto folded = std::make_shared<Version>();
+  if( !loadText( target, *base ) )
+  {
+    std::cerr << "Warning:  Could not open grocery item database file \"" << target << "\".  Changes not compacted\n\n";
+    return false;
+  }
+  if( !merge( CHANGES_FILENAME, *base, *folded ) ) return false;
+  base.reset();
+
+  std::ostringstream text;
+  for( GroceryItemCatalog::Record record = 0; record < folded->catalog.size(); ++record ) text << GroceryItemView( folded, record ) << '\n';
+
+  auto temporary = target + ".tmp";
+  auto failed    = [&]( const std::string & reason )
+  {
+    std::cerr << "Warning:  Could not write grocery item database file \"" << temporary << "\":  " << reason << ".  Changes not compacted\n\n";
+    std::error_code ignored;
+    std::filesystem::remove( temporary, ignored );
+    return false;
+  };
+
+  int file = ::open( temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+  if( file < 0 ) return failed( std::strerror( errno ) );
+
+  bool written = writeAll( file, text.view() )  &&  ::fsync( file ) == 0;
+  ::close( file );
+  if( !written ) return failed( "write failed" );
+
+  std::error_code error;
+  std::filesystem::rename( temporary, target, error );
+  if( error ) return failed( error.message() );
+  syncDirectoryOf( target );
+
+  // The snapshot, if any, is now stale.  Refreshing it from the folded contents, which are exactly the new database file's, keeps the
+  // next start up fast, and the changes file is no longer needed.
+  if( std::filesystem::exists( SNAPSHOT_FILENAME ) ) writeSnapshot( folded->catalog, SNAPSHOT_FILENAME, target );
+  std::filesystem::remove( CHANGES_FILENAME, error );
+  syncDirectoryOf( CHANGES_FILENAME );
+  return true;
+}
+
+
+
+// Changes are parsed exactly as a chunk of the database file is, then merged with the base version's grocery items in a single pass
+// over both, each in UPC order.  The base version's brand names keep their positions, so its grocery items are copied column to
+// column without being looked up or interned again.
+bool GroceryItemDatabase::merge( const std::string & filename, const Version & base, Version & version )
+{
+  auto             start = Clock::now();
+  MemoryMappedFile file( filename );
+  if( !file.is_open() )
+  {
+    std::cerr << "Warning:  Could not open grocery item changes file \"" << filename << "\".  No changes applied\n\n";
+    return false;
+  }
+
+  Chunk changes;
+  changes.text = file.view();
+  parse( changes, true );
+  if( !changes.complete )
+  {
+    std::cerr << "Warning:  Grocery item changes file \"" << filename << "\" is malformed.  No changes applied\n\n";
+    return false;
+  }
+  if( changes.rejected != 0 ) std::cerr << "Warning:  " << changes.rejected << " change(s) in \"" << filename << "\" ignored because their UPC is not 14 digits\n\n";
+
+  auto & catalog = base.catalog;
+
+  GroceryItemCatalog::Builder builder( catalog );
+  std::vector<std::uint32_t>  brands;
+  for( auto brandName : changes.brandNames ) brands.push_back( builder.internBrand( brandName ) );
+
+  const auto &               updates = changes.groceryItems;                    // sorted by UPC, and within a UPC in file order
+  GroceryItemCatalog::Record record  = 0;
+  auto                       end     = static_cast<GroceryItemCatalog::Record>( catalog.size() );
+  for( std::size_t i = 0; i < updates.size(); ++i )
+  {
+    const auto & update = updates[i];
+    if( i + 1 < updates.size()  &&  updates[i + 1].upc == update.upc ) continue;   // a later change to the same UPC wins
+
+    while( record < end  &&  catalog.upc( record ) < update.upc ) builder.append( catalog, record++ );
+    if   ( record < end  &&  catalog.upc( record ) == update.upc ) ++record;       // replaced or deleted
+
+    if( !update.deleted ) builder.append( update.upc, brands[update.brand], update.productName, update.price );
+  }
+  while( record < end ) builder.append( catalog, record++ );
+
+  auto loadStatistics = base.loadStatistics;                                    // copied first, base and version may be the same
+  loadStatistics.changeTime += Clock::now() - start;
+  loadStatistics.changes    += changes.parsed;
+
+  version.filename       = base.filename;                                       // reload() still starts over from the same file
+  version.catalog        = std::move( builder ).build();
+  version.loadStatistics = loadStatistics;
+  return true;
+}
+
+
+
+void GroceryItemDatabase::replay( Version & version )
+{
+  if( std::filesystem::exists( CHANGES_FILENAME ) ) merge( CHANGES_FILENAME, version, version );
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Materialized grocery items
+*******************************************************************************/
+GroceryItem & GroceryItemDatabase::Version::materialize( GroceryItemCatalog::Record record )
+{
+  std::unique_lock lock( materializedMutex );
+
+  auto & groceryItem = materializedItems[record];
+  if( groceryItem == nullptr )
+  {
+    groceryItem = std::make_unique<GroceryItem>( std::string( catalog.productName( record ) ),
+                                                 std::string( catalog.brandName  ( record ) ),
+                                                 catalog.upc( record ).to_string(),
+                                                 catalog.price( record ) );
+    anyMaterialized.store( true, std::memory_order_release );
+  }
+  return *groceryItem;
+}
+
+
+
+const GroceryItem * GroceryItemDatabase::Version::materialized( GroceryItemCatalog::Record record ) const
+{
+  if( !anyMaterialized.load( std::memory_order_acquire ) ) return nullptr;
+
+  std::shared_lock lock( materializedMutex );
+  auto groceryItem = materializedItems.find( record );
+  return groceryItem == materializedItems.end()  ?  nullptr  :  groceryItem->second.get();
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  GroceryItemView
+*******************************************************************************/
+GroceryItemView::GroceryItemView( std::shared_ptr<Version> version, GroceryItemCatalog::Record record ) noexcept
+  : _version( std::move( version ) ), _record( record )
+{}
+
+
+
+GroceryItemView::operator bool() const noexcept
+{ return _version != nullptr; }
+
+
+
+bool GroceryItemView::operator==( std::nullptr_t ) const noexcept
+{ return _version == nullptr; }
+
+
+
+Upc GroceryItemView::upc() const
+{
+  if( auto groceryItem = materialized() )
+  {
+    if( auto upc = Upc::parse( groceryItem->upcCode() ) ) return *upc;
+  }
+  return _version->catalog.upc( _record );
+}
+
+
+
+std::string_view GroceryItemView::brandName() const
+{
+  if( auto groceryItem = materialized() ) return groceryItem->brandName();
+  return _version->catalog.brandName( _record );
+}
+
+
+
+std::string_view GroceryItemView::productName() const
+{
+  if( auto groceryItem = materialized() ) return groceryItem->productName();
+  return _version->catalog.productName( _record );
+}
+
+
+
+Money GroceryItemView::price() const
+{
+  if( auto groceryItem = materialized() ) return groceryItem->price();
+  return _version->catalog.price( _record );
+}
+
+
+
+const GroceryItem * GroceryItemView::materialized() const
+{ return _version->materialized( _record ); }
+
+
+
+GroceryItem & GroceryItemView::operator*() const
+{ return _version->materialize( _record ); }
+
+
+
+GroceryItem * GroceryItemView::operator->() const
+{ return &_version->materialize( _record ); }
+
+
+
+std::ostream & operator<<( std::ostream & stream, const GroceryItemView & groceryItem )
+{
+  if( groceryItem == nullptr ) return stream << "nullptr";
+  if( auto materialized = groceryItem.materialized() ) return stream << *materialized;
+
+  return stream << std::quoted( groceryItem.upc().to_string() ) << ", " << std::quoted( groceryItem.brandName() ) << ", " << std::quoted( groceryItem.productName() ) << ", " << groceryItem.price();
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  GroceryItemRange
+*******************************************************************************/
+GroceryItemView GroceryItemRange::find( const Upc & upc, iterator & hint ) const
+{
+  if( empty() ) return nullptr;
+
+  auto record = _version->catalog.lowerBound( upc, std::clamp( hint._record, _records.begin, _records.end ) );
+  hint = iterator( &_version, std::clamp( record, _records.begin, _records.end ) );
+
+  if( record < _records.begin  ||  record >= _records.end  ||  _version->catalog.upc( record ) != upc ) return nullptr;
+  return *hint;
+}
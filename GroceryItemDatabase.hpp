@@ -1,10 +1,34 @@
 #pragma once
 
-#include <cstddef>                                                              // size_t
+#include <array>
+#include <atomic>
+#include <chrono>                                                               // nanoseconds
+#include <compare>                                                              // strong_ordering
+#include <cstddef>                                                              // size_t, ptrdiff_t, nullptr_t
+#include <iostream>
+#include <iterator>                                                             // random_access_iterator_tag
+#include <concepts>                                                             // convertible_to
+#include <cstdint>                                                              // uint64_t
+#include <memory>                                                               // shared_ptr, unique_ptr
+#include <memory_resource>                                                      // pmr::vector, pmr::memory_resource
+#include <mutex>
+#include <shared_mutex>
+#include <span>
 #include <string>
-#include <map>
+#include <string_view>
+#include <unordered_map>
+#include <utility>                                                              // move()
+#include <vector>
 
 #include "GroceryItem.hpp"
+#include "GroceryItemCatalog.hpp"
+#include "Money.hpp"
+#include "Upc.hpp"
+
+
+
+class GroceryItemView;
+class GroceryItemRange;
 
 
 
@@ -12,21 +36,290 @@
 class GroceryItemDatabase
 {
   public:
+    // Time spent in each phase of loading the persistent database file
+    struct LoadStatistics
+    {
+      std::chrono::nanoseconds mapTime      {};                                 // Opening and memory mapping the file
+      std::chrono::nanoseconds partitionTime{};                                 // Splitting the file into chunks aligned on record boundaries
+      std::chrono::nanoseconds parseTime    {};                                 // Parsing and sorting the chunks, concurrently
+      std::chrono::nanoseconds mergeTime    {};                                 // Merging the parsed chunks into a single collection
+      std::chrono::nanoseconds indexTime    {};                                 // Building the hash index over the merged collection
+      std::size_t              bytes        = 0;                                // Size of the file
+      std::size_t              records      = 0;                                // Number of grocery items parsed, including duplicates
+      std::size_t              rejected     = 0;                                // Number of grocery items ignored because their UPC is malformed
+      unsigned                 threads      = 0;                                // Number of chunks parsed concurrently
+      std::chrono::nanoseconds changeTime   {};                                 // Parsing and merging changes since the file was loaded
+      std::size_t              changes      = 0;                                // Number of changes parsed since the file was loaded
+    };
+
+    // Name of the binary snapshot looked for before any of the text database files
+    inline static constexpr char SNAPSHOT_FILENAME[] = "Grocery_UPC_Database.snapshot";
+
+    // Name of the changes file replayed on top of the database file whenever it's loaded.  A changes file holds, in any mix:
+    //   o  grocery items, exactly as in the database file, each replacing the grocery item with the same UPC or adding a new one
+    //   o  deletions, a minus sign and then a quoted UPC, Ex:  - "00014100072331", each removing the grocery item with that UPC
+    // Changes are applied in order, so the last change to a UPC wins, and replaying changes already applied changes nothing.  Quoting
+    // and escapes follow GroceryItem's extraction operator, so anything that writes grocery items can write changes.  compact() folds
+    // the changes into the database file.
+    inline static constexpr char CHANGES_FILENAME[] = "Grocery_UPC_Database.changes";
+
     // Get a reference to the one and only instance of the database
     static GroceryItemDatabase & instance();
 
     // Locate and return a reference to a particular record
-    GroceryItem * find( const std::string & upc );                              // Returns a pointer to the item in the database if
-                                                                                // found, nullptr otherwise
+    GroceryItemView find( const Upc & upc );                                    // Returns a view of the item in the database if
+                                                                                // found, a view equal to nullptr otherwise
+    template<typename Text>  requires std::convertible_to<const Text &, std::string_view>
+    GroceryItemView find( const Text & upc );                                   // Same, but for a UPC still in text form.  Text that isn't a
+                                                                                // well formed UPC can't be in the database, so returns nullptr
+    std::pmr::vector<GroceryItemView>                                           // Locates a whole batch of UPCs in one pass, overlapping the
+    findMany( std::span<const Upc> upcs, std::pmr::memory_resource * resource   // probes' memory latency.  Results are in the same order as
+                                         = std::pmr::get_default_resource() );  // upcs, and both they and the batch's scratch space are
+                                                                                // allocated from resource
+    GroceryItemRange range     ( const Upc & first, const Upc & last );     // Every grocery item whose UPC lies between first and last
+                                                                                // inclusive, in UPC order, without copying any of them
+    GroceryItemRange findPrefix( std::string_view digits );                     // Every grocery item whose UPC begins with digits, Ex: the
+                                                                                // manufacturer prefix "0004133".  Text that isn't up to 14
+                                                                                // decimal digits can't begin a UPC, so matches nothing
     // Queries
-    std::size_t size() const;                                                   // Returns the number of items in the database
+    std::size_t    size() const;                                                // Returns the number of items in the database
+    LoadStatistics loadStatistics() const;                                      // Returns how long it took to load the database
+    std::size_t    memoryUsage() const;                                         // Returns the bytes of column and index storage
+    std::uint64_t  version() const;                                             // Returns 1 for the contents loaded at start up, then one more
+                                                                                // for each reload or change applied
+    // Hot reload
+    //   A new version of the database is built off to the side while find() keeps answering from the current one, then published in
+    //   a single step.  Lookups are never blocked while a version is built, and views found beforehand keep reading the version
+    //   they came from.  Call these from a background thread to keep the caller responsive; concurrent reloads take turns.
+    bool reload( const std::string & filename = {} );                           // Replaces the contents with a text file or snapshot, by default
+                                                                                // the one the current contents were loaded from, and the changes
+                                                                                // file.  Returns false, changing nothing, if the file can't be loaded
+    bool applyChanges( const std::string & filename );                          // Applies a file of changes (see CHANGES_FILENAME) to the current
+                                                                                // contents.  Returns false, changing nothing, if the file can't be
+                                                                                // read or is malformed
+    bool compact();                                                             // Folds the changes file, as it is on disk, into the text database
+                                                                                // file the contents derive from, refreshes the snapshot if there is
+                                                                                // one, and removes the changes file.  The contents in memory are
+                                                                                // neither written nor changed.  Returns true on success
+    // Persistence
+    bool writeSnapshot( const std::string & snapshotFilename,                   // Writes the database's current contents as a binary snapshot,
+                        const std::string & sourceFilename ) const;             // recording the text file it reflects so staleness can be detected.
+                                                                                // The changes file is replayed on top of a snapshot when it's
+                                                                                // loaded, so write one only while the contents are the text
+                                                                                // file's alone.  Returns true on success
 
   private:
+    friend class GroceryItemView;
+    friend class GroceryItemRange;
+
+    // One immutable generation of the database's contents.  Only the GroceryItems built on demand through views are ever added.
+    struct Version
+    {
+      GroceryItem       & materialize ( GroceryItemCatalog::Record record );      // Returns the full GroceryItem, building it if need be
+      const GroceryItem * materialized( GroceryItemCatalog::Record record ) const;  // Returns the full GroceryItem if already built, nullptr otherwise
+
+      GroceryItemCatalog catalog;                                               // Collection of grocery items in columns, sorted and hash indexed by UPC
+      LoadStatistics     loadStatistics;
+      std::string        filename;                                              // The text file or snapshot the catalog was loaded from
+      std::uint64_t      number = 0;                                            // See version()
+
+      // Full GroceryItems built on demand.  Few are ever built, so they're kept off to the side rather than alongside the columns.
+      mutable std::shared_mutex                                                        materializedMutex;
+      std::unordered_map<GroceryItemCatalog::Record, std::unique_ptr<GroceryItem>>    materializedItems;
+      std::atomic<bool>                                                                anyMaterialized = false;   // Lets readers skip the lock in the common case
+    };
+
     GroceryItemDatabase( const std::string & filename );
 
+    static bool load        ( const std::string & filename, Version & version );  // Loads a text file or snapshot, by its extension, then the changes file
+    static bool loadText    ( const std::string & filename, Version & version );  // Parses a text file of grocery items, returns false if it can't be opened
+    static bool loadSnapshot( const std::string & filename, Version & version );  // Maps a binary snapshot, returns false leaving version
+                                                                                  // empty if the snapshot is stale or damaged
+    static bool merge       ( const std::string & filename,                       // Applies a file of changes to base, giving a version not yet published,
+                              const Version & base, Version & version );          // which may be base itself.  Returns false, leaving version unchanged,
+                                                                                  // if the file can't be read or is malformed
+    static void replay      ( Version & version );                                // Merges the changes file into a freshly loaded version, if there is one
+    static bool writeSnapshot( const GroceryItemCatalog & catalog,                // Writes catalog as a snapshot of sourceFilename.  Snapshots are
+                               const std::string & snapshotFilename,              // loaded before the changes file is replayed, so catalog must be
+                               const std::string & sourceFilename );              // sourceFilename's contents alone
+
     GroceryItemDatabase( const GroceryItemDatabase & )             = delete;    // intentionally prohibit making copies
     GroceryItemDatabase & operator=( const GroceryItemDatabase & ) = delete;    // intentionally prohibit copy assignments
 
+    std::shared_ptr<Version> current() const;                                   // The version lookups are answered from right now.  Never waits for a reload
+    void                     publish( std::shared_ptr<Version> version );       // Makes version current.  Requires _reloadMutex
+
+
+    // Readers never lock.  Each thread keeps its own reference to the version it last read, under a control block of its own, and
+    // answers from it until _published moves on, so a lookup loads one shared counter and writes only to its own thread's reference.
+    // A thread picks up a newer version by copying it out of its slot, counted in the slot's readers while it does.  A publish fills
+    // the other slot, publishes it, and then waits for the replaced version's slot to have no readers before emptying it, so a slot
+    // is never written while someone copies out of it.  Only publishers, serialized by _reloadMutex, ever wait.
+    //
+    // A publish also drops every thread's reference to an older version, unless the thread is using it right then, in which case
+    // the thread drops it itself when it next looks something up.  So once a reload is published, an old version is kept alive only
+    // by views still referring to it and by threads in the middle of a lookup.  Versions replaced are retired rather than released,
+    // and freed by the first publish after the last of those is gone, so a reader dropping the last view of an old version never
+    // pays for freeing it.
+    struct Slot
+    {
+      std::shared_ptr<Version>   version;
+      std::atomic<unsigned>      readers = 0;
+    };
+
+    struct Reference                                                            // A thread's reference to the version it last read
+    {
+      ~Reference();                                                             // Unregisters from database
+
+      const GroceryItemDatabase * database = nullptr;                           // Registered with, once the thread has looked something up
+      std::uint64_t               number   = 0;                                 // Of version, or 0 if none
+      std::shared_ptr<Version>    version;
+      std::atomic<bool>           busy     = false;                             // Held by the thread while it reads, or by a publish dropping version
+    };
+
+    static thread_local Reference _reference;
 
-    std::map<std::string /*UPC*/, GroceryItem> _data;                           // Collection of grocery items indexed by UPC
+    mutable std::array<Slot, 2>            _slots;                              // The current version is in _slots[_published % 2]
+    std::atomic<std::uint64_t>             _published = 0;                      // Number of the current version
+    std::mutex                             _reloadMutex;
+    std::vector<std::shared_ptr<Version>>  _retired;
+    mutable std::mutex                     _referencesMutex;
+    mutable std::vector<Reference *>       _references;                         // Every thread's reference registered with this database
 };
+
+
+
+std::ostream & operator<<( std::ostream & stream, const GroceryItemDatabase::LoadStatistics & statistics );
+
+
+
+// A lightweight handle to a grocery item in the database, returned by GroceryItemDatabase::find().  Reading the grocery item's
+// attributes through the handle goes straight to the database's columns and builds nothing.  Dereferencing the handle ( * or -> )
+// builds a full GroceryItem on first use and keeps it, so every handle to the same grocery item sees the same object and changes
+// made through it persist.  Once built, that GroceryItem is what every handle reports.  A default constructed handle refers to
+// nothing and compares equal to nullptr.
+//
+// A handle refers to the version of the database it was found in, and keeps that version alive, so it stays valid and unchanged
+// if the database is reloaded while the handle is in use.
+class GroceryItemView
+{
+  public:
+    constexpr GroceryItemView( std::nullptr_t = nullptr ) noexcept {}           // Intentionally implicit so a view can be compared to nullptr
+
+    // Queries
+    explicit operator bool() const noexcept;                                    // True if the view refers to a grocery item
+
+    Upc              upc        () const;                                       // Attributes of the grocery item referred to
+    std::string_view brandName  () const;
+    std::string_view productName() const;
+    Money            price      () const;
+
+    // Access to a full GroceryItem, built on first use
+    GroceryItem & operator* () const;
+    GroceryItem * operator->() const;
+
+    // Relational Operators
+    bool operator==( const GroceryItemView & ) const noexcept = default;        // Same grocery item in the same version of the database
+    bool operator==( std::nullptr_t        ) const noexcept;
+
+  private:
+    friend class GroceryItemDatabase;
+    friend class GroceryItemRange;
+    friend class ReceiptWriter;                                                 // Prints exactly what the insertion operator prints
+    friend std::ostream & operator<<( std::ostream & stream, const GroceryItemView & groceryItem );
+
+    using Version = GroceryItemDatabase::Version;
+
+    GroceryItemView( std::shared_ptr<Version> version, GroceryItemCatalog::Record record ) noexcept;
+
+    const GroceryItem * materialized() const;                                   // The full GroceryItem if already built, nullptr otherwise
+
+    std::shared_ptr<Version>   _version;
+    GroceryItemCatalog::Record _record = 0;
+};
+
+// Insertion Operator:  writes exactly what GroceryItem's insertion operator writes, without building a GroceryItem
+std::ostream & operator<<( std::ostream & stream, const GroceryItemView & groceryItem );
+
+
+
+// The grocery items with consecutive UPCs in the database, returned by GroceryItemDatabase::range() and findPrefix().  A range is a
+// pair of positions in the sorted catalog and the version of the database they refer to, which it keeps alive like a
+// GroceryItemView does, so nothing is copied however many grocery items it holds.  Iterating yields a GroceryItemView of each in
+// increasing UPC order.
+class GroceryItemRange
+{
+    using Version = GroceryItemDatabase::Version;
+
+  public:
+    class iterator
+    {
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type       = GroceryItemView;
+        using difference_type  = std::ptrdiff_t;
+
+        iterator() noexcept = default;
+
+        GroceryItemView operator* (                   ) const  { return GroceryItemView( *_version, _record ); }
+        GroceryItemView operator[]( difference_type n ) const  { return *( *this + n ); }
+
+        iterator & operator++(                  ) noexcept  { ++_record;                                  return *this; }
+        iterator & operator--(                  ) noexcept  { --_record;                                  return *this; }
+        iterator   operator++( int              ) noexcept  { auto previous = *this;  ++_record;          return previous; }
+        iterator   operator--( int              ) noexcept  { auto previous = *this;  --_record;          return previous; }
+        iterator & operator+=( difference_type n ) noexcept  { _record = static_cast<Record>( _record + n ); return *this; }
+        iterator & operator-=( difference_type n ) noexcept  { _record = static_cast<Record>( _record - n ); return *this; }
+
+        friend iterator        operator+( iterator i, difference_type n ) noexcept  { return i += n; }
+        friend iterator        operator+( difference_type n, iterator i ) noexcept  { return i += n; }
+        friend iterator        operator-( iterator i, difference_type n ) noexcept  { return i -= n; }
+        friend difference_type operator-( iterator a, iterator b        ) noexcept  { return static_cast<difference_type>( a._record ) - static_cast<difference_type>( b._record ); }
+
+        bool                 operator== ( const iterator & other ) const noexcept  { return _record ==  other._record; }
+        std::strong_ordering operator<=>( const iterator & other ) const noexcept  { return _record <=> other._record; }
+
+      private:
+        friend class GroceryItemRange;
+        using Record = GroceryItemCatalog::Record;
+
+        iterator( const std::shared_ptr<Version> * version, Record record ) noexcept
+          : _version( version ), _record( record )
+        {}
+
+        const std::shared_ptr<Version> * _version = nullptr;                    // The range's, so views share ownership of its version
+        Record                           _record  = 0;
+    };
+
+    GroceryItemRange() noexcept = default;                                      // Holds nothing
+
+    iterator        begin()                        const noexcept  { return { &_version, _records.begin }; }
+    iterator        end  ()                        const noexcept  { return { &_version, _records.end   }; }
+    std::size_t     size ()                        const noexcept  { return _records.end - _records.begin; }
+    bool            empty()                        const noexcept  { return _records.end == _records.begin; }
+    GroceryItemView operator[]( std::size_t i )    const           { return begin()[static_cast<std::ptrdiff_t>( i )]; }
+
+    GroceryItemView find( const Upc & upc, iterator & hint ) const;             // The grocery item in range with this UPC, or nullptr, searching
+                                                                                // onward from hint and leaving hint at upc's place.  Searching
+                                                                                // for UPCs in increasing order walks the range once, as a merge
+
+  private:
+    friend class GroceryItemDatabase;
+
+    GroceryItemRange( std::shared_ptr<Version> version, GroceryItemCatalog::Records records ) noexcept
+      : _version( std::move( version ) ), _records( records )
+    {}
+
+    std::shared_ptr<Version>    _version;
+    GroceryItemCatalog::Records _records;
+};
+
+
+
+// Defined here rather than in the class because it returns a GroceryItemView by value
+template<typename Text>  requires std::convertible_to<const Text &, std::string_view>
+GroceryItemView GroceryItemDatabase::find( const Text & upc )
+{
+  auto key = Upc::parse( upc );
+  return key ? find( *key ) : nullptr;
+}
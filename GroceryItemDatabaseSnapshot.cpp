@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cstdint>                                                      // uint64_t, int64_t
+#include <filesystem>                                                   // file_size(), last_write_time()
+#include <iostream>                                                     // cerr
+#include <string>
+#include <system_error>                                                 // error_code
+
+#include "GroceryItemCatalog.hpp"
+#include "GroceryItemDatabase.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // Retrieves the attributes used to decide if a snapshot still reflects its source text file.  Returns false if the file can't be examined
+  bool describe( const std::string & filename, GroceryItemCatalog::Source & source )
+  {
+    std::error_code error;
+    auto fileSize  = std::filesystem::file_size      ( filename, error );   if( error ) return false;
+    auto writeTime = std::filesystem::last_write_time( filename, error );   if( error ) return false;
+
+    source.filename = filename;
+    source.size     = fileSize;
+    source.modified = writeTime.time_since_epoch().count();
+    return true;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Snapshot persistence
+*******************************************************************************/
+bool GroceryItemDatabase::loadSnapshot( const std::string & filename, Version & version )
+{
+  // The snapshot holds the catalog's columns and hash index exactly as they are laid out in memory, so loading is mapping the file
+  // and verifying its checksum.  Nothing is parsed, allocated, or rehashed per grocery item.
+  using Clock = std::chrono::steady_clock;
+  auto start  = Clock::now();
+
+  GroceryItemCatalog         catalog;
+  GroceryItemCatalog::Source recorded;
+  if( !GroceryItemCatalog::mapSnapshot( filename, catalog, recorded ) ) return false;
+
+  // A snapshot whose source text file has since changed is stale.  If the source is gone the snapshot is all there is, so use it.
+  GroceryItemCatalog::Source current;
+  if( describe( recorded.filename, current )  &&  ( current.size != recorded.size  ||  current.modified != recorded.modified ) ) return false;
+
+  version.catalog                = std::move( catalog );
+  version.filename               = filename;
+  version.loadStatistics         = {};
+  version.loadStatistics.bytes   = std::filesystem::file_size( filename );
+  version.loadStatistics.records = version.catalog.size();
+  version.loadStatistics.threads = 1;
+  version.loadStatistics.mapTime = Clock::now() - start;
+  return true;
+}
+
+
+
+
+bool GroceryItemDatabase::writeSnapshot( const std::string & snapshotFilename, const std::string & sourceFilename ) const
+{ return writeSnapshot( current()->catalog, snapshotFilename, sourceFilename ); }
+
+
+
+
+bool GroceryItemDatabase::writeSnapshot( const GroceryItemCatalog & catalog, const std::string & snapshotFilename, const std::string & sourceFilename )
+{
+  GroceryItemCatalog::Source source;
+  if( !describe( sourceFilename, source ) )
+  {
+    std::cerr << "Warning:  Could not examine grocery item database file \"" << sourceFilename << "\".  Snapshot not written\n\n";
+    return false;
+  }
+
+  return catalog.writeSnapshot( snapshotFilename, source );
+}
@@ -0,0 +1,261 @@
+#include <cstring>                                                      // memchr()
+#include <string>
+#include <string_view>
+#include <system_error>                                                 // errc
+
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+#include "GroceryItemScanner.hpp"
+#include "Money.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // The same characters std::isspace() recognizes in the "C" locale, which is what the extraction operators skip
+  constexpr bool isWhitespace( char c ) noexcept
+  { return c == ' '  ||  c == '\t'  ||  c == '\n'  ||  c == '\v'  ||  c == '\f'  ||  c == '\r'; }
+
+
+
+  void skipWhitespace( const char * & cursor, const char * end ) noexcept
+  { while( cursor != end  &&  isWhitespace( *cursor ) ) ++cursor; }
+
+
+
+  // Takes characters up to the next double quote not escaped with a backslash, removing the escapes.  Cursor is just past the opening
+  // quote on entry, and just past the closing quote on successful return.
+  bool unescape( const char * & cursor, const char * end, std::string_view & field, std::string & buffer )
+  {
+    buffer.clear();
+    while( cursor != end )
+    {
+      char c = *cursor++;
+      if( c == '\\' )
+      {
+        if( cursor == end ) return false;
+        c = *cursor++;
+      }
+      else if( c == '"' )
+      {
+        field = buffer;
+        return true;
+      }
+
+      buffer += c;
+    }
+    return false;
+  }
+
+
+
+  // Mirrors std::quoted() extraction:  leading whitespace is skipped, and if the next character is not a double quote the field is
+  // read as a whitespace delimited word.  Otherwise characters up to the closing double quote are taken, and a backslash takes the
+  // character following it literally.  Running out of input before the closing quote is an error.  Field refers into the source
+  // text when possible, and to buffer only when escapes had to be removed.
+  bool extractQuoted( const char * & cursor, const char * end, std::string_view & field, std::string & buffer )
+  {
+    skipWhitespace( cursor, end );
+    if( cursor == end ) return false;
+
+    if( *cursor != '"' )
+    {
+      auto first = cursor;
+      while( cursor != end  &&  !isWhitespace( *cursor ) ) ++cursor;
+      field = std::string_view( first, static_cast<std::size_t>( cursor - first ) );
+      return true;
+    }
+
+    ++cursor;                                                           // consume the opening quote
+
+    // Fast path:  the vast majority of fields contain no escapes, so the field is exactly the text up to the next double quote
+    auto closingQuote = static_cast<const char *>( std::memchr( cursor, '"', static_cast<std::size_t>( end - cursor ) ) );
+    if( closingQuote == nullptr ) return false;
+
+    if( std::memchr( cursor, '\\', static_cast<std::size_t>( closingQuote - cursor ) ) == nullptr )
+    {
+      field  = std::string_view( cursor, static_cast<std::size_t>( closingQuote - cursor ) );
+      cursor = closingQuote + 1;
+      return true;
+    }
+
+    // Slow path:  unescape character by character
+    return unescape( cursor, end, field, buffer );
+  }
+
+
+
+  // The fast path of extractQuoted() when a scanner has already found the structural characters:  the next two unescaped double
+  // quotes enclose the field, provided only whitespace lies between cursor and the first.  Commas and newlines outside quoted fields
+  // are structural characters too, but belong to the separators and are passed over.  Returns false if the text isn't that simple.
+  bool scanQuoted( GroceryItemScanner & scanner, const char * & cursor, const char * end, std::string_view & field, std::string & buffer )
+  {
+    auto source = scanner.text().data();
+
+    auto open = scanner.next();
+    while( open != GroceryItemScanner::npos  &&  ( source[open] == ','  ||  source[open] == '\n' ) ) open = scanner.next();
+
+    skipWhitespace( cursor, end );
+    if( open == GroceryItemScanner::npos  ||  source + open != cursor  ||  *cursor != '"' ) return false;
+
+    // Inside a quoted field only escaping backslashes and the closing quote are structural
+    auto close   = scanner.next();
+    bool escapes = false;
+    for( ; close != GroceryItemScanner::npos  &&  source[close] == '\\';  close = scanner.next() ) escapes = true;
+    if( close == GroceryItemScanner::npos  ||  source + close >= end ) return false;
+
+    cursor = source + open + 1;
+    if( escapes ) return unescape( cursor, end, field, buffer );
+
+    field  = std::string_view( cursor, close - open - 1 );
+    cursor = source + close + 1;
+    return true;
+  }
+
+
+
+  // Mirrors extracting a single character:  leading whitespace is skipped and whatever character comes next is consumed
+  bool extractDelimiter( const char * & cursor, const char * end ) noexcept
+  {
+    skipWhitespace( cursor, end );
+    if( cursor == end ) return false;
+
+    ++cursor;
+    return true;
+  }
+
+
+
+  // Mirrors extracting Money:  leading whitespace is skipped, an optional '+' or '-', then dollars and cents
+  bool extractPrice( const char * & cursor, const char * end, Money & price ) noexcept
+  {
+    skipWhitespace( cursor, end );
+
+    auto first = cursor;
+    if( first != end  &&  *first == '+' ) ++first;
+    if( first != end  &&  *first == '-'  &&  first != cursor ) return false;
+
+    auto [last, error] = Money::from_chars( first, end, price );
+    if( error != std::errc{} ) return false;
+
+    cursor = last;
+    return true;
+  }
+
+
+
+  // Extracts a grocery item using only the character by character rules above
+  bool extractScalar( std::string_view & text, GroceryItemFields & fields )
+  {
+    auto        cursor = text.data();
+    auto const  end    = text.data() + text.size();
+
+    std::string_view upcCode, brandName, productName;
+    Money            price;
+
+    if(    extractQuoted   ( cursor, end, upcCode,     fields.upcCodeBuffer     )
+        && extractDelimiter( cursor, end                                        )
+        && extractQuoted   ( cursor, end, brandName,   fields.brandNameBuffer   )
+        && extractDelimiter( cursor, end                                        )
+        && extractQuoted   ( cursor, end, productName, fields.productNameBuffer )
+        && extractDelimiter( cursor, end                                        )
+        && extractPrice    ( cursor, end, price                                 ) )
+    {
+      fields.upcCode     = upcCode;
+      fields.brandName   = brandName;
+      fields.productName = productName;
+      fields.price       = price;
+      text.remove_prefix( static_cast<std::size_t>( cursor - text.data() ) );
+      return true;
+    }
+
+    return false;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Extraction
+*******************************************************************************/
+bool extractGroceryItem( std::string_view & text, GroceryItemFields & fields, GroceryItemScanner & scanner )
+{
+  auto        cursor = text.data();
+  auto const  end    = text.data() + text.size();
+
+  std::string_view upcCode, brandName, productName;
+  Money            price;
+
+  if(    scanQuoted      ( scanner, cursor, end, upcCode,     fields.upcCodeBuffer     )
+      && extractDelimiter(          cursor, end                                        )
+      && scanQuoted      ( scanner, cursor, end, brandName,   fields.brandNameBuffer   )
+      && extractDelimiter(          cursor, end                                        )
+      && scanQuoted      ( scanner, cursor, end, productName, fields.productNameBuffer )
+      && extractDelimiter(          cursor, end                                        )
+      && extractPrice    (          cursor, end, price                                 ) )
+  {
+    fields.upcCode     = upcCode;
+    fields.brandName   = brandName;
+    fields.productName = productName;
+    fields.price       = price;
+    text.remove_prefix( static_cast<std::size_t>( cursor - text.data() ) );
+    return true;
+  }
+
+  // Anything unusual, from an unquoted field to a malformed record, is left to the character by character rules, after which the
+  // scanner resumes from wherever they stopped
+  if( !extractScalar( text, fields ) ) return false;
+
+  scanner.seek( static_cast<std::size_t>( text.data() - scanner.text().data() ) );
+  return true;
+}
+
+
+
+
+bool extractGroceryItem( std::string_view & text, GroceryItemFields & fields )
+{
+  GroceryItemScanner scanner( text );
+  return extractGroceryItem( text, fields, scanner );
+}
+
+
+
+
+bool extractGroceryItem( std::string_view & text, GroceryItem & groceryItem )
+{
+  GroceryItemFields fields;
+  if( !extractGroceryItem( text, fields ) ) return false;
+
+  groceryItem = GroceryItem{ std::string( fields.productName ), std::string( fields.brandName ), std::string( fields.upcCode ), fields.price };
+  return true;
+}
+
+
+
+
+
+bool extractDeletion( std::string_view & text, std::string_view & upcCode, std::string & buffer )
+{
+  auto        cursor = text.data();
+  auto const  end    = text.data() + text.size();
+
+  skipWhitespace( cursor, end );
+  if( cursor == end  ||  *cursor != '-' ) return false;
+  ++cursor;
+
+  std::string_view field;
+  if( !extractQuoted( cursor, end, field, buffer ) ) return false;
+
+  upcCode = field;
+  text.remove_prefix( static_cast<std::size_t>( cursor - text.data() ) );
+  return true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "GroceryItem.hpp"
+#include "Money.hpp"
+
+
+
+class GroceryItemScanner;
+
+
+
+// The attributes of a grocery item as they appear in the source text.  Each string attribute refers directly into the source text
+// unless it contained escape sequences, in which case it refers to the unescaped copy held in the matching buffer.  The buffers are
+// reused from one extraction to the next, so repeatedly extracting into the same object doesn't allocate.  Don't copy these; the
+// copy's views would still refer to the original's buffers.
+struct GroceryItemFields
+{
+  std::string_view upcCode;
+  std::string_view brandName;
+  std::string_view productName;
+  Money            price;
+
+  std::string      upcCodeBuffer;
+  std::string      brandNameBuffer;
+  std::string      productNameBuffer;
+};
+
+
+
+// Extracts the grocery item at the front of text, applying exactly the same rules operator>>( std::istream &, GroceryItem & ) applies
+// (quoted strings with backslash escapes, a single delimiter character between fields, optional whitespace, then a price) but
+// working directly on bytes already in memory, for example a memory mapped file.  No stream, locale, or sentry objects are involved,
+// and string attributes are built directly from the source text.
+//
+// Returns true and advances text past the extracted grocery item on success.  Returns false, leaving both text and groceryItem
+// unchanged, if the input is exhausted or the record is malformed.
+//
+// The quoted fields are located with a GroceryItemScanner.  Extracting many grocery items one after another from the same text
+// should share one scanner, constructed over the whole text, so each block of text is scanned only once.  Text must then be the
+// rest of the scanner's text, and every extraction from it must go through the scanner.
+bool extractGroceryItem( std::string_view & text, GroceryItem       & groceryItem );
+bool extractGroceryItem( std::string_view & text, GroceryItemFields & fields      );                                  // Same, but without building any strings
+bool extractGroceryItem( std::string_view & text, GroceryItemFields & fields, GroceryItemScanner & scanner );         // Same, sharing scanner
+
+
+
+
+// Extracts the deletion of a grocery item at the front of text:  optional whitespace, a minus sign, then the UPC read the way
+// std::quoted() reads it, Ex:  - "00014100072331".  Deletions appear only in grocery item database changes files.  upcCode refers
+// directly into text unless it contained escape sequences, in which case it refers to buffer.  Returns true and advances text past
+// the deletion on success.  Returns false, leaving text unchanged, if text doesn't begin with a well formed deletion.
+bool extractDeletion( std::string_view & text, std::string_view & upcCode, std::string & buffer );
@@ -0,0 +1,231 @@
+#include <bit>                                                          // countr_zero(), popcount()
+#include <cstddef>                                                      // size_t
+#include <cstdint>                                                      // uint32_t, uint64_t
+#include <cstring>                                                      // memcpy()
+#include <string_view>
+
+#if defined( __x86_64__ )
+  #include <immintrin.h>                                                // SSE2 and AVX2 intrinsics
+#endif
+
+#include "GroceryItemScanner.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // Portable, and the reference the vector versions must agree with
+  template<typename Masks>
+  Masks classifyScalar( const char * block ) noexcept
+  {
+    Masks masks;
+    for( std::size_t i = 0; i < GroceryItemScanner::BLOCK_SIZE; ++i )
+    {
+      auto bit = std::uint64_t{ 1 } << i;
+      switch( block[i] )
+      {
+        case '"' : masks.quotes      |= bit;  break;
+        case '\\': masks.backslashes |= bit;  break;
+        case ',' : masks.commas      |= bit;  break;
+        case '\n': masks.newlines    |= bit;  break;
+        default  :                            break;
+      }
+    }
+    return masks;
+  }
+
+
+
+  #if defined( __x86_64__ )
+    // SSE2 is part of every x86-64 processor, so needs no run time check.  Four 16 byte compares per character class.
+    std::uint64_t matchesSse2( const __m128i ( & bytes )[4], char c ) noexcept
+    {
+      auto pattern = _mm_set1_epi8( c );
+      std::uint64_t bits = 0;
+      for( unsigned i = 0; i < 4; ++i )
+      {
+        bits |= std::uint64_t{ static_cast<std::uint16_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( bytes[i], pattern ) ) ) } << ( 16 * i );
+      }
+      return bits;
+    }
+
+    template<typename Masks>
+    Masks classifySse2( const char * block ) noexcept
+    {
+      __m128i bytes[4];
+      for( unsigned i = 0; i < 4; ++i ) bytes[i] = _mm_loadu_si128( static_cast<const __m128i *>( static_cast<const void *>( block + 16 * i ) ) );
+
+      return { matchesSse2( bytes, '"' ), matchesSse2( bytes, '\\' ), matchesSse2( bytes, ',' ), matchesSse2( bytes, '\n' ) };
+    }
+
+
+
+    // AVX2 is compiled for this function alone, so the program still runs on processors without it.  Two 32 byte compares per
+    // character class.
+    __attribute__(( target( "avx2" ) ))
+    std::uint64_t matchesAvx2( __m256i low, __m256i high, char c ) noexcept
+    {
+      auto pattern = _mm256_set1_epi8( c );
+      auto lowBits  = static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( low,  pattern ) ) );
+      auto highBits = static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( high, pattern ) ) );
+      return std::uint64_t{ highBits } << 32  |  lowBits;
+    }
+
+    template<typename Masks>
+    __attribute__(( target( "avx2" ) ))
+    Masks classifyAvx2( const char * block ) noexcept
+    {
+      auto low  = _mm256_loadu_si256( static_cast<const __m256i *>( static_cast<const void *>( block      ) ) );
+      auto high = _mm256_loadu_si256( static_cast<const __m256i *>( static_cast<const void *>( block + 32 ) ) );
+
+      return { matchesAvx2( low, high, '"' ), matchesAvx2( low, high, '\\' ), matchesAvx2( low, high, ',' ), matchesAvx2( low, high, '\n' ) };
+    }
+  #endif
+
+
+
+  // Each bit set in the result is set in all higher bits too, toggling at each bit set in bits.  Applied to the unescaped quotes, the
+  // result marks the characters inside quoted fields (including the opening quote, but not the closing one).
+  constexpr std::uint64_t prefixXor( std::uint64_t bits ) noexcept
+  {
+    for( unsigned shift = 1; shift < 64; shift *= 2 ) bits ^= bits << shift;
+    return bits;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Instruction set selection
+*******************************************************************************/
+GroceryItemScanner::InstructionSet GroceryItemScanner::best() noexcept
+{
+  #if defined( __x86_64__ )
+    static const InstructionSet widest = []
+    {
+      __builtin_cpu_init();                                             // may be called before the run time library's own initialization
+      return __builtin_cpu_supports( "avx2" )  ?  InstructionSet::AVX2  :  InstructionSet::SSE2;
+    }();
+    return widest;
+  #else
+    return InstructionSet::SCALAR;
+  #endif
+}
+
+
+
+// An instruction set this build or processor can't execute falls back to the next narrower one
+GroceryItemScanner::Classifier GroceryItemScanner::classifier( InstructionSet instructionSet ) noexcept
+{
+  #if defined( __x86_64__ )
+    if( instructionSet == InstructionSet::AVX2  &&  best() == InstructionSet::AVX2 ) return classifyAvx2<Masks>;
+    if( instructionSet != InstructionSet::SCALAR                                  ) return classifySse2<Masks>;
+  #else
+    static_cast<void>( instructionSet );
+  #endif
+
+  return classifyScalar<Masks>;
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Scanning
+*******************************************************************************/
+GroceryItemScanner::GroceryItemScanner( std::string_view text, InstructionSet instructionSet ) noexcept
+  : _text( text ), _classifier( classifier( instructionSet ) )
+{}
+
+
+
+void GroceryItemScanner::seek( std::size_t offset ) noexcept
+{
+  _nextBlock    = offset;
+  _structurals  = 0;
+  _escapeCarry  = 0;
+  _inFieldCarry = 0;
+}
+
+
+
+// The final, partial block is copied and padded with characters of no interest so the classifier can always read a whole block
+GroceryItemScanner::Masks GroceryItemScanner::classify( Classifier classifier, std::string_view text, std::size_t offset ) noexcept
+{
+  if( text.size() - offset >= BLOCK_SIZE ) return classifier( text.data() + offset );
+
+  char padded[BLOCK_SIZE] = {};
+  std::memcpy( padded, text.data() + offset, text.size() - offset );
+  return classifier( padded );
+}
+
+
+
+// Returns the characters escaped by a backslash.  A backslash escapes the character after it unless it is itself escaped, so in a
+// run of backslashes every other one escapes its successor.  Backslashes are rare, so they're simply visited one at a time.  carry
+// is 1 on entry if the block's first character is escaped by the previous block's last, and on exit if the next block's is.
+std::uint64_t GroceryItemScanner::escaped( std::uint64_t backslashes, std::uint64_t & carry ) noexcept
+{
+  std::uint64_t result = carry;
+  carry = 0;
+
+  for( auto escaping = backslashes & ~result;  escaping != 0; )
+  {
+    auto position = std::countr_zero( escaping );
+    if( position == 63 )
+    {
+      carry = 1;
+      break;
+    }
+
+    auto follower = std::uint64_t{ 1 } << ( position + 1 );
+    result   |= follower;
+    escaping &= ~( ( follower << 1 ) - 1 );                             // the follower, even if a backslash, escapes nothing
+  }
+  return result;
+}
+
+
+
+void GroceryItemScanner::scanNextBlock() noexcept
+{
+  auto masks   = classify( _classifier, _text, _nextBlock );
+  auto escapes = escaped( masks.backslashes, _escapeCarry );
+
+  // Characters past the end of the text, in a padded final block, are all zeros and so are never structural
+  auto quotes  = masks.quotes & ~escapes;
+  auto inField = prefixXor( quotes ) ^ _inFieldCarry;
+  _inFieldCarry = 0 - ( inField >> 63 );
+
+  _structurals = ( quotes  |  masks.backslashes  |  ( ( masks.commas | masks.newlines ) & ~inField ) )  &  ~escapes;
+  _blockOffset = _nextBlock;
+  _nextBlock  += BLOCK_SIZE;
+}
+
+
+
+std::size_t GroceryItemScanner::countQuotes( std::string_view text, InstructionSet instructionSet ) noexcept
+{
+  auto          classifyBlock = classifier( instructionSet );
+  std::uint64_t carry         = 0;
+  std::size_t   count         = 0;
+
+  for( std::size_t offset = 0; offset < text.size(); offset += BLOCK_SIZE )
+  {
+    auto masks = classify( classifyBlock, text, offset );
+    count += static_cast<std::size_t>( std::popcount( masks.quotes & ~escaped( masks.backslashes, carry ) ) );
+  }
+  return count;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <bit>                                                                  // countr_zero()
+#include <cstddef>                                                              // size_t
+#include <cstdint>                                                              // uint64_t
+#include <string_view>
+
+
+
+// Locates the structural characters of the grocery item text format 64 bytes at a time, in the manner of simdjson's first stage.
+// Each block of text is classified into bit masks of its double quotes, backslashes, commas, and newlines using the widest vector
+// instructions the processor supports (chosen at run time with CPUID), or a portable scalar loop.  The masks are then combined with
+// plain integer operations into the structural characters, which next() hands out in order:
+//   o  double quotes not escaped with a backslash, which open and close the quoted fields
+//   o  backslashes that escape the character following them, inside or outside quoted fields
+//   o  commas and newlines, not escaped and outside quoted fields, which separate fields and records
+//
+// Whether a character is escaped or inside a quoted field depends on everything before it, so that state is carried from block to
+// block.  Scanning must start where no backslash escapes the first character, and commas and newlines are classified correctly only
+// if it also starts outside a quoted field, for example at the beginning of a record.
+class GroceryItemScanner
+{
+  public:
+    enum class InstructionSet { SCALAR, SSE2, AVX2 };
+
+    inline static constexpr std::size_t BLOCK_SIZE = 64;
+    inline static constexpr std::size_t npos       = std::string_view::npos;
+
+    // The widest instruction set this processor supports, determined once
+    static InstructionSet best() noexcept;
+
+    explicit GroceryItemScanner( std::string_view text, InstructionSet instructionSet = best() ) noexcept;
+
+    // Offset in text of the next structural character, or npos if there are no more
+    std::size_t next() noexcept
+    {
+      while( _structurals == 0 )
+      {
+        if( _nextBlock >= _text.size() ) return npos;
+        scanNextBlock();
+      }
+
+      auto offset = _blockOffset + static_cast<std::size_t>( std::countr_zero( _structurals ) );
+      _structurals &= _structurals - 1;
+      return offset;
+    }
+
+    // Continues scanning at offset, which must not be inside a quoted field or follow an escaping backslash
+    void seek( std::size_t offset ) noexcept;
+
+    std::string_view text() const noexcept { return _text; }
+
+    // The number of double quotes in text not escaped with a backslash
+    static std::size_t countQuotes( std::string_view text, InstructionSet instructionSet = best() ) noexcept;
+
+  private:
+    struct Masks                                                                // One bit per character of a block, least significant first
+    {
+      std::uint64_t quotes      = 0;
+      std::uint64_t backslashes = 0;
+      std::uint64_t commas      = 0;
+      std::uint64_t newlines    = 0;
+    };
+
+    using Classifier = Masks (*)( const char * block ) noexcept;                // Classifies exactly BLOCK_SIZE characters
+
+    static Classifier    classifier( InstructionSet instructionSet ) noexcept;
+    static Masks         classify  ( Classifier classifier, std::string_view text, std::size_t offset ) noexcept;
+    static std::uint64_t escaped   ( std::uint64_t backslashes, std::uint64_t & carry ) noexcept;
+
+    void scanNextBlock() noexcept;
+
+    std::string_view _text;
+    Classifier       _classifier;
+    std::size_t      _blockOffset   = 0;                                        // Where the block _structurals describes begins
+    std::size_t      _nextBlock     = 0;                                        // Where the next block to scan begins
+    std::uint64_t    _structurals   = 0;                                        // Structural characters of the block not yet handed out
+    std::uint64_t    _escapeCarry   = 0;                                        // 1 if the next block's first character is escaped
+    std::uint64_t    _inFieldCarry  = 0;                                        // All ones if the next block begins inside a quoted field
+};
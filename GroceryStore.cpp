@@ -1,30 +1,64 @@
 ///////////////////////// TO-DO (1) //////////////////////////////
   /// Include necessary header files
   /// Hint:  Include what you use, use what you include
+  #include <algorithm>
+  #include <array>
+  #include <chrono>
+  #include <cstddef>
+  #include <deque>
   #include <fstream>
   #include <string>
   #include <iostream>
+  #include <iterator>
+  #include <memory>
+  #include <memory_resource>
+  #include <optional>
   #include <ostream>
+  #include <span>
   #include <iomanip>
+  #include <thread>
   #include <utility>
+  #include <vector>
 
   #include <GroceryStore.hpp>
   #include <GroceryItemDatabase.hpp>
+  #include <Inventory.hpp>
+  #include <InventoryJournal.hpp>
+  #include <ReceiptWriter.hpp>
+  #include <ReorderScheduler.hpp>
+  #include <ShoppingCart.hpp>
+  #include <InventoryLoader.hpp>
+  #include <Money.hpp>
+  #include <Upc.hpp>
 /////////////////////// END-TO-DO (1) ////////////////////////////
 
 
 
+namespace  // anonymous
+{
+  // The sum of price x quantity over a cart's lines.  A plain loop over two contiguous arrays with no branches or early exit, so the
+  // compiler vectorizes it, multiplying and adding several lines at a time.
+  Money::Cents amountDue( std::span<const Money::Cents> prices, std::span<const ShoppingCart::Quantity> quantities ) noexcept
+  {
+    Money::Cents amount = 0;
+    for( std::size_t line = 0; line < prices.size(); ++line ) amount += prices[line] * static_cast<Money::Cents>( quantities[line] );
+    return amount;
+  }
+}    // namespace
+
+
 
 
 
-GroceryStore::GroceryStore( const std::string & persistentInventoryDB )
+
+GroceryStore::GroceryStore( const std::string & persistentInventoryDB, MergePolicy duplicateRecords, Durability durability )
 {
   std::ifstream fin( persistentInventoryDB );                     // Creates the stream object, and then opens the file if it can
                                                                   // The file is closed as fin goes out of scope
   if( !fin.is_open() ) std::cerr << "Warning:  Could not open persistent inventory database file \"" << persistentInventoryDB << "\".  Proceeding with empty inventory\n\n";
 
-  // The file's inventory contents consists of a quoted UPC string followed by a quantity on hand unsigned integer separated by
-  // whitespace, like this:
+  // The file's inventory contents consists of a UPC string, quoted or not, followed by a quantity on hand unsigned integer separated
+  // by whitespace, one record per line, like this:
   //     "00044100117428"     8
   //     "00041780001566"    46
   //     "00021000043309"    35
@@ -37,9 +71,7 @@ GroceryStore::GroceryStore( const std::string & persistentInventoryDB )
     /// Hint: Since we didn't define an InventoryRecord class that defines the extraction operator (best practices says we should
     ///       have), extract the quoted string and the quantity attributes directly
     ///
-    std::string sholder;
-    unsigned int intholder;
-    while(fin >> std::quoted(sholder) >> std::ws >> intholder) _inventoryDB.insert({sholder,intholder});
+    _inventoryDB = loadInventory( fin, persistentInventoryDB, duplicateRecords ).inventory;   // Reads the file in large blocks and builds the inventory all at once
     
     
     /// Hint: Just as you did in class GroceryItem, use std::quoted to read quoted strings.  Don't try to parse the quotes yourself.
@@ -48,6 +80,14 @@ GroceryStore::GroceryStore( const std::string & persistentInventoryDB )
     ///        2) https://www.youtube.com/watch?v=Mu-GUZuU31A
   
   /////////////////////// END-TO-DO (2) ////////////////////////////
+
+  if( durability == Durability::JOURNALED )
+  {
+    InventoryJournal::replay( _inventoryDB, persistentInventoryDB );
+
+    _journal = std::make_unique<InventoryJournal>( persistentInventoryDB );
+    observeInventory();
+  }
 }                                                                 // File is closed as fin goes out of scope (RAII)
 
 
@@ -65,6 +105,45 @@ GroceryStore::Inventory_DB & GroceryStore::inventory()
 
 
 
+void GroceryStore::checkpointIfDue()
+{
+  if( _journal != nullptr  &&  _journal->checkpointDue() ) _journal->checkpoint( _inventoryDB );
+}
+
+
+
+void GroceryStore::observeInventory()
+{
+  _inventoryDB.observe( [journal = _journal.get(), scheduler = _reorderScheduler.get()]( const Upc & upc, std::optional<Inventory::Quantity> quantity )
+  {
+    if( journal   != nullptr                                                  ) journal  ->append  ( upc, quantity );
+    if( scheduler != nullptr  &&  quantity  &&  *quantity < REORDER_THRESHOLD ) scheduler->lowStock( upc );
+  } );
+}
+
+
+
+
+
+
+
+void GroceryStore::replenishContinuously( std::chrono::milliseconds cadence, ReorderScheduler::Supplier supplier )
+{
+  _reorderScheduler = std::make_unique<ReorderScheduler>( _inventoryDB, REORDER_THRESHOLD, LOT_COUNT, cadence, std::move( supplier ) );
+  observeInventory();
+}
+
+
+
+ReorderScheduler::Statistics GroceryStore::replenishmentStatistics() const
+{ return _reorderScheduler != nullptr  ?  _reorderScheduler->statistics()  :  ReorderScheduler::Statistics{}; }
+
+
+
+
+
+
+
 GroceryStore::GroceryItemsSold GroceryStore::ringUpCustomers( const ShoppingCarts & shoppingCarts, std::ostream & receipt )
 {
   GroceryItemsSold todaysSales;                                   // a collection of unique UPCs of grocery items sold
@@ -73,15 +152,17 @@ GroceryStore::GroceryItemsSold GroceryStore::ringUpCustomers( const ShoppingCart
     ///  Ring up each customer accumulating the groceries purchased
     ///  Hint:  merge each customer's purchased groceries into today's sales.  (https://en.cppreference.com/w/cpp/container/set/merge)
     
+    ReceiptWriter receiptWriter( receipt );                       // Renders receipts into a buffer and writes them to receipt in large blocks
     for(const auto & p : shoppingCarts)
     {
-      receipt << p.first << "'s shopping cart contains:\n";
-      todaysSales.merge(ringUpCustomer(p.second,receipt));
+      receiptWriter.customer( p.first );
+      ringUpCustomer(p.second,receiptWriter,todaysSales);
     }
     
     
   /////////////////////// END-TO-DO (3) ////////////////////////////
 
+  checkpointIfDue();
   return todaysSales;
 } // ringUpCustomers
 
@@ -91,13 +172,71 @@ GroceryStore::GroceryItemsSold GroceryStore::ringUpCustomers( const ShoppingCart
 
 
 
-GroceryStore::GroceryItemsSold GroceryStore::ringUpCustomer( const ShoppingCart & shoppingCart, std::ostream & receipt )
+GroceryStore::GroceryItemsSold GroceryStore::ringUpCustomers( const ShoppingCarts & shoppingCarts, std::ostream & receipt, unsigned checkoutLanes )
+{
+  if( checkoutLanes == 0 ) checkoutLanes = std::max( 1u, std::thread::hardware_concurrency() );
+  checkoutLanes = static_cast<unsigned>( std::min<std::size_t>( checkoutLanes, shoppingCarts.size() ) );
+  if( checkoutLanes <= 1 ) return ringUpCustomers( shoppingCarts, receipt );
+
+  // Each lane takes the next contiguous run of customers and renders their receipts into its own buffer.  Writing the buffers out
+  // lane by lane then reproduces customer order.  _inventoryDB is safe to share among the lanes.
+  struct Lane
+  {
+    ShoppingCarts::const_iterator first, last;
+    ReceiptWriter                 receipts;
+    GroceryItemsSold              sold;
+  };
+
+  std::deque<Lane> lanes;                                         // a deque, since a ReceiptWriter can't be moved
+  auto             cart = shoppingCarts.begin();
+  for( std::size_t i = 0; i < checkoutLanes; ++i )
+  {
+    auto & lane = lanes.emplace_back();
+    lane.first = cart;
+    std::advance( cart, static_cast<std::ptrdiff_t>( shoppingCarts.size() * ( i + 1 ) / checkoutLanes - shoppingCarts.size() * i / checkoutLanes ) );
+    lane.last  = cart;
+  }
+
+  {
+    std::vector<std::jthread> workers;
+    for( auto & lane : lanes ) workers.emplace_back( [this, &lane]
+    {
+      for( auto customer = lane.first;  customer != lane.last;  ++customer )
+      {
+        lane.receipts.customer( customer->first );
+        ringUpCustomer( customer->second, lane.receipts, lane.sold );
+      }
+    } );
+  }                                                               // joining the workers publishes every lane's results
+
+  GroceryItemsSold todaysSales;
+  for( auto & lane : lanes )
+  {
+    receipt.write( lane.receipts.text().data(), static_cast<std::streamsize>( lane.receipts.text().size() ) );
+    todaysSales.merge( lane.sold );
+  }
+
+  checkpointIfDue();
+  return todaysSales;
+} // ringUpCustomers
+
+
+
+
+
+
+
+void GroceryStore::ringUpCustomer( const ShoppingCart & shoppingCart, ReceiptWriter & receipt, GroceryItemsSold & sold )
 {
   auto & worldWideGroceryDatabase = GroceryItemDatabase::instance();        // Get a reference to the world wide database of all
                                                                             // groceries in the world. The database will contains a
                                                                             // full description of the item and the item's price.
 
-  GroceryItemsSold purchasedGroceries;                                      // a collection of UPCs of the groceries purchased by this customer
+  // Everything this transaction needs only while the customer is at the counter is allocated from an arena, on the stack unless the
+  // cart is unusually large, and released all at once when they leave.  The grocery items sold go straight into sold, so the heap
+  // is touched only for grocery items nobody has bought yet today.
+  std::array<std::byte, TRANSACTION_ARENA> buffer;
+  std::pmr::monotonic_buffer_resource      arena( buffer.data(), buffer.size() );
 
 
   ///////////////////////// TO-DO (4) //////////////////////////////
@@ -117,26 +256,48 @@ GroceryStore::GroceryItemsSold GroceryStore::ringUpCustomer( const ShoppingCart
     ///       2.2.3.1              Decrease the number of items on hand for the item sold  x
     ///       2.2.3.2              Add the items's UPC to the list of groceries purchased x
     ///       3         Print the total amount due on the receipt
-  double amount{0}; // step 1
+  const ShoppingCart *        cart = &shoppingCart;
+  std::optional<ShoppingCart> closedCart;                                   // on the arena, if the cart has to be closed first
+  if( !shoppingCart.closed() )                                              // ring up in UPC order, each grocery item once
+  {
+    cart = &closedCart.emplace( shoppingCart, &arena );
+    closedCart->close();
+  }
 
-  for(const auto & p : shoppingCart){ // step 2
-  receipt << "  ";
-   auto checker = worldWideGroceryDatabase.find(p.first);
+  // Resolve the whole cart in one batched database pass rather than one dependent lookup per line.  The cart's UPCs are already
+  // a contiguous array, so they're handed over as they are.  Each line's unit price is gathered next to the cart's quantities,
+  // zero for an item not found since it's free, and the amount due is their dot product.
+  auto upcs       = cart->upcs();
+  auto quantities = cart->quantities();
+  auto found      = worldWideGroceryDatabase.findMany( upcs, &arena );
+
+  std::pmr::vector<Money::Cents> prices( upcs.size(), 0, &arena );
+  Inventory::Hint inventoryHint;                                            // the cart is in UPC order, so the inventory is walked once,
+  auto            soldHint = sold.begin();                                  // and so is sold
+
+  for( std::size_t line = 0; line < upcs.size(); ++line ){ // step 2
+   auto checker = found[line];
    if(checker != nullptr){
     //add it
-    receipt << *checker << '\n';
-    amount += checker->price();
-    --_inventoryDB.find(checker->upcCode())->second;
-    purchasedGroceries.insert(checker->upcCode());
+    receipt.item( checker, quantities[line] );
+    prices[line] = checker.price().cents();
+    // Sold even if the shelf count says fewer are left, the units are in the customer's cart after all
+    if( _inventoryDB.decrementIfAvailable( upcs[line], quantities[line], inventoryHint ) != Inventory::Sale::NOT_CARRIED )
+    {
+      soldHint = std::next( sold.insert( soldHint, upcs[line] ) );
+    }
    }else{
-    receipt << std::quoted(p.first) << " (" << p.second.productName() << ") not found, the item is free!\n"; 
+    receipt.notFound( upcs[line], cart->label( upcs[line] ) );
    }
   }
-  receipt << "-------------------------\nTotal $" << amount << "\n\n";
+  Money amount = Money::fromCents( amountDue( prices, quantities ) );      // step 1 and 2.2.2, all at once
+  receipt.total( amount );
+  if( _journal != nullptr  &&  !_journal->commit() )                        // the customer's purchases are durable before they leave.  Lanes
+  {                                                                         // committing at the same time share a single write to disk
+    std::cerr << "Warning:  A customer's purchases could not be logged, and may not survive a restart\n\n";
+  }
   
   /////////////////////// END-TO-DO (4) ////////////////////////////
-
-  return purchasedGroceries;
 } // ringUpCustomer
 
 
@@ -170,26 +331,45 @@ void GroceryStore::reorderItems( GroceryItemsSold & todaysSales, std::ostream &
     ///        2       Reset the list of grocery item sold today so the list can be reused again later x
     ///
     /// Take special care to avoid excessive searches in your solution
-    reorderReport << "Re-Ordering grocery items the store is running low on\n\n";
-    unsigned tracker{1};
-    for (const auto& p : todaysSales){
-      auto checker = worldWideGroceryDatabase.find(p);
-      auto checker2 = _inventoryDB.find(p);
-
-      if(checker2 == _inventoryDB.end()) {
-        reorderReport << tracker++ << ": {" << *checker << "}\n *** no longer sold in this store and will not be re-ordered\n\n"; 
-        }
+    ///
+    /// The grocery items sold, the store's inventory, and the database are all ordered by UPC, so rather than searching the inventory
+    /// and the database for each grocery item sold, they are walked together in one pass, a merge join:  each search picks up where
+    /// the last left off and gallops forward only as far as the next UPC sold.  The database is searched only for the grocery items
+    /// actually reported.  The report is rendered into a buffer and written in large blocks.
+    if( _reorderScheduler != nullptr ) _reorderScheduler->flush();
+
+    ReceiptWriter report( reorderReport );
+    report.reorderHeading();
 
-      if(checker2->second < REORDER_THRESHOLD ){
-        reorderReport << tracker++ << ": {" << *checker << "}\n only " << checker2->second
-        << " remain in stock which is " << REORDER_THRESHOLD - checker2->second  << " unit(s) below reorder threshold (" << REORDER_THRESHOLD << "), re-ordering " 
-        << LOT_COUNT << " more\n\n";
-        checker2->second += LOT_COUNT;
+    if( !todaysSales.empty() )
+    {
+      auto            catalog     = worldWideGroceryDatabase.range( *todaysSales.begin(), *todaysSales.rbegin() );
+      auto            catalogHint = catalog.begin();
+      Inventory::Hint inventoryHint;
+      unsigned        number      = 1;
+
+      for( const auto & upc : todaysSales )
+      {
+        auto onHand = _inventoryDB.quantity( upc, inventoryHint );
+        if( onHand  &&  *onHand >= REORDER_THRESHOLD ) continue;
+
+        auto groceryItem = catalog.find( upc, catalogHint );                  // nullptr if the grocery item is no longer in the database
+        if( !onHand )
+        {
+          report.discontinued( number++, upc, groceryItem );
+          continue;
         }
+
+        report.reordered( number++, upc, groceryItem, *onHand, REORDER_THRESHOLD, LOT_COUNT );
+        _inventoryDB.restock( upc, LOT_COUNT, inventoryHint );
       }
+    }
 
     todaysSales.clear();
   /////////////////////// END-TO-DO (5) ////////////////////////////
+
+  if( _journal != nullptr  &&  !_journal->commit() ) std::cerr << "Warning:  Today's restocking could not be logged, and may not survive a restart\n\n";
+  checkpointIfDue();
 }
 
 
@@ -200,8 +380,8 @@ void GroceryStore::reorderItems( GroceryItemsSold & todaysSales, std::ostream &
 
 GroceryStore::ShoppingCarts GroceryStore::makeShoppingCarts()
   {
-    // Our store has many customers, and each (identified by name) is pushing a shopping cart. Shopping carts are structured as
-    // trees of trees of grocery items.
+    // Our store has many customers, and each (identified by name) is pushing a shopping cart. Each grocery item in a cart is
+    // labeled with the customer's own name for it.
     ShoppingCarts carts =
     {
       // first shopping cart
@@ -1,11 +1,24 @@
 #pragma once
 
+#include <chrono>                                                               // milliseconds
+#include <cstddef>                                                              // size_t
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <set>
 #include <string>
 #include <iostream>
 
-#include "GroceryItem.hpp"
+#include "Inventory.hpp"
+#include "InventoryJournal.hpp"
+#include "InventoryLoader.hpp"
+#include "ReorderScheduler.hpp"
+#include "ShoppingCart.hpp"
+#include "Upc.hpp"
+
+
+
+class ReceiptWriter;
 
 
 
@@ -15,16 +28,24 @@ class GroceryStore
     // Type Definition Aliases
     //    |Alias Name    |            |  Key             |  | Value                  |
     //    +--------------+            +------------------+  +------------------------+
-    using GroceryItemsSold = std::set<std::string /*UPC */   /* N/A */                >;  // A collection of unique UPCs representing grocery items that have been sold
-
-    using Inventory_DB     = std::map<std::string /*UPC */,  unsigned int /*quantity*/>;  // A collection of quantities indexed by UPC:                  Maintains of the quantity of grocery items in stock identified by UPC
-    using ShoppingCart     = std::map<std::string /*UPC */,  GroceryItem              >;  // A collection of groceries indexed by UPC:                   An individual shopping cart filled with groceries
-    using ShoppingCarts    = std::map<std::string /*name*/,  ShoppingCart             >;  // A collection of shopping carts indexed by customer's name:  A collection of shoppers, identified by name, each pushing a shopping
-                                                                                          //                                                             cart.  Notice that this structure is a tree, and each element in the
-                                                                                          //                                                             tree is also a tree. That is, this is a tree of trees.
+    using GroceryItemsSold = std::pmr::set<Upc               /* N/A */                >;  // A collection of unique UPCs representing grocery items that have been sold
+
+    using Inventory_DB     = Inventory /*UPC -> quantity*/                             ;  // A collection of quantities indexed by UPC:                  Maintains of the quantity of grocery items in stock identified by UPC,
+                                                                                          //                                                             safe to share among concurrent checkout lanes
+    using ShoppingCart     = ::ShoppingCart /*UPC -> quantity*/                        ;  // A collection of groceries ordered by UPC:                   An individual shopping cart filled with groceries, a flat
+                                                                                          //                                                             array of UPCs and quantities that allocates nothing until
+                                                                                          //                                                             it holds more than a handful of lines
+    using ShoppingCarts    = std::pmr::map<std::pmr::string /*name*/, ShoppingCart    >;  // A collection of shopping carts indexed by customer's name:  A collection of shoppers, identified by name, each pushing a shopping
+                                                                                          //                                                             cart.  Notice that this structure is a tree, but each
+                                                                                          //                                                             element in the tree is a flat array, not another tree.
+                                                                                          //                                                             The carts use the collection's memory resource
 
     // Constructors, assignments, destructor
-    GroceryStore( const std::string & persistentInventoryDB = "GroceryStoreInventory.dat" );
+    GroceryStore( const std::string & persistentInventoryDB = "GroceryStoreInventory.dat",
+                  MergePolicy         duplicateRecords      = MergePolicy::FIRST_WINS,     // How inventory records sharing a UPC are combined
+                  Durability          durability            = Durability::NONE );         // Whether inventory changes are written back.  If
+                                                                                          // journaled, changes logged since the inventory file
+                                                                                          // was last checkpointed are replayed on top of it
 
     // Returns a reference to the store's one and only inventory database
     Inventory_DB & inventory();
@@ -34,10 +55,22 @@ class GroceryStore
     // Returns a collection of unique UPCs for grocery items that have been sold
     GroceryItemsSold ringUpCustomers( const ShoppingCarts & shoppingCarts, std::ostream & receipt = std::cout );
 
+    // Same, but customers are rung up on several checkout lanes at once.  Receipts still come out in customer order, and the grocery
+    // items sold and the inventory afterwards are exactly what ringing them up one at a time produces.  Zero lanes means one lane
+    // per hardware thread.
+    GroceryItemsSold ringUpCustomers( const ShoppingCarts & shoppingCarts, std::ostream & receipt, unsigned checkoutLanes );
+
 
-    // Re-orders grocery items sold that have fallen below the re-order threshold, then clears the reorder list
+    // Re-orders grocery items sold that have fallen below the re-order threshold, then clears the reorder list.  If the store
+    // replenishes continuously, whatever is still waiting to be re-ordered in the background is re-ordered first.
     void reorderItems( GroceryItemsSold & todaysSales, std::ostream & reorderReport = std::cout );
 
+    // Re-orders grocery items in the background as checkout lanes sell them below the re-order threshold, batched into purchase
+    // orders per manufacturer every cadence, rather than only at the end of the day.  Start it before ringing up customers, and
+    // don't move the store afterwards:  the scheduler works on this store's inventory.
+    void replenishContinuously( std::chrono::milliseconds cadence = ReorderScheduler::DEFAULT_CADENCE, ReorderScheduler::Supplier supplier = {} );
+    ReorderScheduler::Statistics replenishmentStatistics() const;               // All zero unless replenishing continuously
+
 
     // Initializes a bunch of customers pushing shopping carts filled with groceries
     ShoppingCarts  makeShoppingCarts();
@@ -45,14 +78,22 @@ class GroceryStore
 
   private:
     // Instance attributes
-    Inventory_DB _inventoryDB;                                                            // This store's inventory of grocery items indexed by UPC.
+    std::unique_ptr<InventoryJournal> _journal;                                           // Logs every inventory change, if the store is durable.  Declared
+                                                                                          // first so it outlives the inventory observing changes into it
+    Inventory_DB                      _inventoryDB;                                       // This store's inventory of grocery items indexed by UPC.
+    std::unique_ptr<ReorderScheduler> _reorderScheduler;                                  // Restocks the inventory in the background, if replenishing
+                                                                                          // continuously.  Declared after the inventory it restocks
 
 
     // Class attributes
     inline static constexpr unsigned int REORDER_THRESHOLD = 15;                          // When the quantity on hand dips below this threshold, it's time to order more inventory
     inline static constexpr unsigned int LOT_COUNT         = 20;                          // Number of items that can be ordered at one time
+    inline static constexpr std::size_t  TRANSACTION_ARENA = 32 * 1024;                   // Bytes on the stack a customer's checkout works in before
+                                                                                          // falling back to the heap
 
 
     // Helper functions
-    GroceryItemsSold ringUpCustomer( const ShoppingCart & shoppingCart, std::ostream & receipt );
+    void             ringUpCustomer( const ShoppingCart & shoppingCart, ReceiptWriter & receipt, GroceryItemsSold & sold );  // Adds the grocery items sold to sold
+    void             checkpointIfDue();                                                   // Rewrites the inventory file once enough changes are logged
+    void             observeInventory();                                                  // Sends inventory changes to the journal and the scheduler
 };
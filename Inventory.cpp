@@ -0,0 +1,302 @@
+#include <algorithm>                                                    // is_sorted(), lower_bound(), min(), stable_sort(), unique()
+#include <cstddef>                                                      // size_t, ptrdiff_t
+#include <limits>                                                       // numeric_limits
+#include <memory>                                                       // make_unique()
+#include <mutex>                                                        // lock_guard, unique_lock
+#include <optional>
+#include <stdexcept>                                                    // out_of_range
+#include <utility>                                                      // exchange(), move()
+#include <vector>
+
+#include "Inventory.hpp"
+#include "Upc.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors, assignments, and destructor
+*******************************************************************************/
+Inventory::Inventory()
+  : _shards( std::make_unique<Shard[]>( SHARDS ) )
+{}
+
+
+
+
+Inventory::Inventory( std::vector<Item> items )
+  : Inventory()
+{
+  // Sorting stably keeps duplicates in their original order, so unique() keeps the first of each.  Input that's already sorted, a
+  // common case for files written from a snapshot, skips the sort entirely.
+  auto byUpc = []( const Item & lhs, const Item & rhs ) { return lhs.first < rhs.first; };
+  if( !std::is_sorted( items.begin(), items.end(), byUpc ) ) std::stable_sort( items.begin(), items.end(), byUpc );
+  items.erase( std::unique( items.begin(), items.end(), []( const Item & lhs, const Item & rhs ) { return lhs.first == rhs.first; } ), items.end() );
+
+  _upcs.reserve( items.size() );
+  for( std::size_t shard = 0; shard < SHARDS; ++shard ) _shards[shard].slots.reserve( items.size() / SHARDS + 1 );
+
+  for( std::size_t i = 0; i < items.size(); ++i )
+  {
+    _upcs.push_back( items[i].first );
+    _shards[i % SHARDS].slots.push_back( { items[i].second, true } );
+  }
+
+  _size.store( items.size(), std::memory_order_relaxed );
+}
+
+
+
+
+Inventory::Inventory( Inventory && other ) noexcept
+  : _upcs  ( std::move( other._upcs ) ),
+    _shards( std::exchange( other._shards, std::make_unique<Shard[]>( SHARDS ) ) ),
+    _size  ( other._size.exchange( 0, std::memory_order_relaxed ) ),
+    _observer( std::exchange( other._observer, nullptr ) )
+{
+  other._upcs.clear();
+}
+
+
+
+
+Inventory & Inventory::operator=( Inventory && rhs ) noexcept
+{
+  if( this != &rhs )
+  {
+    _upcs   = std::exchange( rhs._upcs, {} );
+    _shards = std::exchange( rhs._shards, std::make_unique<Shard[]>( SHARDS ) );
+    _size.store( rhs._size.exchange( 0, std::memory_order_relaxed ), std::memory_order_relaxed );
+    _observer = std::exchange( rhs._observer, nullptr );
+  }
+  return *this;
+}
+
+
+
+
+Inventory::~Inventory() noexcept = default;
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Private helpers
+*******************************************************************************/
+std::optional<std::size_t> Inventory::position( const Upc & upc ) const
+{
+  auto found = std::lower_bound( _upcs.begin(), _upcs.end(), upc );
+  if( found == _upcs.end()  ||  *found != upc ) return std::nullopt;
+  return static_cast<std::size_t>( found - _upcs.begin() );
+}
+
+
+
+// Steps of 1, 2, 4, ... from the hint find a stretch of _upcs that ends at or after upc, then a binary search within it finds upc.
+// A search costs the logarithm of the distance moved, so consecutive searches for increasing UPCs cost little more than walking
+// both sequences side by side.  A UPC before the hint starts over from the beginning.
+std::optional<std::size_t> Inventory::position( const Upc & upc, Hint & hint ) const
+{
+  auto first = hint.position <= _upcs.size()  &&  ( hint.position == 0  ||  _upcs[hint.position - 1] < upc )  ?  hint.position  :  0;
+
+  std::size_t step = 1;
+  while( first + step <= _upcs.size()  &&  _upcs[first + step - 1] < upc )
+  {
+    first += step;
+    step  *= 2;
+  }
+
+  auto last  = _upcs.begin() + static_cast<std::ptrdiff_t>( std::min( first + step, _upcs.size() ) );
+  auto found = std::lower_bound( _upcs.begin() + static_cast<std::ptrdiff_t>( first ), last, upc );
+
+  hint.position = static_cast<std::size_t>( found - _upcs.begin() );
+  if( found == _upcs.end()  ||  *found != upc ) return std::nullopt;
+  return hint.position;
+}
+
+
+
+std::optional<Inventory::Quantity> Inventory::quantityAt( std::optional<std::size_t> at ) const
+{
+  if( !at ) return std::nullopt;
+
+  std::lock_guard lock( shardOf( *at ).mutex );
+  auto & slot = slotOf( *at );
+  return slot.carried  ?  std::optional<Quantity>( slot.quantity )  :  std::nullopt;
+}
+
+
+
+// Whatever is on hand is taken under the shard's lock, so lanes selling the last few units of an item at once never take more than
+// there are between them
+Inventory::Sale Inventory::decrementAt( std::optional<std::size_t> at, const Upc & upc, Quantity count )
+{
+  if( !at ) return Sale::NOT_CARRIED;
+
+  std::lock_guard lock( shardOf( *at ).mutex );
+  auto & slot = slotOf( *at );
+  if( !slot.carried      ) return Sale::NOT_CARRIED;
+  if( count         == 0 ) return Sale::SOLD;
+  if( slot.quantity == 0 ) return Sale::OUT_OF_STOCK;
+
+  auto taken = std::min( count, slot.quantity );
+  slot.quantity -= taken;
+  if( _observer ) _observer( upc, slot.quantity );
+  return taken == count  ?  Sale::SOLD  :  Sale::OUT_OF_STOCK;
+}
+
+
+
+bool Inventory::restockAt( std::optional<std::size_t> at, const Upc & upc, Quantity count )
+{
+  if( !at ) return false;
+
+  std::lock_guard lock( shardOf( *at ).mutex );
+  auto & slot = slotOf( *at );
+  if( !slot.carried ) return false;
+
+  slot.quantity = count > std::numeric_limits<Quantity>::max() - slot.quantity  ?  std::numeric_limits<Quantity>::max()  :  slot.quantity + count;
+  if( _observer ) _observer( upc, slot.quantity );
+  return true;
+}
+
+
+
+Inventory::Shard & Inventory::shardOf( std::size_t position ) const noexcept
+{ return _shards[position % SHARDS]; }
+
+
+
+Inventory::Slot & Inventory::slotOf( std::size_t position ) const noexcept
+{ return shardOf( position ).slots[position / SHARDS]; }
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Queries
+*******************************************************************************/
+std::size_t Inventory::size() const noexcept
+{ return _size.load( std::memory_order_relaxed ); }
+
+
+
+bool Inventory::empty() const noexcept
+{ return size() == 0; }
+
+
+
+bool Inventory::contains( const Upc & upc ) const
+{ return quantity( upc ).has_value(); }
+
+
+
+std::optional<Inventory::Quantity> Inventory::quantity( const Upc & upc ) const
+{ return quantityAt( position( upc ) ); }
+
+
+
+std::optional<Inventory::Quantity> Inventory::quantity( const Upc & upc, Hint & hint ) const
+{ return quantityAt( position( upc, hint ) ); }
+
+
+
+Inventory::Quantity Inventory::at( const Upc & upc ) const
+{
+  if( auto onHand = quantity( upc ) ) return *onHand;
+  throw std::out_of_range( "Inventory::at():  UPC \"" + upc.to_string() + "\" is not carried" );
+}
+
+
+
+std::vector<Inventory::Item> Inventory::snapshot() const
+{
+  // Holding every shard's lock at once freezes the whole inventory at a single instant.  Locks are always taken in shard order, and
+  // every other operation holds at most one, so this can't deadlock.
+  std::vector<std::unique_lock<std::mutex>> locks;
+  locks.reserve( SHARDS );
+  for( std::size_t shard = 0; shard < SHARDS; ++shard ) locks.emplace_back( _shards[shard].mutex );
+
+  std::vector<Item> items;
+  items.reserve( size() );
+  for( std::size_t i = 0; i < _upcs.size(); ++i )
+  {
+    if( auto & slot = slotOf( i );  slot.carried ) items.emplace_back( _upcs[i], slot.quantity );
+  }
+  return items;
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Modifiers
+*******************************************************************************/
+Inventory::Sale Inventory::decrementIfAvailable( const Upc & upc )
+{ return decrementIfAvailable( upc, 1 ); }
+
+
+
+Inventory::Sale Inventory::decrementIfAvailable( const Upc & upc, Quantity count )
+{ return decrementAt( position( upc ), upc, count ); }
+
+
+
+Inventory::Sale Inventory::decrementIfAvailable( const Upc & upc, Quantity count, Hint & hint )
+{ return decrementAt( position( upc, hint ), upc, count ); }
+
+
+
+bool Inventory::restock( const Upc & upc, Quantity count )
+{ return restockAt( position( upc ), upc, count ); }
+
+
+
+bool Inventory::restock( const Upc & upc, Quantity count, Hint & hint )
+{ return restockAt( position( upc, hint ), upc, count ); }
+
+
+
+std::size_t Inventory::erase( const Upc & upc )
+{
+  auto at = position( upc );
+  if( !at ) return 0;
+
+  std::lock_guard lock( shardOf( *at ).mutex );
+  auto & slot = slotOf( *at );
+  if( !slot.carried ) return 0;
+
+  slot.carried = false;
+  _size.fetch_sub( 1, std::memory_order_relaxed );
+  if( _observer ) _observer( upc, std::nullopt );
+  return 1;
+}
+
+
+
+void Inventory::observe( Observer observer )
+{ _observer = std::move( observer ); }
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Relational Operators
+*******************************************************************************/
+bool Inventory::operator==( const Inventory & rhs ) const
+{ return this == &rhs  ||  snapshot() == rhs.snapshot(); }
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>                                                              // size_t
+#include <functional>
+#include <memory>                                                               // unique_ptr
+#include <mutex>
+#include <optional>
+#include <utility>                                                              // pair
+#include <vector>
+
+#include "Upc.hpp"
+
+
+
+// A store's inventory:  the quantity on hand of each grocery item the store carries, safe to use from any number of checkout lanes
+// at once.
+//
+// The set of UPCs is fixed when the inventory is built.  Quantities are split across shards, each guarded by its own lock, so lanes
+// working on different grocery items rarely contend.  Erasing a UPC leaves it in place as a tombstone, so the key set, and with it
+// every lookup, never changes shape while lanes are running.  A snapshot locks every shard at once, so it reflects a single point in
+// time even while sales and restocks continue.  An observer, if there is one, hears of every change as it's made, which is how a
+// journal keeps a durable record of them.
+class Inventory
+{
+  public:
+    using Quantity = unsigned int;
+    using Item     = std::pair<Upc, Quantity>;
+
+    enum class Sale { SOLD, OUT_OF_STOCK, NOT_CARRIED };                        // Outcome of a sale
+
+    // Where the last hinted search of the inventory's sorted UPCs left off.  Searching for UPCs in increasing order with the same
+    // hint walks the inventory once, as a merge, rather than searching all of it for each UPC.
+    struct Hint
+    {
+      std::size_t position = 0;
+    };
+
+    // Called after every change with the changed item's shard still locked, so the changes to any one grocery item are observed in
+    // the order they were made.  quantity is the item's quantity afterwards, or nothing once the item is erased.
+    using Observer = std::function<void( const Upc & upc, std::optional<Quantity> quantity )>;
+
+    // Constructors, assignments, and destructor
+    Inventory();
+    explicit Inventory( std::vector<Item> items );                              // If a UPC appears more than once, the first occurrence wins
+
+    Inventory( Inventory && ) noexcept;
+    Inventory & operator=( Inventory && ) noexcept;
+
+   ~Inventory() noexcept;
+
+
+    // Queries, safe to call concurrently with anything
+    std::size_t             size    (                 ) const noexcept;         // Number of grocery items carried
+    bool                    empty   (                 ) const noexcept;
+    bool                    contains( const Upc & upc ) const;
+    std::optional<Quantity> quantity( const Upc & upc ) const;                  // Quantity on hand, or nothing if the item isn't carried
+    std::optional<Quantity> quantity( const Upc & upc, Hint & hint ) const;     // Same, but searching onward from hint
+    Quantity                at      ( const Upc & upc ) const;                  // Same, but throws std::out_of_range if the item isn't carried
+    std::vector<Item>       snapshot(                 ) const;                  // Every item carried and its quantity at one instant, by UPC
+
+    // Modifiers, safe to call concurrently with anything
+    Sale        decrementIfAvailable( const Upc & upc );                        // Takes one unit, but never below zero
+    Sale        decrementIfAvailable( const Upc & upc, Quantity count );        // Takes count units, or every unit left if there are fewer,
+                                                                                // which is OUT_OF_STOCK
+    Sale        decrementIfAvailable( const Upc & upc, Quantity count,          // Same, but searching onward from hint
+                                      Hint & hint );
+    bool        restock             ( const Upc & upc, Quantity count );        // Adds count units, returns false if the item isn't carried
+    bool        restock             ( const Upc & upc, Quantity count,          // Same, but searching onward from hint
+                                      Hint & hint );
+    std::size_t erase               ( const Upc & upc );                        // Stops carrying the item, returns the number erased (0 or 1)
+
+    // Observing changes
+    void observe( Observer observer );                                          // Replaces the observer.  Not safe to call while the inventory is
+                                                                                // being modified
+
+    // Relational Operators
+    bool operator==( const Inventory & rhs ) const;                             // Same items carried, in the same quantities
+
+  private:
+    inline static constexpr std::size_t SHARDS = 64;                            // A power of 2
+
+    struct Slot
+    {
+      Quantity quantity = 0;
+      bool     carried  = false;                                                // False once erased
+    };
+
+    struct alignas( 64 ) Shard                                                  // Cache line aligned so neighboring locks don't false share
+    {
+      std::mutex        mutex;
+      std::vector<Slot> slots;                                                  // The slot of UPC number i is slots[i / SHARDS] in shard i % SHARDS
+    };
+
+    std::optional<std::size_t> position( const Upc & upc ) const;               // Position of upc in _upcs
+    std::optional<std::size_t> position( const Upc & upc, Hint & hint ) const;  // Same, galloping forward from hint, and leaves hint at upc's place
+    std::optional<Quantity>    quantityAt ( std::optional<std::size_t> at ) const;
+    Sale                       decrementAt( std::optional<std::size_t> at, const Upc & upc, Quantity count );
+    bool                       restockAt  ( std::optional<std::size_t> at, const Upc & upc, Quantity count );
+    Shard & shardOf( std::size_t position ) const noexcept;
+    Slot  & slotOf ( std::size_t position ) const noexcept;
+
+    std::vector<Upc>           _upcs;                                           // Every UPC ever carried, sorted.  Never changes once built
+    std::unique_ptr<Shard[]>   _shards;
+    std::atomic<std::size_t>   _size = 0;                                       // Number of slots still carried
+    Observer                   _observer;                                       // Told of every change, if set
+};
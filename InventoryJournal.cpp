@@ -0,0 +1,423 @@
+#include <algorithm>                                                    // fill_n(), max(), stable_sort()
+#include <cerrno>                                                       // errno, EINTR
+#include <charconv>                                                     // to_chars()
+#include <cstddef>                                                      // size_t, ptrdiff_t
+#include <cstdint>                                                      // uint32_t, uint64_t
+#include <cstring>                                                      // memcpy(), strerror()
+#include <filesystem>                                                   // rename(), remove(), resize_file(), file_size()
+#include <iostream>
+#include <mutex>                                                        // lock_guard, unique_lock
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>                                                 // error_code
+#include <utility>                                                      // move(), pair
+#include <vector>
+
+#include <fcntl.h>                                                      // open()
+#include <unistd.h>                                                     // write(), fsync(), fdatasync(), ftruncate(), lseek(), close()
+
+#include "Inventory.hpp"
+#include "InventoryJournal.hpp"
+#include "MemoryMappedFile.hpp"
+#include "Upc.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // A logged change is RECORD_SIZE bytes:  the UPC's value, with ERASED set if the item was erased, the quantity afterwards, and a
+  // check of both.  A change only partly written, or the zeros a crash can leave where a change was never written, fail the check.
+  constexpr std::size_t    RECORD_SIZE    = 16;
+  constexpr std::uint64_t  ERASED         = 1ULL << 63;
+  constexpr std::ptrdiff_t QUANTITY_WIDTH = 5;                          // Matches the inventory file the store ships with
+
+  using Change = std::pair<Upc, std::optional<Inventory::Quantity>>;
+
+
+
+  std::uint32_t check( std::uint64_t key, std::uint32_t quantity ) noexcept
+  {
+    auto hash = ( key ^ 0x5851'F42D'4C95'7F2DULL ) * 0x9E37'79B9'7F4A'7C15ULL  ^  ( quantity + 1ULL ) * 0xC2B2'AE3D'27D4'EB4FULL;
+    return static_cast<std::uint32_t>( hash ^ ( hash >> 32 ) );
+  }
+
+
+
+  void encode( std::string & buffer, std::uint64_t key, std::uint32_t quantity )
+  {
+    auto sum = check( key, quantity );
+
+    char record[RECORD_SIZE];
+    std::memcpy( record,      &key,      sizeof( key      ) );
+    std::memcpy( record + 8,  &quantity, sizeof( quantity ) );
+    std::memcpy( record + 12, &sum,      sizeof( sum      ) );
+    buffer.append( record, RECORD_SIZE );
+  }
+
+
+
+  std::optional<Change> decode( const char * record ) noexcept
+  {
+    std::uint64_t key;
+    std::uint32_t quantity, sum;
+    std::memcpy( &key,      record,      sizeof( key      ) );
+    std::memcpy( &quantity, record + 8,  sizeof( quantity ) );
+    std::memcpy( &sum,      record + 12, sizeof( sum      ) );
+    if( sum != check( key, quantity ) ) return std::nullopt;
+
+    auto upc = Upc::fromValue( key & ~ERASED );
+    if( !upc ) return std::nullopt;
+
+    return Change{ *upc, ( key & ERASED ) != 0  ?  std::nullopt  :  std::optional<Inventory::Quantity>( quantity ) };
+  }
+
+
+
+  int openLog( const std::string & filename ) noexcept
+  { return ::open( filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 ); }
+
+
+
+  std::uint64_t sizeOf( int fileDescriptor ) noexcept
+  {
+    auto size = fileDescriptor < 0  ?  -1  :  ::lseek( fileDescriptor, 0, SEEK_END );
+    return size < 0  ?  0  :  static_cast<std::uint64_t>( size );
+  }
+
+
+
+  bool writeAll( int fileDescriptor, std::string_view bytes ) noexcept
+  {
+    while( !bytes.empty() )
+    {
+      auto written = ::write( fileDescriptor, bytes.data(), bytes.size() );
+      if( written < 0 )
+      {
+        if( errno == EINTR ) continue;
+        return false;
+      }
+      bytes.remove_prefix( static_cast<std::size_t>( written ) );
+    }
+    return true;
+  }
+
+
+
+  // A file created, renamed, or removed isn't durable until the directory holding it is synced too
+  void syncDirectoryOf( const std::string & filename ) noexcept
+  {
+    auto directory = std::filesystem::path( filename ).parent_path();
+    if( directory.empty() ) directory = ".";
+
+    int fileDescriptor = ::open( directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    if( fileDescriptor < 0 ) return;
+
+    ::fsync( fileDescriptor );
+    ::close( fileDescriptor );
+  }
+
+
+
+  // Inventory records in the inventory file's own format, Ex:  "00044100117428    8"
+  std::string format( const std::vector<Inventory::Item> & items )
+  {
+    std::string text;
+    text.reserve( items.size() * ( Upc::DIGITS + QUANTITY_WIDTH + 1 ) );
+
+    for( const auto & [upc, quantity] : items )
+    {
+      char quantityText[16];
+      auto quantityLength = std::to_chars( quantityText, quantityText + sizeof( quantityText ), quantity ).ptr - quantityText;
+
+      char line[Upc::DIGITS + sizeof( quantityText ) + 2];
+      auto last = upc.to_chars( line );
+      last = std::fill_n( last, std::max<std::ptrdiff_t>( 1, QUANTITY_WIDTH - quantityLength ), ' ' );
+      last = std::copy( quantityText, quantityText + quantityLength, last );
+      *last++ = '\n';
+      text.append( line, last );
+    }
+    return text;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Recovery
+*******************************************************************************/
+std::string InventoryJournal::logFilename( const std::string & inventoryFilename )
+{ return inventoryFilename + ".wal"; }
+
+
+
+std::string InventoryJournal::retiredLogFilename( const std::string & inventoryFilename )
+{ return inventoryFilename + ".wal.old"; }
+
+
+
+// Only the last change to each item matters, so the changes are gathered from the log set aside by an unfinished checkpoint, which
+// is older, and then the current log, ordered by UPC keeping their order within each UPC, and merged with the inventory in a single
+// pass.  A log ends at its first change that fails its check, and is cut back to there so changes appended later aren't lost behind it.
+std::size_t InventoryJournal::replay( Inventory & inventory, const std::string & inventoryFilename, std::ostream & diagnostics )
+{
+  std::vector<Change> changes;
+  for( const auto & filename : { retiredLogFilename( inventoryFilename ), logFilename( inventoryFilename ) } )
+  {
+    std::size_t valid = 0, size = 0;
+    {
+      MemoryMappedFile log( filename );
+      auto             bytes = log.view();
+      size = bytes.size();
+
+      for( ;  valid + RECORD_SIZE <= size;  valid += RECORD_SIZE )
+      {
+        auto change = decode( bytes.data() + valid );
+        if( !change ) break;
+        changes.push_back( *change );
+      }
+    }
+
+    if( valid != size )
+    {
+      diagnostics << "Warning:  " << filename << ":  " << size - valid << " byte(s) at the end of the inventory log were not completely written and are ignored\n\n";
+      std::error_code error;
+      std::filesystem::resize_file( filename, valid, error );
+    }
+  }
+  if( changes.empty() ) return 0;
+
+  std::stable_sort( changes.begin(), changes.end(), []( const Change & lhs, const Change & rhs ) { return lhs.first < rhs.first; } );
+
+  auto                         items  = inventory.snapshot();
+  auto                         change = changes.cbegin();
+  std::vector<Inventory::Item> replayed;
+  replayed.reserve( items.size() );
+  for( const auto & item : items )
+  {
+    while( change != changes.cend()  &&  change->first < item.first ) ++change;   // changes to items no longer carried are ignored
+
+    std::optional<Inventory::Quantity> quantity = item.second;
+    for( ;  change != changes.cend()  &&  change->first == item.first;  ++change ) quantity = change->second;
+
+    if( quantity ) replayed.emplace_back( item.first, *quantity );
+  }
+
+  inventory = Inventory( std::move( replayed ) );
+  return changes.size();
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Constructors, assignments, and destructor
+*******************************************************************************/
+InventoryJournal::InventoryJournal( const std::string & inventoryFilename, std::size_t checkpointInterval )
+  : _inventoryFilename ( inventoryFilename ),
+    _checkpointInterval( checkpointInterval ),
+    _log               ( openLog( logFilename( inventoryFilename ) ) ),
+    _logSize           ( sizeOf( _log ) )
+{
+  if( _log < 0 ) std::cerr << "Warning:  Could not open inventory log \"" << logFilename( inventoryFilename ) << "\".  Inventory changes will not be durable\n\n";
+  syncDirectoryOf( inventoryFilename );
+
+  // Changes left in the logs by earlier runs count towards the next checkpoint
+  for( const auto & filename : { logFilename( inventoryFilename ), retiredLogFilename( inventoryFilename ) } )
+  {
+    std::error_code error;
+    auto            size = std::filesystem::file_size( filename, error );
+    if( !error ) _sinceCheckpoint += size / RECORD_SIZE;
+  }
+}
+
+
+
+InventoryJournal::~InventoryJournal() noexcept
+{
+  std::unique_lock lock( _mutex );
+  flush( lock );
+  if( _log >= 0 ) ::close( _log );
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Logging
+*******************************************************************************/
+void InventoryJournal::append( const Upc & upc, std::optional<Inventory::Quantity> quantity )
+{
+  std::lock_guard lock( _mutex );
+  encode( _pending, quantity  ?  upc.value()  :  upc.value() | ERASED, quantity.value_or( 0 ) );
+  ++_appended;
+  ++_sinceCheckpoint;
+  ++_statistics.changes;
+}
+
+
+
+// Whoever finds no flush in progress flushes everything appended so far, not just their own changes.  Everyone else waits, and
+// if the flush they waited for didn't include all of their changes, the next one will.
+bool InventoryJournal::commit()
+{
+  std::unique_lock lock( _mutex );
+  for( auto target = _appended;  _durable < target; )
+  {
+    if     ( _flushing      ) _flushed.wait( lock );
+    else if( !flush( lock ) ) return false;
+  }
+  return true;
+}
+
+
+
+// The lock is released while writing and syncing, so changes keep being appended to _pending meanwhile.  Nothing else touches the
+// log while a flush is in progress.
+//
+// A failed write may have left part of the batch in the log, and replay() stops at the first change partly written, losing every
+// change logged after it.  So the log is cut back to its last whole change, reopened first in case the descriptor is what failed,
+// and the batch goes back in front of the changes appended since, to be written again.  If even that fails, the log is closed and
+// the batch dropped, as when the log couldn't be opened at all, and the changes won't be durable until the next checkpoint.
+bool InventoryJournal::flush( std::unique_lock<std::mutex> & lock )
+{
+  while( _flushing ) _flushed.wait( lock );
+  if( _durable == _appended ) return true;
+
+  _flushing = true;
+  _writing.clear();
+  _writing.swap( _pending );                                            // reuses the capacity of the last batch written
+  auto upTo = _appended;
+  lock.unlock();
+
+  bool written = _log >= 0  &&  writeAll( _log, _writing )  &&  ::fdatasync( _log ) == 0;
+  int  error   = written  ?  0  :  errno;
+
+  lock.lock();
+  if( written )
+  {
+    _durable  = upTo;
+    _logSize += _writing.size();
+  }
+  else if( _log >= 0 )
+  {
+    auto log = logFilename( _inventoryFilename );
+    std::cerr << "Warning:  Could not write inventory log \"" << log << "\":  " << std::strerror( error ) << "\n\n";
+
+    ::close( _log );
+    _log = openLog( log );
+    if( _log >= 0  &&  ::ftruncate( _log, static_cast<off_t>( _logSize ) ) == 0 )
+    {
+      _pending.insert( 0, _writing );
+    }
+    else
+    {
+      if( _log >= 0 ) ::close( _log );
+      _log = -1;
+      std::cerr << "Warning:  Could not restore inventory log \"" << log << "\".  Inventory changes will not be durable\n\n";
+    }
+  }
+  _flushing = false;
+  ++_statistics.syncs;
+  _flushed.notify_all();
+  return written;
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Checkpoints
+*******************************************************************************/
+bool InventoryJournal::checkpointDue() const
+{
+  std::lock_guard lock( _mutex );
+  return _sinceCheckpoint >= _checkpointInterval;
+}
+
+
+
+bool InventoryJournal::checkpoint( const Inventory & inventory )
+{
+  std::lock_guard checkpointing( _checkpointMutex );
+
+  auto log     = logFilename       ( _inventoryFilename );
+  auto retired = retiredLogFilename( _inventoryFilename );
+
+  // Set the log aside and start a new one.  Every change in the old log was made before the snapshot below, so once the snapshot is
+  // the inventory file the old log is superseded.  If a failed checkpoint already set a log aside, the current log simply carries on:
+  // replaying its earlier changes along with the later ones still ends with each item's latest quantity.
+  {
+    std::unique_lock lock( _mutex );
+    flush( lock );
+
+    if( _log >= 0  &&  !std::filesystem::exists( retired ) )
+    {
+      ::close( _log );
+      std::error_code error;
+      std::filesystem::rename( log, retired, error );
+      _log     = openLog( log );
+      _logSize = sizeOf ( _log );
+      syncDirectoryOf( log );
+      if( _log < 0 ) std::cerr << "Warning:  Could not open inventory log \"" << log << "\".  Inventory changes will not be durable\n\n";
+    }
+    _sinceCheckpoint = 0;
+  }
+
+  // Write the snapshot to a temporary file and then rename it into place, so the inventory file is never partly written
+  auto text      = format( inventory.snapshot() );
+  auto temporary = _inventoryFilename + ".tmp";
+  auto failed    = [&]( const std::string & reason )
+  {
+    std::cerr << "Warning:  Could not checkpoint inventory file \"" << _inventoryFilename << "\":  " << reason << ".  Its log is kept\n\n";
+    std::error_code error;
+    std::filesystem::remove( temporary, error );
+    return false;
+  };
+
+  int file = ::open( temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+  if( file < 0 ) return failed( std::strerror( errno ) );
+
+  bool written = writeAll( file, text )  &&  ::fsync( file ) == 0;
+  ::close( file );
+  if( !written ) return failed( "write failed" );
+
+  std::error_code error;
+  std::filesystem::rename( temporary, _inventoryFilename, error );
+  if( error ) return failed( error.message() );
+  syncDirectoryOf( _inventoryFilename );
+
+  std::filesystem::remove( retired, error );
+  syncDirectoryOf( retired );
+
+  std::lock_guard lock( _mutex );
+  ++_statistics.checkpoints;
+  return true;
+}
+
+
+
+InventoryJournal::Statistics InventoryJournal::statistics() const
+{
+  std::lock_guard lock( _mutex );
+  return _statistics;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>                                                              // size_t
+#include <cstdint>                                                              // uint64_t
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Inventory.hpp"
+#include "Upc.hpp"
+
+
+
+// Whether a store's inventory changes survive a restart
+enum class Durability
+{
+  NONE,                                                                         // Read the inventory file at start up and never write it
+  JOURNALED                                                                     // Log every change ahead of time and checkpoint the inventory file
+};
+
+
+
+// A write-ahead log of an inventory's changes, which makes them survive a restart or a crash.
+//
+// Each change is recorded as the grocery item's quantity afterwards (or its erasure), so replaying a change is harmless no matter
+// how often it's done, and the last change to an item is all that matters.  Changes are appended to a buffer in memory, which is
+// cheap enough to do from an Inventory observer.  commit() makes everything appended so far durable:  one committer writes the
+// whole buffer and forces it to disk with a single fsync while any others arriving meanwhile wait for it, and then share the next
+// one (group commit).  If the write fails, the log is cut back to where it was, so it never holds a change partly written, and the
+// changes are written again by the next commit.
+//
+// A checkpoint rewrites the inventory file itself from a snapshot of the inventory, writing a temporary file and then renaming it
+// over the original, so the inventory file is always either the old one or the new one in full.  The log is set aside just before
+// the snapshot is taken and deleted once the new inventory file is in place.  At start up the inventory file is loaded as usual and
+// replay() brings it up to date from whatever log remains, ignoring a change only partly written when the process stopped.
+class InventoryJournal
+{
+  public:
+    inline static constexpr std::size_t DEFAULT_CHECKPOINT_INTERVAL = 100'000;  // Changes logged between checkpoints
+
+    struct Statistics
+    {
+      std::size_t changes     = 0;                                              // Changes appended
+      std::size_t syncs       = 0;                                              // Times the log was forced to disk
+      std::size_t checkpoints = 0;                                              // Inventory files written
+    };
+
+    // Applies the changes logged for inventoryFilename to the inventory loaded from it.  Returns the number of changes replayed.
+    static std::size_t replay( Inventory & inventory, const std::string & inventoryFilename, std::ostream & diagnostics = std::cerr );
+
+    // Name of the log kept for an inventory file, and of the log set aside by a checkpoint still in progress
+    static std::string logFilename       ( const std::string & inventoryFilename );
+    static std::string retiredLogFilename( const std::string & inventoryFilename );
+
+
+    // Constructors, assignments, and destructor
+    explicit InventoryJournal( const std::string & inventoryFilename, std::size_t checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL );
+
+    InventoryJournal( const InventoryJournal & )             = delete;          // intentionally prohibit making copies
+    InventoryJournal & operator=( const InventoryJournal & ) = delete;          // intentionally prohibit copy assignments
+
+   ~InventoryJournal() noexcept;                                                // Commits whatever is still buffered
+
+
+    // Logging, safe to call concurrently with anything
+    void append( const Upc & upc, std::optional<Inventory::Quantity> quantity ); // Buffers a change, the item's quantity afterwards or nothing if erased
+    bool commit();                                                              // Returns once every change appended so far is on disk, or false
+                                                                                // if they couldn't be written.  They're tried again next commit
+
+    // Checkpoints, safe to call concurrently with logging
+    bool checkpointDue() const;                                                 // True once the checkpoint interval's worth of changes are logged
+    bool checkpoint( const Inventory & inventory );                             // Rewrites the inventory file from inventory and discards the log
+                                                                                // it supersedes.  Returns false, keeping the log, on failure
+
+    Statistics statistics() const;
+
+  private:
+    bool flush( std::unique_lock<std::mutex> & lock );                          // Writes and syncs the buffer.  Requires lock to hold _mutex
+
+    std::string             _inventoryFilename;
+    std::size_t             _checkpointInterval;
+
+    mutable std::mutex      _mutex;                                             // Guards everything below
+    std::condition_variable _flushed;                                           // Signaled each time a flush finishes
+    int                     _log              = -1;                             // File descriptor of the log, opened for appending
+    std::uint64_t           _logSize          = 0;                              // Bytes of the log known to hold whole changes
+    std::string             _pending;                                           // Changes appended but not yet written
+    std::string             _writing;                                           // Changes being written by the flush in progress
+    std::uint64_t           _appended         = 0;                              // Changes appended, ever
+    std::uint64_t           _durable          = 0;                              // Changes known to be on disk, ever
+    std::uint64_t           _sinceCheckpoint  = 0;                              // Changes appended since the log was last set aside
+    bool                    _flushing         = false;                          // True while a flush writes outside the lock
+    Statistics              _statistics;
+
+    std::mutex              _checkpointMutex;                                   // Checkpoints take turns
+};
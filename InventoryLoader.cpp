@@ -0,0 +1,177 @@
+#include <algorithm>                                                    // copy(), is_sorted(), stable_sort()
+#include <charconv>                                                     // from_chars()
+#include <cstddef>                                                      // size_t
+#include <cstring>                                                      // memchr()
+#include <iostream>
+#include <limits>                                                       // numeric_limits
+#include <string>
+#include <string_view>
+#include <system_error>                                                 // errc
+#include <utility>                                                      // move()
+#include <vector>
+
+#include "Inventory.hpp"
+#include "InventoryLoader.hpp"
+#include "Upc.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  constexpr std::size_t BLOCK_SIZE = 1 << 20;                           // Bytes read from the stream at a time
+
+
+
+  // The same characters std::isspace() recognizes in the "C" locale, which is what the extraction operators skip
+  constexpr bool isWhitespace( char c ) noexcept
+  { return c == ' '  ||  c == '\t'  ||  c == '\n'  ||  c == '\v'  ||  c == '\f'  ||  c == '\r'; }
+
+
+
+  void skipWhitespace( const char * & cursor, const char * end ) noexcept
+  { while( cursor != end  &&  isWhitespace( *cursor ) ) ++cursor; }
+
+
+
+  // Parses one line, which holds no newline.  Returns nullptr and sets item on success, or a description of what's wrong otherwise.
+  // An empty line yields neither:  it returns nullptr and leaves isBlank set.
+  const char * parseLine( std::string_view line, Inventory::Item & item, bool & isBlank )
+  {
+    auto cursor = line.data();
+    auto end    = line.data() + line.size();
+
+    skipWhitespace( cursor, end );
+    isBlank = cursor == end;
+    if( isBlank ) return nullptr;
+
+    // UPC, quoted or not
+    std::string_view upcText;
+    if( *cursor == '"' )
+    {
+      ++cursor;
+      auto closingQuote = static_cast<const char *>( std::memchr( cursor, '"', static_cast<std::size_t>( end - cursor ) ) );
+      if( closingQuote == nullptr ) return "UPC is missing its closing quote";
+
+      upcText = std::string_view( cursor, static_cast<std::size_t>( closingQuote - cursor ) );
+      cursor  = closingQuote + 1;
+    }
+    else
+    {
+      auto first = cursor;
+      while( cursor != end  &&  !isWhitespace( *cursor ) ) ++cursor;
+      upcText = std::string_view( first, static_cast<std::size_t>( cursor - first ) );
+    }
+
+    auto upc = Upc::parse( upcText );
+    if( !upc ) return "UPC is not 14 digits";
+
+    // Quantity on hand
+    skipWhitespace( cursor, end );
+    Inventory::Quantity quantity = 0;
+    auto [next, error] = std::from_chars( cursor, end, quantity );
+    if( error == std::errc::result_out_of_range ) return "quantity is too large";
+    if( error != std::errc{}                    ) return "quantity is missing or not a whole number";
+
+    // Nothing else
+    cursor = next;
+    skipWhitespace( cursor, end );
+    if( cursor != end ) return "unexpected text follows the quantity";
+
+    item = { *upc, quantity };
+    return nullptr;
+  }
+
+
+
+  // Sorts items by UPC, keeping records that share a UPC in file order, then folds each run of equal UPCs into its first record.
+  // Returns the number of records folded away.
+  std::size_t merge( std::vector<Inventory::Item> & items, MergePolicy policy )
+  {
+    auto byUpc = []( const Inventory::Item & lhs, const Inventory::Item & rhs ) { return lhs.first < rhs.first; };
+    if( !std::is_sorted( items.begin(), items.end(), byUpc ) ) std::stable_sort( items.begin(), items.end(), byUpc );
+
+    constexpr auto MAXIMUM = std::numeric_limits<Inventory::Quantity>::max();
+
+    std::size_t kept = 0;
+    for( std::size_t i = 0; i < items.size(); ++i )
+    {
+      if( kept == 0  ||  items[kept - 1].first != items[i].first )
+      {
+        items[kept++] = items[i];
+        continue;
+      }
+
+      auto & survivor = items[kept - 1].second;
+      auto   quantity = items[i].second;
+      survivor = policy == MergePolicy::FIRST_WINS  ?  survivor
+               : policy == MergePolicy::LAST_WINS   ?  quantity
+               : quantity > MAXIMUM - survivor      ?  MAXIMUM
+               :                                       survivor + quantity;
+    }
+
+    auto merged = items.size() - kept;
+    items.resize( kept );
+    return merged;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Loading
+*******************************************************************************/
+InventoryLoadResult loadInventory( std::istream & stream, const std::string & sourceName, MergePolicy policy, std::ostream & diagnostics )
+{
+  InventoryLoadResult          result;
+  std::vector<Inventory::Item> items;
+  std::size_t                  lineNumber = 0;
+
+  auto consume = [&]( std::string_view line )
+  {
+    ++lineNumber;
+
+    Inventory::Item item;
+    bool            isBlank = false;
+    if( auto problem = parseLine( line, item, isBlank ) )
+    {
+      diagnostics << "Warning:  " << sourceName << ':' << lineNumber << ":  " << problem << ", record ignored\n";
+      ++result.rejected;
+    }
+    else if( !isBlank ) items.push_back( item );
+  };
+
+  // The block holds whatever partial line was left over from the previous read followed by newly read bytes.  Every complete line
+  // is parsed directly out of the block, and the partial line at the end moves to the front for the next read.
+  std::vector<char> block( BLOCK_SIZE );
+  std::size_t       carried = 0;
+  while( stream )
+  {
+    if( carried == block.size() ) block.resize( block.size() * 2 );    // a single line longer than a block, grow to hold it
+
+    stream.read( block.data() + carried, static_cast<std::streamsize>( block.size() - carried ) );
+    auto filled = carried + static_cast<std::size_t>( stream.gcount() );
+
+    std::string_view text( block.data(), filled );
+    for( auto newline = text.find( '\n' );  newline != std::string_view::npos;  newline = text.find( '\n' ) )
+    {
+      consume( text.substr( 0, newline ) );
+      text.remove_prefix( newline + 1 );
+    }
+
+    carried = text.size();
+    std::copy( text.begin(), text.end(), block.begin() );
+  }
+  if( carried != 0 ) consume( std::string_view( block.data(), carried ) );  // last line has no newline
+
+  result.records   = items.size();
+  result.merged    = merge( items, policy );
+  result.inventory = Inventory( std::move( items ) );                  // already sorted and unique, so built without further sorting
+  return result;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>                                                              // size_t
+#include <iostream>
+#include <string>
+
+#include "Inventory.hpp"
+
+
+
+// How records sharing a UPC combine into a single inventory item
+enum class MergePolicy
+{
+  FIRST_WINS,                                                                   // Keep the quantity from the earliest record
+  LAST_WINS,                                                                    // Keep the quantity from the latest record, as an append-only feed intends
+  SUM                                                                           // Add the quantities together, saturating at the largest Quantity
+};
+
+
+
+// What loading an inventory file produced
+struct InventoryLoadResult
+{
+  Inventory   inventory;
+  std::size_t records  = 0;                                                     // Well formed records read, including duplicates
+  std::size_t rejected = 0;                                                     // Malformed lines skipped
+  std::size_t merged   = 0;                                                     // Records folded into an earlier record with the same UPC
+};
+
+
+
+// Reads a store's inventory file:  one record per line, a UPC (with or without double quotes) followed by whitespace and a quantity
+// on hand, like this:
+//     "00044100117428"     8
+//      00041780001566     46
+//
+// The stream is read in large blocks and parsed in place, with no per-record allocation, and the inventory is built once from all
+// the records rather than item by item.  Blank lines are ignored.  A malformed line is reported to diagnostics as
+// "sourceName:line: reason" and skipped; it doesn't stop the load.  Records sharing a UPC are combined according to policy in a
+// single pass over the records sorted by UPC.
+InventoryLoadResult loadInventory( std::istream       & stream,
+                                   const std::string  & sourceName,
+                                   MergePolicy          policy      = MergePolicy::FIRST_WINS,
+                                   std::ostream       & diagnostics = std::cerr );
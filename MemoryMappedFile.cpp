@@ -0,0 +1,104 @@
+#include <cstddef>                                                      // size_t
+#include <string>
+#include <string_view>
+#include <utility>                                                      // exchange()
+
+#include <fcntl.h>                                                      // open()
+#include <sys/mman.h>                                                   // mmap(), munmap(), madvise()
+#include <sys/stat.h>                                                   // fstat()
+#include <unistd.h>                                                     // close()
+
+#include "MemoryMappedFile.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors, assignments, and destructor
+*******************************************************************************/
+MemoryMappedFile::MemoryMappedFile( const std::string & filename, AccessPattern accessPattern )
+{
+  int fileDescriptor = ::open( filename.c_str(), O_RDONLY | O_CLOEXEC );
+  if( fileDescriptor < 0 ) return;
+
+  struct stat status{};
+  if( ::fstat( fileDescriptor, &status ) == 0 )
+  {
+    _isOpen = true;
+
+    // mmap() refuses zero length mappings, so an empty file is simply an open file with nothing in it
+    if( status.st_size > 0 )
+    {
+      auto size    = static_cast<std::size_t>( status.st_size );
+      void * first = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+
+      if( first != MAP_FAILED )
+      {
+        int advice = accessPattern == AccessPattern::SEQUENTIAL  ?  MADV_SEQUENTIAL                // advisory only
+                   : accessPattern == AccessPattern::RANDOM      ?  MADV_RANDOM
+                   :                                                MADV_NORMAL;
+        ::madvise( first, size, advice );
+        _data = static_cast<const char *>( first );
+        _size = size;
+      }
+      else _isOpen = false;
+    }
+  }
+
+  ::close( fileDescriptor );                                            // the mapping remains valid after the descriptor is closed
+}
+
+
+
+
+MemoryMappedFile::MemoryMappedFile( MemoryMappedFile && other ) noexcept
+  : _data  { std::exchange( other._data,   nullptr ) },
+    _size  { std::exchange( other._size,   0       ) },
+    _isOpen{ std::exchange( other._isOpen, false   ) }
+{}
+
+
+
+
+MemoryMappedFile & MemoryMappedFile::operator=( MemoryMappedFile && rhs ) & noexcept
+{
+  if( this != &rhs )
+  {
+    release();
+    _data   = std::exchange( rhs._data,   nullptr );
+    _size   = std::exchange( rhs._size,   0       );
+    _isOpen = std::exchange( rhs._isOpen, false   );
+  }
+  return *this;
+}
+
+
+
+
+MemoryMappedFile::~MemoryMappedFile() noexcept
+{ release(); }
+
+
+
+
+void MemoryMappedFile::release() noexcept
+{
+  if( _data != nullptr ) ::munmap( const_cast<char *>( _data ), _size );
+  _data   = nullptr;
+  _size   = 0;
+  _isOpen = false;
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Queries
+*******************************************************************************/
+bool             MemoryMappedFile::is_open() const noexcept { return _isOpen;                  }
+std::size_t      MemoryMappedFile::size   () const noexcept { return _size;                    }
+const char *     MemoryMappedFile::data   () const noexcept { return _data;                    }
+std::string_view MemoryMappedFile::view   () const noexcept { return { _data, _size };         }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>                                                              // size_t
+#include <string>
+#include <string_view>
+
+
+
+// A read-only view of an entire file mapped into this process' address space.  The mapping is released when the object is
+// destroyed (RAII).  Mapping an empty file, or failing to map the file at all, yields an empty view.
+class MemoryMappedFile
+{
+  public:
+    // How the mapped bytes will be read, passed on to the kernel as a hint for read ahead
+    enum class AccessPattern { SEQUENTIAL, NORMAL, RANDOM };
+
+    // Constructors, assignments, and destructor
+    explicit MemoryMappedFile( const std::string & filename, AccessPattern accessPattern = AccessPattern::SEQUENTIAL );
+
+    MemoryMappedFile( MemoryMappedFile && other ) noexcept;
+    MemoryMappedFile & operator=( MemoryMappedFile && rhs ) & noexcept;
+
+    MemoryMappedFile( const MemoryMappedFile & )             = delete;          // intentionally prohibit making copies
+    MemoryMappedFile & operator=( const MemoryMappedFile & ) = delete;          // intentionally prohibit copy assignments
+
+   ~MemoryMappedFile() noexcept;
+
+
+    // Queries
+    bool             is_open() const noexcept;                                  // True if the file was opened, even if it is empty
+    std::size_t      size   () const noexcept;                                  // Number of bytes mapped
+    const char *     data   () const noexcept;                                  // First byte mapped, nullptr if nothing is mapped
+    std::string_view view   () const noexcept;                                  // The entire file's contents
+
+  private:
+    void release() noexcept;
+
+    const char * _data   = nullptr;
+    std::size_t  _size   = 0;
+    bool         _isOpen = false;
+};
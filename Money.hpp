@@ -0,0 +1,172 @@
+#pragma once
+
+#include <charconv>                                                             // from_chars(), to_chars(), from_chars_result
+#include <compare>                                                              // strong_ordering
+#include <cstddef>                                                              // size_t, ptrdiff_t
+#include <cstdint>                                                              // int64_t, uint64_t
+#include <iostream>
+#include <limits>                                                               // numeric_limits
+#include <string>
+#include <string_view>
+#include <system_error>                                                         // errc
+
+
+
+// An amount of money in US Dollars, held exactly as a whole number of cents.  Sums, differences, and comparisons are integer
+// operations, so a total is the same no matter how many items, in what order, or across how many threads it was added up, and two
+// prices are equal only when they are the same number of cents.  Amounts are always written as dollars and exactly two decimal
+// places (Ex: 2.29, -0.05), whatever the stream's floating point format.
+class Money
+{
+  public:
+    using Cents = std::int64_t;
+
+    inline static constexpr std::size_t MAXIMUM_LENGTH = 23;                   // Characters to_chars() may write, Ex: "-92233720368547758.08"
+
+    // Constructors
+    constexpr Money() noexcept = default;                                       // $0.00
+
+    constexpr Money( double dollars ) noexcept                                  // Intentionally implicit so prices can still be written as literals, Ex:
+      : _cents( static_cast<Cents>( dollars * 100.0 + ( dollars < 0.0  ?  -0.5  :  0.5 ) ) )   // GroceryItem( "milk", "Horizon", "00742365264504", 4.99 ).
+    {}                                                                          // Rounds to the nearest cent, halves away from zero
+
+    static constexpr Money fromCents( Cents cents ) noexcept
+    {
+      Money money;
+      money._cents = cents;
+      return money;
+    }
+
+
+    // Parses "[-]dollars[.fraction]" at the front of first, last the way std::from_chars() does, rounding a fraction of more than two
+    // digits to the nearest cent, halves away from zero.  At least one digit is required.  Returns a pointer past what was consumed,
+    // or first and std::errc::invalid_argument or std::errc::result_out_of_range leaving value unchanged.
+    static std::from_chars_result from_chars( const char * first, const char * last, Money & value ) noexcept
+    {
+      auto cursor   = first;
+      bool negative = cursor != last  &&  *cursor == '-';
+      if( negative ) ++cursor;
+
+      auto isDigit = []( char c ) { return c >= '0'  &&  c <= '9'; };
+
+      auto  wholeFirst = cursor;
+      while( cursor != last  &&  isDigit( *cursor ) ) ++cursor;
+      auto  wholeDigits = cursor - wholeFirst;
+      Cents dollars     = 0;
+      if( wholeDigits > 0  &&  std::from_chars( wholeFirst, cursor, dollars ).ec != std::errc{} ) return { first, std::errc::result_out_of_range };
+
+      Cents          cents          = 0;
+      std::ptrdiff_t fractionDigits = 0;
+      if( cursor != last  &&  *cursor == '.' )
+      {
+        auto fractionFirst = ++cursor;
+        while( cursor != last  &&  isDigit( *cursor ) ) ++cursor;
+        fractionDigits = cursor - fractionFirst;
+
+        if( fractionDigits > 0 ) cents += ( fractionFirst[0] - '0' ) * 10;
+        if( fractionDigits > 1 ) cents +=   fractionFirst[1] - '0';
+        if( fractionDigits > 2 ) cents +=   fractionFirst[2] >= '5'  ?  1  :  0;
+      }
+
+      if( wholeDigits == 0  &&  fractionDigits == 0                       ) return { first, std::errc::invalid_argument   };
+      if( dollars > ( std::numeric_limits<Cents>::max() - cents ) / 100 ) return { first, std::errc::result_out_of_range };
+
+      value._cents = ( negative  ?  -1  :  1 ) * ( dollars * 100 + cents );
+      return { cursor, std::errc{} };
+    }
+
+
+    // Queries
+    constexpr Cents  cents  () const noexcept { return _cents; }               // Ex: $2.29 is 229
+    constexpr double dollars() const noexcept { return static_cast<double>( _cents ) / 100.0; }   // Approximate, for reporting only
+
+    std::string to_string() const                                               // Dollars and exactly two decimal places, Ex: "2.29"
+    {
+      char text[MAXIMUM_LENGTH];
+      return { text, to_chars( text ) };
+    }
+
+    char * to_chars( char * first ) const noexcept                              // Same, but writes the text to first and returns a pointer
+    {                                                                           // past the last character written.  Nothing is allocated
+      auto magnitude = _cents < 0  ?  0 - static_cast<std::uint64_t>( _cents )  :  static_cast<std::uint64_t>( _cents );
+      if( _cents < 0 ) *first++ = '-';
+
+      first    = std::to_chars( first, first + MAXIMUM_LENGTH, magnitude / 100 ).ptr;
+      *first++ = '.';
+      *first++ = static_cast<char>( '0' + magnitude % 100 / 10 );
+      *first++ = static_cast<char>( '0' + magnitude % 10 );
+      return first;
+    }
+
+
+    // Arithmetic
+    constexpr Money & operator+=( const Money & rhs )       noexcept { _cents += rhs._cents;  return *this; }
+    constexpr Money & operator-=( const Money & rhs )       noexcept { _cents -= rhs._cents;  return *this; }
+    constexpr Money & operator*=( Cents quantity    )       noexcept { _cents *= quantity;    return *this; }
+    constexpr Money   operator- (                   ) const noexcept { return fromCents( -_cents ); }
+
+    friend constexpr Money operator+( Money lhs, const Money & rhs ) noexcept { return lhs += rhs;      }
+    friend constexpr Money operator-( Money lhs, const Money & rhs ) noexcept { return lhs -= rhs;      }
+    friend constexpr Money operator*( Money lhs, Cents quantity    ) noexcept { return lhs *= quantity; }
+    friend constexpr Money operator*( Cents quantity, Money rhs    ) noexcept { return rhs *= quantity; }
+
+
+    // Relational Operators
+    constexpr std::strong_ordering operator<=>( const Money & ) const noexcept = default;
+    constexpr bool                 operator== ( const Money & ) const noexcept = default;
+
+  private:
+    Cents _cents = 0;
+};
+
+
+
+// Insertion Operator:  dollars and exactly two decimal places, honoring the stream's field width
+inline std::ostream & operator<<( std::ostream & stream, const Money & money )
+{
+  char text[Money::MAXIMUM_LENGTH];
+  return stream << std::string_view( text, static_cast<std::size_t>( money.to_chars( text ) - text ) );
+}
+
+
+
+// Extraction Operator:  skips leading whitespace and reads an optionally signed decimal amount, Ex: 2.29, +13, -0.5.  Characters
+// that can't continue the amount are left in the stream.  On failure, money is unchanged and the stream's failbit is set.  Reaching
+// the end of the input sets eofbit, as extracting a double does.
+inline std::istream & operator>>( std::istream & stream, Money & money )
+{
+  std::istream::sentry okay( stream );
+  if( !okay ) return stream;
+
+  // Characters are taken straight from the stream buffer; peek() would fail once the end had been seen
+  using Traits = std::istream::traits_type;
+  auto buffer  = stream.rdbuf();
+  auto state   = std::ios::goodbit;
+
+  std::string text;
+  auto accept = [&]( auto predicate )
+  {
+    auto c = buffer->sgetc();
+    if( Traits::eq_int_type( c, Traits::eof() ) )
+    {
+      state |= std::ios::eofbit;
+      return false;
+    }
+    if( !predicate( Traits::to_char_type( c ) ) ) return false;
+
+    text += Traits::to_char_type( buffer->sbumpc() );
+    return true;
+  };
+  auto isDigit = []( char c ) { return c >= '0'  &&  c <= '9'; };
+
+  if( accept( []( char c ) { return c == '+'; } ) ) text.clear();
+  else accept( []( char c ) { return c == '-'; } );
+  while( accept( isDigit ) ) {}
+  if( accept( []( char c ) { return c == '.'; } ) ) while( accept( isDigit ) ) {}
+
+  auto [last, error] = Money::from_chars( text.data(), text.data() + text.size(), money );
+  if( error != std::errc{}  ||  last != text.data() + text.size() ) state |= std::ios::failbit;
+
+  stream.setstate( state );
+  return stream;
+}
@@ -0,0 +1,252 @@
+#include <charconv>                                                     // to_chars()
+#include <ios>                                                          // streamsize
+#include <iostream>
+#include <limits>                                                       // numeric_limits
+#include <string>
+#include <string_view>
+
+#include "GroceryItem.hpp"
+#include "GroceryItemDatabase.hpp"
+#include "Money.hpp"
+#include "ReceiptWriter.hpp"
+#include "Upc.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors, assignments, and destructor
+*******************************************************************************/
+ReceiptWriter::ReceiptWriter()
+{ _buffer.reserve( FLUSH_THRESHOLD + 1024 ); }
+
+
+
+ReceiptWriter::ReceiptWriter( std::ostream & stream )
+  : ReceiptWriter()
+{ _stream = &stream; }
+
+
+
+ReceiptWriter::~ReceiptWriter() noexcept
+{
+  try { flush(); }
+  catch( ... ) {}                                                       // a destructor must not throw; the stream's own state records the failure
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Receipt lines
+*******************************************************************************/
+ReceiptWriter & ReceiptWriter::customer( std::string_view name )
+{
+  _buffer += name;
+  _buffer += "'s shopping cart contains:\n";
+  lineDone();
+  return *this;
+}
+
+
+
+ReceiptWriter & ReceiptWriter::item( const GroceryItemView & groceryItem, unsigned quantity )
+{
+  _buffer += "  ";
+  appendItem( groceryItem );
+  if( quantity != 1  &&  groceryItem != nullptr )
+  {
+    _buffer += " x ";  appendNumber( quantity );
+    _buffer += " = ";  appendPrice ( groceryItem.price() * static_cast<Money::Cents>( quantity ) );
+  }
+  _buffer += '\n';
+  lineDone();
+  return *this;
+}
+
+
+
+ReceiptWriter & ReceiptWriter::notFound( const Upc & upc, std::string_view productName )
+{
+  _buffer += "  ";
+  appendUpc( upc );
+  _buffer += " (";
+  _buffer += productName;
+  _buffer += ") not found, the item is free!\n";
+  lineDone();
+  return *this;
+}
+
+
+
+ReceiptWriter & ReceiptWriter::total( Money amount )
+{
+  _buffer += "-------------------------\nTotal $";
+  appendPrice( amount );
+  _buffer += "\n\n";
+  lineDone();
+  return *this;
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Re-order report lines
+*******************************************************************************/
+ReceiptWriter & ReceiptWriter::reorderHeading()
+{
+  _buffer += "Re-Ordering grocery items the store is running low on\n\n";
+  lineDone();
+  return *this;
+}
+
+
+
+ReceiptWriter & ReceiptWriter::discontinued( unsigned number, const Upc & upc, const GroceryItemView & groceryItem )
+{
+  appendNumber( number );
+  _buffer += ": {";
+  if( groceryItem == nullptr ) appendUpc ( upc         );
+  else                         appendItem( groceryItem );
+  _buffer += "}\n *** no longer sold in this store and will not be re-ordered\n\n";
+  lineDone();
+  return *this;
+}
+
+
+
+ReceiptWriter & ReceiptWriter::reordered( unsigned number, const Upc & upc, const GroceryItemView & groceryItem, unsigned onHand, unsigned threshold, unsigned lotCount )
+{
+  appendNumber( number );
+  _buffer += ": {";
+  if( groceryItem == nullptr ) appendUpc ( upc         );
+  else                         appendItem( groceryItem );
+  _buffer += "}\n only ";                            appendNumber( onHand             );
+  _buffer += " remain in stock which is ";           appendNumber( threshold - onHand );
+  _buffer += " unit(s) below reorder threshold (";   appendNumber( threshold          );
+  _buffer += "), re-ordering ";                      appendNumber( lotCount           );
+  _buffer += " more\n\n";
+  lineDone();
+  return *this;
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Buffer management
+*******************************************************************************/
+std::string_view ReceiptWriter::text() const noexcept
+{ return _buffer; }
+
+
+
+void ReceiptWriter::clear() noexcept
+{ _buffer.clear(); }
+
+
+
+void ReceiptWriter::flush()
+{
+  if( _stream == nullptr  ||  _buffer.empty() ) return;
+
+  _stream->write( _buffer.data(), static_cast<std::streamsize>( _buffer.size() ) );
+  _buffer.clear();
+}
+
+
+
+void ReceiptWriter::lineDone()
+{ if( _buffer.size() >= FLUSH_THRESHOLD ) flush(); }
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Formatting
+*******************************************************************************/
+// Same three cases as the view's insertion operator.  A grocery item built, and possibly changed, through the view prints as
+// GroceryItem's insertion operator prints it.
+void ReceiptWriter::appendItem( const GroceryItemView & groceryItem )
+{
+  if( groceryItem == nullptr ) _buffer += "nullptr";
+  else if( auto materialized = groceryItem.materialized() )
+  {
+    appendQuoted( materialized->upcCode()     );  _buffer += ", ";
+    appendQuoted( materialized->brandName()   );  _buffer += ", ";
+    appendQuoted( materialized->productName() );  _buffer += ", ";
+    appendPrice ( materialized->price()       );
+  }
+  else
+  {
+    appendUpc   ( groceryItem.upc()         );  _buffer += ", ";
+    appendQuoted( groceryItem.brandName()   );  _buffer += ", ";
+    appendQuoted( groceryItem.productName() );  _buffer += ", ";
+    appendPrice ( groceryItem.price()       );
+  }
+}
+
+
+
+void ReceiptWriter::appendNumber( unsigned number )
+{
+  char text[std::numeric_limits<unsigned>::digits10 + 1];
+  _buffer.append( text, std::to_chars( text, text + sizeof( text ), number ).ptr );
+}
+
+
+
+// Mirrors std::quoted() insertion:  the text in double quotes, with each double quote and backslash preceded by a backslash
+void ReceiptWriter::appendQuoted( std::string_view text )
+{
+  _buffer += '"';
+  while( !text.empty() )
+  {
+    // Copy the longest run needing no escapes in one go; most strings are a single run
+    std::size_t run = 0;
+    while( run < text.size()  &&  text[run] != '"'  &&  text[run] != '\\' ) ++run;
+    _buffer.append( text.data(), run );
+    if( run == text.size() ) break;
+
+    _buffer += '\\';
+    _buffer += text[run];
+    text.remove_prefix( run + 1 );
+  }
+  _buffer += '"';
+}
+
+
+
+// A UPC is always 14 digits, so there's never anything to escape
+void ReceiptWriter::appendUpc( const Upc & upc )
+{
+  char text[Upc::DIGITS + 2] = { '"' };
+  upc.to_chars( text + 1 );
+  text[Upc::DIGITS + 1] = '"';
+  _buffer.append( text, sizeof( text ) );
+}
+
+
+
+// Money is always written the same way, whatever the stream's floating point format
+void ReceiptWriter::appendPrice( Money price )
+{
+  char text[Money::MAXIMUM_LENGTH];
+  _buffer.append( text, price.to_chars( text ) );
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>                                                              // size_t
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "GroceryItemDatabase.hpp"
+#include "Money.hpp"
+#include "Upc.hpp"
+
+
+
+// Renders checkout receipts into a reusable byte buffer instead of formatting field by field through an ostream.  Strings are
+// quoted and escaped exactly as std::quoted() does and prices are written with Money::to_chars(), so the bytes produced are identical
+// to inserting the same things into a stream.
+//
+// A writer bound to a stream hands it the buffer in large writes as it fills, and whatever remains when flushed or destroyed.  A
+// writer bound to no stream keeps everything it renders until taken with text(), which is how concurrent checkout lanes each build
+// their receipts to be written out in customer order afterwards.
+class ReceiptWriter
+{
+  public:
+    // Constructors, assignments, and destructor
+    ReceiptWriter();                                                            // Holds everything written
+    explicit ReceiptWriter( std::ostream & stream );                            // Writes through to stream
+
+    ReceiptWriter( const ReceiptWriter & )             = delete;                // intentionally prohibit making copies
+    ReceiptWriter & operator=( const ReceiptWriter & ) = delete;                // intentionally prohibit copy assignments
+
+   ~ReceiptWriter() noexcept;                                                   // Flushes
+
+    // Receipt lines, each exactly as GroceryStore has always printed them
+    ReceiptWriter & customer( std::string_view name );                          // <name>'s shopping cart contains:
+    ReceiptWriter & item    ( const GroceryItemView & groceryItem,              //   "<upc>", "<brand>", "<product>", <price>
+                              unsigned quantity = 1 );                          //   followed by " x <quantity> = <extended price>" unless just one
+    ReceiptWriter & notFound( const Upc & upc, std::string_view productName );  //   "<upc>" (<product>) not found, the item is free!
+    ReceiptWriter & total   ( Money amount );                                   // -------------------------
+                                                                                // Total $<amount>
+    // Re-order report lines, each exactly as GroceryStore has always printed them.  A grocery item missing from the database is
+    // shown by its UPC alone.
+    ReceiptWriter & reorderHeading();                                           // Re-Ordering grocery items the store is running low on
+    ReceiptWriter & discontinued( unsigned number, const Upc & upc,             // <number>: {<grocery item>}
+                                  const GroceryItemView & groceryItem );        //  *** no longer sold in this store and will not be re-ordered
+    ReceiptWriter & reordered   ( unsigned number, const Upc & upc,             // <number>: {<grocery item>}
+                                  const GroceryItemView & groceryItem,          //  only <onHand> remain in stock which is ... unit(s) below
+                                  unsigned onHand, unsigned threshold,          //  reorder threshold (<threshold>), re-ordering <lotCount> more
+                                  unsigned lotCount );
+    // Buffer management
+    std::string_view text () const noexcept;                                    // Everything rendered and not yet written to the stream
+    void             clear() noexcept;                                          // Discards text(), keeping the memory for reuse
+    void             flush();                                                   // Writes text() to the stream, if bound to one
+
+  private:
+    inline static constexpr std::size_t FLUSH_THRESHOLD = 64 * 1024;            // Bytes buffered before a stream bound writer writes them
+
+    void appendItem  ( const GroceryItemView & groceryItem );                  // "<upc>", "<brand>", "<product>", <price>, or nullptr
+    void appendNumber( unsigned number );
+    void appendQuoted( std::string_view text );
+    void appendPrice ( Money price );
+    void appendUpc   ( const Upc & upc );
+    void lineDone    ();                                                        // Flushes if bound to a stream and the buffer is full enough
+
+    std::ostream * _stream = nullptr;
+    std::string    _buffer;
+};
@@ -1,13 +1,26 @@
+#include <array>
+#include <atomic>
 #include <cstddef>                                                                        // size_t
+#include <cstdint>                                                                        // uint64_t
 #include <exception>
-#include <filesystem>                                                                     // exists()
+#include <filesystem>                                                                     // exists(), remove()
+#include <fstream>                                                                        // ofstream
 #include <iomanip>                                                                        // setprecision()
 #include <iostream>                                                                       // boolalpha(), showpoint(), fixed(), clog
-#include <map>
+#include <memory>                                                                         // shared_ptr, unique_ptr
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>                                                                         // jthread
+#include <unordered_map>
+#include <utility>                                                                        // swap()
+#include <vector>
 
 #include "CheckResults.hpp"
+#include "GroceryItem.hpp"
+#include "GroceryItemCatalog.hpp"
 #include "GroceryItemDatabase.hpp"
+#include "Money.hpp"
 
 
 
@@ -33,11 +46,13 @@ namespace  // anonymous
   {
     GroceryItemDatabase & db           = GroceryItemDatabase::instance();
     std::size_t           expectedSize = 0;
-    if     ( std::filesystem::exists( "Grocery_UPC_Database-Full.dat"   ) ) expectedSize = 10'837'828;
-    else if( std::filesystem::exists( "Grocery_UPC_Database-Large.dat"  ) ) expectedSize = 104'361;
-    else if( std::filesystem::exists( "Grocery_UPC_Database-Medium.dat" ) ) expectedSize = 10'003;
-    else if( std::filesystem::exists( "Grocery_UPC_Database-Small.dat"  ) ) expectedSize = 230;
-    else if( std::filesystem::exists( "Sample_GroceryItem_Database.dat" ) ) expectedSize = 15;
+    std::string           databaseFilename;
+    if     ( databaseFilename = "Grocery_UPC_Database-Full.dat";   std::filesystem::exists( databaseFilename ) ) expectedSize = 10'837'828;
+    else if( databaseFilename = "Grocery_UPC_Database-Large.dat";  std::filesystem::exists( databaseFilename ) ) expectedSize = 104'361;
+    else if( databaseFilename = "Grocery_UPC_Database-Medium.dat"; std::filesystem::exists( databaseFilename ) ) expectedSize = 10'003;
+    else if( databaseFilename = "Grocery_UPC_Database-Small.dat";  std::filesystem::exists( databaseFilename ) ) expectedSize = 230;
+    else if( databaseFilename = "Sample_GroceryItem_Database.dat"; std::filesystem::exists( databaseFilename ) ) expectedSize = 15;
+    else     databaseFilename.clear();
 
     affirm.is_equal( "Database construction - Expected size", expectedSize, db.size() );
 
@@ -71,7 +86,55 @@ namespace  // anonymous
     }
 
     {
-      // Grocery Item Database over Map:
+      // A batch spanning several probe groups, with repeats and misses mixed in, must agree with one at a time lookups in input order
+      std::vector<Upc> upcs;
+      for( unsigned i = 0; i < 100; ++i ) upcs.emplace_back( i % 3 == 0  ?  "00014100072331"  :  i % 3 == 1  ?  "00000000000000"  :  "00041331092609" );
+
+      auto        groceryItems = db.findMany( upcs );
+      std::size_t mismatches   = 0;
+      for( std::size_t i = 0; i < upcs.size(); ++i ) if( groceryItems[i] != db.find( upcs[i] ) ) ++mismatches;
+
+      affirm.is_equal( "Database batch query - one result per UPC",           upcs.size(),        groceryItems.size() );
+      affirm.is_equal( "Database batch query - results agree with find()",    std::size_t{ 0 },   mismatches          );
+      affirm.is_equal( "Database batch query - empty batch",                  std::size_t{ 0 },   db.findMany( {} ).size() );
+    }
+
+    {
+      // Ranges and prefixes are read straight from the sorted catalog, and must agree with a walk over every grocery item
+      auto        everything = db.range( "00000000000000", "99999999999999" );
+      std::size_t outOfOrder = 0, prefixed = 0;
+      for( auto i = everything.begin(); i != everything.end(); ++i )
+      {
+        if( i != everything.begin()  &&  !( i[-1].upc() < ( *i ).upc() ) ) ++outOfOrder;
+        if( ( *i ).upc().to_string().starts_with( "0004133" )             ) ++prefixed;
+      }
+
+      auto manufacturer = db.findPrefix( "0004133" );
+      std::size_t strays = 0;
+      for( const auto & groceryItem : manufacturer ) if( !groceryItem.upc().to_string().starts_with( "0004133" ) ) ++strays;
+
+      affirm.is_equal( "Database range query - spans every grocery item",       db.size(),          everything.size()   );
+      affirm.is_equal( "Database range query - grocery items in UPC order",     std::size_t{ 0 },   outOfOrder          );
+      affirm.is_equal( "Database prefix query - every match found",             prefixed,           manufacturer.size() );
+      affirm.is_equal( "Database prefix query - nothing but matches",           std::size_t{ 0 },   strays              );
+      affirm.is_true ( "Database prefix query - views agree with find()",       manufacturer.empty()  ||  manufacturer[0] == db.find( manufacturer[0].upc() ) );
+      affirm.is_true ( "Database prefix query - whole UPC is an exact match",   db.findPrefix( "00014100072331" ).size() == ( db.find( "00014100072331" ) == nullptr ? 0U : 1U ) );
+      affirm.is_true ( "Database prefix query - empty prefix matches all",      db.findPrefix( "" ).size() == db.size() );
+      affirm.is_true ( "Database prefix query - malformed prefix matches none", db.findPrefix( "0004a" ).empty()  &&  db.findPrefix( "000000000000000" ).empty() );
+      affirm.is_true ( "Database range query - reversed range is empty",        db.range( "99999999999999", "00000000000000" ).empty() );
+
+      // Hinted searches for increasing UPCs walk the range once, and agree with find() whether or not the UPC is there
+      auto        hint          = everything.begin();
+      std::size_t disagreements = 0;
+      for( auto upc : { Upc( "00000000000000" ), Upc( "00014100072331" ), Upc( "00041331092609" ), Upc( "00041331092610" ), Upc( "99999999999999" ), Upc( "00038000291210" ) } )
+      {
+        if( everything.find( upc, hint ) != db.find( upc ) ) ++disagreements;
+      }
+      affirm.is_equal( "Database range query - hinted searches agree with find()", std::size_t{ 0 }, disagreements );
+    }
+
+    {
+      // Grocery Item Database over a Columnar Catalog:
       //
       //
       // The attributes of the Grocery Item Database are private, so I can't get to them in the usual way.  If you're reading this,
@@ -79,9 +142,31 @@ namespace  // anonymous
       // of attributes in GroceryItemDatabase, or if other attributes are added - I'm screwed.  Not to mention I'm depending on
       // GroceryItemDatabase.hpp including what I need here.  By creating a struct that mirrors the attribute layout of the
       // GroceryItemDatabase I ensure proper attribute alignment and offset while gaining visibility.
+      struct VersionAttributes                                                                  // must exactly match the type and order of GroceryItemDatabase::Version's attributes
+      {
+        GroceryItemCatalog                                                            testCatalog;
+        GroceryItemDatabase::LoadStatistics                                           loadStatistics;
+        std::string                                                                   filename;
+        std::uint64_t                                                                 number;
+        std::shared_mutex                                                             materializedMutex;
+        std::unordered_map<GroceryItemCatalog::Record, std::unique_ptr<GroceryItem>> materialized;
+        std::atomic<bool>                                                             anyMaterialized;
+      };
+
+      struct SlotAttributes                                                                     // must exactly match the type and order of GroceryItemDatabase::Slot's attributes
+      {
+        std::shared_ptr<VersionAttributes>                                            version;
+        std::atomic<unsigned>                                                         readers;
+      };
+
       struct Attributes                                                                         // must exactly match the type and order of GroceryItemDatabase's instance attributes
       {
-        std::map<std::string, GroceryItem> testData;
+        std::array<SlotAttributes, 2>                                                 slots;
+        std::atomic<std::uint64_t>                                                    published;
+        std::mutex                                                                    reloadMutex;
+        std::vector<std::shared_ptr<VersionAttributes>>                               retired;
+        std::mutex                                                                    referencesMutex;
+        std::vector<void *>                                                           references;
       };
 
       // Let's do a little sanity checking to verify the GroceryItemDatabase and the Attribute classes at lest have the same size.
@@ -96,25 +181,158 @@ namespace  // anonymous
         // white-box test like this
         auto & DB_attributes = reinterpret_cast<Attributes &>( db );                            // direct access to db's private parts
 
-        std::map<std::string, GroceryItem> originalData;
-        originalData.swap( DB_attributes.testData );                                            // save the original database so it can be restored later
+        // The catalog must be sorted by UPC and its index must locate every grocery item at its own position
+        auto &      current    = DB_attributes.slots[DB_attributes.published % DB_attributes.slots.size()].version;
+        auto &      catalog    = current->testCatalog;
+        std::size_t outOfOrder = 0, misindexed = 0;
+        for( GroceryItemCatalog::Record record = 0; record < catalog.size(); ++record )
+        {
+          if( record > 0  &&  !( catalog.upc( record - 1 ) < catalog.upc( record ) ) ) ++outOfOrder;
+          if( catalog.find( catalog.upc( record ) ) != record                         ) ++misindexed;
+        }
+        affirm.is_equal( "Database catalog - grocery items in UPC order",  std::size_t{ 0 }, outOfOrder );
+        affirm.is_equal( "Database catalog - every grocery item indexed",  std::size_t{ 0 }, misindexed );
+        affirm.is_true ( "Database catalog - brand names interned",        catalog.brandCount() <= catalog.size() );
+
+        if( catalog.size() != 0 )
+        {
+          auto last        = static_cast<GroceryItemCatalog::Record>( catalog.size() - 1 );
+          auto groceryItem = db.find( catalog.upc( last ) );
+          affirm.is_equal( "Database query - Searching for the last item",  catalog.productName( last ), groceryItem.productName() );
+
+          groceryItem = db.find( catalog.upc( 0 ) );
+          affirm.is_equal( "Database query - Searching for the first item", catalog.productName( 0 ),    groceryItem.productName() );
+        }
+
+        GroceryItemCatalog originalCatalog;
+        std::swap( originalCatalog, current->testCatalog );                                     // save the original database so it can be restored later
 
         // Attempt to find something from an empty database
-        DB_attributes.testData.clear();
         auto groceryItem = db.find( "00014100072331" );
         affirm.is_equal( "Empty Database query - searching an empty database", nullptr, groceryItem );
 
+        std::swap( originalCatalog, current->testCatalog );                                     // restore the original database
+        groceryItem = nullptr;
+
+        // A version replaced by a reload is freed once no view refers to it, even though a thread that read it has gone idle
+        {
+          std::weak_ptr<VersionAttributes> replaced = current;
+          std::atomic<bool>                found    = false, done = false;
+          std::jthread idle( [&]
+          {
+            db.find( "00014100072331" );
+            found = true;
+            while( !done.load() ) std::this_thread::yield();
+          } );
+          while( !found.load() ) std::this_thread::yield();
+
+          affirm.is_true( "Database reload - idle readers don't keep old versions", !db.reload()  ||  replaced.expired() );
+          done = true;
+        }
+      }
+    }
 
-        DB_attributes.testData = { { "001", { "", "", "001" } }, { "002", { "", "", "002" } }, { "003", { "", "", "003" } } };
-        groceryItem    = db.find( "003" );
-        affirm.is_equal( "Database query - Searching for the last item", GroceryItem{ "", "", "003" }, *groceryItem );
+    {
+      // Hot reload:  a view found before the database is reloaded or changed keeps reading the version it was found in
+      auto before  = db.find( "00014100072331" );
+      auto version = db.version();
+      auto size    = db.size();
 
-        groceryItem = db.find( "001" );
-        affirm.is_equal( "Database query - Searching for the first item", GroceryItem{ "", "", "001" }, *groceryItem );
+      affirm.is_true ( "Database reload - reloads the file it was loaded from",    db.reload()                  );
+      affirm.is_equal( "Database reload - publishes a new version",               version + 1,   db.version()  );
+      affirm.is_equal( "Database reload - same contents",                         size,          db.size()     );
 
+      auto after = db.find( "00014100072331" );
+      affirm.is_true ( "Database reload - earlier views remain valid",            before == nullptr  ||  ( before != after  &&  before.productName() == after.productName() ) );
 
-        originalData.swap( DB_attributes.testData );                                            // restore the original database
+      // Readers looking grocery items up while reloads publish new versions always see a whole version, and never an older one
+      // than they've already seen
+      {
+        std::atomic<bool>     reloading = true;
+        std::atomic<unsigned> anomalies = 0;
+        {
+          std::vector<std::jthread> readers;
+          for( int i = 0; i < 4; ++i ) readers.emplace_back( [&]
+          {
+            for( std::uint64_t seen = 0; reloading.load(); )
+            {
+              auto number = db.version();
+              auto found  = db.find( "00014100072331" );
+              if( number < seen  ||  ( found == nullptr ) != ( before == nullptr ) ) anomalies.fetch_add( 1 );
+              seen = number;
+            }
+          } );
+
+          for( int i = 0; i < 3; ++i ) db.reload();
+          reloading = false;
+        }
+        affirm.is_equal( "Database reload - concurrent readers see whole versions", 0U,         anomalies.load() );
+        affirm.is_equal( "Database reload - every reload published",                version + 4, db.version()     );
       }
+
+      // One grocery item replaced and one added twice, the last change winning
+      const std::string changesFilename = "GroceryItemDatabaseTests-changes.dat";
+      std::ofstream( changesFilename ) << R"("00014100072331", "Pepperidge Farm", "Changed", 1.25)"                << '\n'
+                                       << R"("99999999999999", "Test Brand", "Added \"first\"", 2.50)"            << '\n'
+                                       << R"("99999999999999", "Test Brand", "Added second", 3.75)"               << '\n';
+
+      affirm.is_true ( "Database changes - applied",                              db.applyChanges( changesFilename ) );
+      affirm.is_equal( "Database changes - grocery item added",                   size + 1,      db.size()     );
+
+      auto added = db.find( "99999999999999" );
+      affirm.is_true ( "Database changes - last change to a UPC wins",            added != nullptr  &&  added.productName() == "Added second"  &&  added.price() == 3.75 );
+      affirm.is_true ( "Database changes - grocery item replaced",                before == nullptr  ||  db.find( "00014100072331" ).price() == 1.25 );
+      affirm.is_true ( "Database changes - earlier views unchanged",              before == nullptr  ||  before.price() == after.price() );
+
+      // Deletions, including one of a UPC not in the database, which changes nothing
+      std::ofstream( changesFilename ) << R"(- "99999999999999")" << '\n' << R"(  -"00014100072331")" << '\n' << R"(- "00000000000000")" << '\n';
+      affirm.is_true ( "Database changes - deletions applied",                    db.applyChanges( changesFilename ) );
+      affirm.is_equal( "Database changes - grocery items deleted",                before == nullptr  ?  size  :  size - 1,  db.size() );
+      affirm.is_true ( "Database changes - deleted grocery items not found",      db.find( "99999999999999" ) == nullptr  &&  db.find( "00014100072331" ) == nullptr );
+      affirm.is_true ( "Database changes - earlier views outlive deletions",      added.productName() == "Added second" );
+
+      std::ofstream( changesFilename ) << R"("00014100072331", "Pepperidge Farm", "Malformed")" << '\n';
+      version = db.version();
+      affirm.is_true ( "Database changes - malformed changes are not applied",    !db.applyChanges( changesFilename )  &&  db.version() == version );
+
+      std::filesystem::remove( changesFilename );
+      db.reload();                                                                              // put it back how you found it
+      affirm.is_equal( "Database reload - changes discarded",                     size,          db.size()     );
+    }
+
+    // The changes file and compaction, tried on a small database file of their own.  Compaction refreshes the snapshot, and the
+    // changes file may be someone's real changes, so this is skipped if either is present.
+    if( !databaseFilename.empty()  &&  !std::filesystem::exists( GroceryItemDatabase::SNAPSHOT_FILENAME )  &&  !std::filesystem::exists( GroceryItemDatabase::CHANGES_FILENAME ) )
+    {
+      const std::string compactFilename = "GroceryItemDatabaseTests-compact.dat";
+      std::ofstream( compactFilename )                       << R"("00000000000001", "Brand", "Kept", 1.00)"                 << '\n'
+                                                             << R"("00000000000002", "Brand", "Deleted", 2.00)"              << '\n';
+      std::ofstream( GroceryItemDatabase::CHANGES_FILENAME ) << R"(- "00000000000002")"                                     << '\n'
+                                                             << R"("00000000000003", "Other \"Brand\"", "Added", 3.00)"     << '\n';
+
+      affirm.is_true ( "Database changes file - replayed when loaded",            db.reload( compactFilename )  &&  db.size() == 2  &&  db.loadStatistics().changes == 2
+                                                                                  &&  db.find( "00000000000002" ) == nullptr  &&  db.find( "00000000000003" ) != nullptr );
+
+      // A change appended to the changes file since it was loaded is compacted too, but changes applied only in memory, from another
+      // file, are not
+      std::ofstream( GroceryItemDatabase::CHANGES_FILENAME, std::ios::app ) << R"("00000000000004", "Brand", "Appended", 4.00)" << '\n';
+      const std::string otherChangesFilename = "GroceryItemDatabaseTests-other-changes.dat";
+      std::ofstream( otherChangesFilename ) << R"("00000000000005", "Brand", "In memory only", 5.00)" << '\n';
+      db.applyChanges( otherChangesFilename );
+      std::filesystem::remove( otherChangesFilename );
+
+      affirm.is_true ( "Database compaction - changes file removed",              db.compact()  &&  !std::filesystem::exists( GroceryItemDatabase::CHANGES_FILENAME ) );
+
+      affirm.is_true ( "Database compaction - reloaded",                          db.reload()                  );
+      auto added = db.find( "00000000000003" );
+      affirm.is_true ( "Database compaction - changes folded into the file",      db.size() == 3  &&  db.loadStatistics().changes == 0  &&  db.find( "00000000000002" ) == nullptr
+                                                                                  &&  added != nullptr  &&  added.brandName() == "Other \"Brand\""  &&  added.price() == 3.00 );
+      affirm.is_true ( "Database compaction - appended changes kept",             db.find( "00000000000004" ) != nullptr );
+      affirm.is_true ( "Database compaction - in-memory changes not kept",        db.find( "00000000000005" ) == nullptr );
+
+      std::filesystem::remove( compactFilename );
+      db.reload( databaseFilename );                                                            // put it back how you found it
+      affirm.is_equal( "Database compaction - original database restored",       expectedSize,  db.size()     );
     }
   }
 
@@ -0,0 +1,165 @@
+#include <cstddef>                                                                          // size_t
+#include <exception>
+#include <iomanip>                                                                          // setprecision()
+#include <iostream>                                                                         // boolalpha(), showpoint(), fixed(), clog
+#include <random>                                                                           // mt19937
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CheckResults.hpp"
+#include "GroceryItemScanner.hpp"
+
+
+
+
+namespace  // anonymous
+{
+  class GroceryItemScannerRegressionTest
+  {
+    public:
+      GroceryItemScannerRegressionTest();
+
+    private:
+      void structurals();
+      void seeking();
+      void countingQuotes();
+
+      Regression::CheckResults affirm;
+  } run_groceryItemScanner_tests;
+
+
+
+
+  constexpr GroceryItemScanner::InstructionSet INSTRUCTION_SETS[] = { GroceryItemScanner::InstructionSet::SCALAR,
+                                                                      GroceryItemScanner::InstructionSet::SSE2,
+                                                                      GroceryItemScanner::InstructionSet::AVX2 };
+
+  // The structural characters found one character at a time, the way std::quoted() would see them
+  std::vector<std::size_t> expectedStructurals( std::string_view text )
+  {
+    std::vector<std::size_t> result;
+    bool escaped = false, inField = false;
+    for( std::size_t i = 0; i < text.size(); ++i )
+    {
+      if( escaped )
+      {
+        escaped = false;
+        continue;
+      }
+
+      if     ( text[i] == '\\' )                            escaped = true;
+      else if( text[i] == '"'  )                            inField = !inField;
+      else if( inField  ||  ( text[i] != ',' && text[i] != '\n' ) ) continue;
+
+      result.push_back( i );
+    }
+    return result;
+  }
+
+  std::vector<std::size_t> actualStructurals( std::string_view text, GroceryItemScanner::InstructionSet instructionSet )
+  {
+    std::vector<std::size_t> result;
+    GroceryItemScanner       scanner( text, instructionSet );
+    for( auto offset = scanner.next(); offset != GroceryItemScanner::npos; offset = scanner.next() ) result.push_back( offset );
+    return result;
+  }
+
+  // Text made mostly of the characters of interest, so runs of backslashes and quoted fields regularly straddle block boundaries
+  std::string randomText( std::size_t size, unsigned seed )
+  {
+    constexpr char alphabet[] = "\"\\,\na \"\\";
+
+    std::mt19937 generator( seed );
+    std::string  text( size, ' ' );
+    for( auto & c : text ) c = alphabet[generator() % ( sizeof( alphabet ) - 1 )];
+    return text;
+  }
+
+
+
+
+  void GroceryItemScannerRegressionTest::structurals()
+  {
+    std::string_view record = R"("00075457129000","Kellogg's \"Rice\", \\Krispies\\","cereal, 12 oz",2.29)" "\n";
+    std::vector<std::size_t> recordStructurals = { 0, 15, 16, 17, 28, 34, 38, 48, 50, 51, 52, 66, 67, 72 };
+    affirm.is_true( "Structurals of one record                        ", expectedStructurals( record ) == recordStructurals );
+
+    // A backslash ending one block escapes the quote starting the next, and a quoted field spanning blocks hides its commas
+    std::string straddling = std::string( 63, 'a' ) + R"(\"a,"b,)" + std::string( 60, ',' ) + "c\",\\";
+
+    for( auto instructionSet : INSTRUCTION_SETS )
+    {
+      bool agree = actualStructurals( record, instructionSet ) == recordStructurals
+               &&  actualStructurals( straddling, instructionSet ) == expectedStructurals( straddling )
+               &&  actualStructurals( "", instructionSet ).empty();
+
+      for( unsigned seed = 1; seed <= 20; ++seed )
+      {
+        auto text = randomText( 1'000 + seed, seed );
+        agree = agree  &&  actualStructurals( text, instructionSet ) == expectedStructurals( text );
+      }
+      affirm.is_true( "Instruction set agrees with the reference        ", agree );
+    }
+  }
+
+
+
+
+  void GroceryItemScannerRegressionTest::seeking()
+  {
+    // Resuming part way through, at the start of a record in a later block, forgets everything carried from before
+    std::string text   = std::string( 70, '\\' ) + "\"a,\n" + R"("b,c",d)";
+    auto        resume = text.find( "\"b" );
+
+    GroceryItemScanner scanner( text );
+    scanner.next();
+    scanner.seek( resume );
+
+    std::vector<std::size_t> actual;
+    for( auto offset = scanner.next(); offset != GroceryItemScanner::npos; offset = scanner.next() ) actual.push_back( offset );
+
+    std::vector<std::size_t> expected;
+    for( auto offset : expectedStructurals( std::string_view( text ).substr( resume ) ) ) expected.push_back( resume + offset );
+    affirm.is_true( "Seeking resumes scanning at the offset            ", actual == expected );
+  }
+
+
+
+
+  void GroceryItemScannerRegressionTest::countingQuotes()
+  {
+    auto text = randomText( 10'000, 42 );
+
+    std::size_t expected = 0;
+    for( auto offset : expectedStructurals( text ) ) if( text[offset] == '"' ) ++expected;
+
+    for( auto instructionSet : INSTRUCTION_SETS )
+    {
+      affirm.is_equal( "Unescaped quotes counted                         ", expected, GroceryItemScanner::countQuotes( text, instructionSet ) );
+    }
+  }
+
+
+
+
+  GroceryItemScannerRegressionTest::GroceryItemScannerRegressionTest()
+  {
+    std::clog << std::boolalpha << std::showpoint << std::fixed << std::setprecision( 2 );
+
+    try
+    {
+      std::clog << "\n\n\nGroceryItemScanner Regression Test:\n";
+      structurals();
+      seeking();
+      countingQuotes();
+
+      std::clog << "\n\nGroceryItemScanner Regression Test " << affirm << "\n\n";
+    }
+    catch( const std::exception & ex )
+    {
+      std::clog << "FAILURE:  Regression test for \"class GroceryItemScanner\" failed with an unhandled exception. \n\n\n"
+                << ex.what() << std::endl;
+    }
+  }
+} // namespace
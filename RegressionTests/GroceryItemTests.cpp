@@ -1,4 +1,3 @@
-#include <cmath>                                                                            // abs(), ceil(), log10()
 #include <exception>
 #include <iomanip>                                                                          // setprecision()
 #include <iostream>                                                                         // boolalpha(), showpoint(), fixed(), clog, ios, streamsize
@@ -7,13 +6,14 @@
 
 #include "RegressionTests/CheckResults.hpp"
 #include "GroceryItem.hpp"
+#include "Money.hpp"
 
 
 
 
 namespace  // anonymous
 {
-  constexpr auto EPSILON = 1E-4;
+  constexpr auto CENT = Money::fromCents( 1 );
 
   class GroceryItemRegressionTest
   {
@@ -59,7 +59,7 @@ namespace  // anonymous
            gItem2.productName() == "grocery item's product name"
         && gItem3.productName() == "grocery item's product name" && gItem3.brandName() == "grocery item's brand name"
         && gItem4.productName() == "grocery item's product name" && gItem4.brandName() == "grocery item's brand name" && gItem4.upcCode() == "grocery item's UPC code"
-        && gItem5.productName() == "grocery item's product name" && gItem5.brandName() == "grocery item's brand name" && gItem5.upcCode() == "grocery item's UPC code" && std::abs(gItem5.price() - 123.79) < EPSILON
+        && gItem5.productName() == "grocery item's product name" && gItem5.brandName() == "grocery item's brand name" && gItem5.upcCode() == "grocery item's UPC code" && gItem5.price() == 123.79
      );
 
     GroceryItem gItem6( gItem5 );
@@ -68,7 +68,7 @@ namespace  // anonymous
           gItem6.productName() ==  gItem5.productName()
        && gItem6.brandName()   ==  gItem5.brandName()
        && gItem6.upcCode()     ==  gItem5.upcCode()
-       && std::abs(gItem6.price() - gItem5.price()) < EPSILON
+       && gItem6.price()       ==  gItem5.price()
     );
 
     GroceryItem gItem7( std::move(gItem6) );
@@ -81,7 +81,7 @@ namespace  // anonymous
           gItem6.productName() ==  gItem5.productName()
        && gItem6.brandName()   ==  gItem5.brandName()
        && gItem6.upcCode()     ==  gItem5.upcCode()
-       && std::abs(gItem6.price() - gItem5.price()) < EPSILON
+       && gItem6.price()       ==  gItem5.price()
     );
 
 
@@ -159,14 +159,14 @@ namespace  // anonymous
     // Be careful - using affirm.xxx() may hide the class-under-test overloaded operators.  But affirm.is_true() doesn't provide as
     // much information when the test fails.
     affirm.is_equal    ( "Equality test - is equal                          ", less, more );
-    affirm.is_equal    ( "Equality test - floating point lower limit        ", less, GroceryItem {"a1", "a1", "a1", less.price() - EPSILON} );
-    affirm.is_equal    ( "Equality test - floating point upper limit        ", less, GroceryItem {"a1", "a1", "a1", less.price() + EPSILON} );
+    affirm.is_equal    ( "Equality test - price rounded up to the cent      ", less, GroceryItem {"a1", "a1", "a1", 9.996 } );
+    affirm.is_equal    ( "Equality test - price rounded down to the cent    ", less, GroceryItem {"a1", "a1", "a1", 10.004} );
 
     affirm.is_not_equal( "Inequality Product Name test                      ", less, GroceryItem {"b1", "a1", "a1", 10.0} );
     affirm.is_not_equal( "Inequality Brand Name test                        ", less, GroceryItem {"a1", "b1", "a1", 10.0} );
     affirm.is_not_equal( "Inequality UPC test                               ", less, GroceryItem {"a1", "a1", "b1", 10.0} );
-    affirm.is_not_equal( "Inequality Price test - lower limit               ", less, GroceryItem {"a1", "a1", "a1", less.price() - ( 2 * EPSILON )} );
-    affirm.is_not_equal( "Inequality Price test - upper limit               ", less, GroceryItem {"a1", "a1", "a1", less.price() + ( 2 * EPSILON )} );
+    affirm.is_not_equal( "Inequality Price test - lower limit               ", less, GroceryItem {"a1", "a1", "a1", less.price() - CENT} );
+    affirm.is_not_equal( "Inequality Price test - upper limit               ", less, GroceryItem {"a1", "a1", "a1", less.price() + CENT} );
 
 
     auto check = [&]()
@@ -258,9 +258,7 @@ namespace  // anonymous
       construction();
 
       std::clog << "\nGroceryItem Regression Test:  Relational comparisons\n";
-      auto previousPrecision = std::clog.precision( static_cast<std::streamsize>( std::ceil( -std::log10( EPSILON ) ) ) );
       comparison();
-      std::clog.precision( previousPrecision );
 
       std::clog << "\nGroceryItem Regression Test:  Input/Output\n";
       io ();
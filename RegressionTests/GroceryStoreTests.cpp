@@ -1,10 +1,23 @@
 #include <exception>
+#include <filesystem>                                                       // copy_file(), remove()
+#include <fstream>                                                          // ofstream
 #include <iomanip>                                                          // setprecision()
 #include <iostream>                                                         // boolalpha(), showpoint(), fixed(), endl()
+#include <map>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "CheckResults.hpp"
+#include "GroceryItemDatabase.hpp"
 #include "GroceryStore.hpp"
+#include "Inventory.hpp"
+#include "InventoryJournal.hpp"
+#include "InventoryLoader.hpp"
+#include "Money.hpp"
+#include "ReorderScheduler.hpp"
+#include "ShoppingCart.hpp"
+#include "Upc.hpp"
 
 
 
@@ -48,12 +61,19 @@ namespace  // anonymous
       void test_2( const GroceryStore::Inventory_DB & inventory );
       void test_3( const GroceryStore::Inventory_DB & inventory );
       void test_4( const GroceryStore::GroceryItemsSold & soldGroceryItems, const GroceryStore::Inventory_DB & inventory );
+      void test_5();
+      void test_6();
+      void test_7();
+      void test_8();
+      void test_9();
 
-      void validate( const GroceryStore::Inventory_DB & inventory, const GroceryStore::Inventory_DB & pairs );
+      using ExpectedInventory = std::map<Upc, unsigned int>;
+
+      void validate( const GroceryStore::Inventory_DB & inventory, const ExpectedInventory & pairs );
 
       Regression::CheckResults affirm;
 
-      GroceryStore::Inventory_DB expectedValues =
+      ExpectedInventory expectedValues =
       {
         // "Red Baron"
         {"00075457129000", 10}, {"00038000291210", 23}, {"00025317533003",  9}, //{"09073649000493",  5},
@@ -127,6 +147,12 @@ namespace  // anonymous
       theStore.reorderItems( groceryItemsSold );
       test_3( inventory );
 
+      test_5();
+      test_6();
+      test_7();
+      test_8();
+      test_9();
+
       std::clog << "\n\nGroceryStore Regression Test " << affirm << "\n\n";
     }
 
@@ -145,12 +171,12 @@ namespace  // anonymous
 
 
 
-  void GroceryStoreRegressionTest::validate( const GroceryStore::Inventory_DB & actualInventory, const GroceryStore::Inventory_DB & expectedInventory )
+  void GroceryStoreRegressionTest::validate( const GroceryStore::Inventory_DB & actualInventory, const ExpectedInventory & expectedInventory )
   {
     bool allPassed = true;
     for( const auto & [expectedUpc, expectedQuantity] : expectedInventory )  if( actualInventory.at( expectedUpc ) != expectedQuantity )
     {
-      affirm.is_equal( "Inventory item \"" + expectedUpc + "\" quantity", expectedQuantity, actualInventory.at( expectedUpc ) );
+      affirm.is_equal( "Inventory item \"" + expectedUpc.to_string() + "\" quantity", expectedQuantity, actualInventory.at( expectedUpc ) );
       allPassed = false;
     }
 
@@ -218,9 +244,9 @@ namespace  // anonymous
     auto         shoppingCarts = theStore.makeShoppingCarts();
 
     GroceryStore::GroceryItemsSold expectedList;
-    for( auto & [name, cart] : shoppingCarts ) for( auto & [upc, groceryItem] : cart)
+    for( auto & [name, cart] : shoppingCarts ) for( const auto & upc : cart.upcs() )
     {
-      if( inventory.find(upc) != inventory.end() )  expectedList.insert( upc );
+      if( inventory.contains(upc) )  expectedList.insert( upc );
     }
 
     affirm.is_equal( "Items sold today - size",    expectedList.size(), soldGroceryItems.size() );
@@ -239,4 +265,162 @@ namespace  // anonymous
     affirm.is_true( "Items to reorder - content", expectedGroceryItemsToReorder == groceryItemsToReorder );
   }
 
+
+
+
+
+
+  void GroceryStoreRegressionTest::test_5()
+  {
+    // Ringing up customers on several lanes at once must be indistinguishable from ringing them up one at a time
+    GroceryStore serialStore, concurrentStore;
+    auto         shoppingCarts = serialStore.makeShoppingCarts();
+
+    std::ostringstream serialReceipts, concurrentReceipts;
+    serialReceipts    .copyfmt( std::cout );
+    concurrentReceipts.copyfmt( std::cout );
+
+    auto serialSales     = serialStore    .ringUpCustomers( shoppingCarts, serialReceipts        );
+    auto concurrentSales = concurrentStore.ringUpCustomers( shoppingCarts, concurrentReceipts, 4 );
+
+    affirm.is_true ( "Concurrent checkout - same receipts, in customer order", serialReceipts.str() == concurrentReceipts.str() );
+    affirm.is_true ( "Concurrent checkout - same grocery items sold",         serialSales          == concurrentSales          );
+    affirm.is_true ( "Concurrent checkout - same closing inventory",          serialStore.inventory() == concurrentStore.inventory() );
+  }
+
+
+
+
+
+
+  void GroceryStoreRegressionTest::test_6()
+  {
+    // A durable store, working from its own copy of the inventory file, reopens with the inventory it closed with
+    const std::string inventoryFilename = "GroceryStoreTests-inventory.dat";
+    std::filesystem::copy_file( "GroceryStoreInventory.dat", inventoryFilename, std::filesystem::copy_options::overwrite_existing );
+
+    std::vector<Inventory::Item> closingInventory;
+    {
+      GroceryStore       store( inventoryFilename, MergePolicy::FIRST_WINS, Durability::JOURNALED );
+      std::ostringstream receipts, reorders;
+      auto               sold = store.ringUpCustomers( store.makeShoppingCarts(), receipts, 4 );
+      store.inventory().erase( "00041331092609" );
+      store.reorderItems( sold, reorders );
+      closingInventory = store.inventory().snapshot();
+    }
+
+    GroceryStore reopened( inventoryFilename, MergePolicy::FIRST_WINS, Durability::JOURNALED );
+    affirm.is_true ( "Durable store - inventory survives a restart",          reopened.inventory().snapshot() == closingInventory );
+
+    for( const auto & filename : { inventoryFilename, InventoryJournal::logFilename( inventoryFilename ), InventoryJournal::retiredLogFilename( inventoryFilename ) } )
+    {
+      std::filesystem::remove( filename );
+    }
+  }
+
+
+
+
+
+
+  void GroceryStoreRegressionTest::test_7()
+  {
+    // Re-ordering reports, in UPC order, the grocery items sold that the store no longer carries and those below the re-order
+    // threshold, restocking the latter.  Grocery items no longer in the database are shown by their UPC alone.
+    const std::string inventoryFilename = "GroceryStoreTests-reorder.dat";
+    std::ofstream( inventoryFilename ) << "00025317533003   8\n00038000291210   23\n00000000000042   3\n";
+
+    GroceryStore                   store( inventoryFilename );
+    GroceryStore::GroceryItemsSold sold = { "00000000000001", "00000000000042", "00025317533003", "00038000291210", "00041331092609" };
+    std::ostringstream             report;
+    store.reorderItems( sold, report );
+    std::filesystem::remove( inventoryFilename );
+
+    auto describe = []( const Upc & upc )
+    {
+      std::ostringstream description;
+      auto               groceryItem = GroceryItemDatabase::instance().find( upc );
+      if( groceryItem == nullptr ) description << std::quoted( upc.to_string() );
+      else                         description << groceryItem;
+      return description.str();
+    };
+
+    auto expected = "Re-Ordering grocery items the store is running low on\n\n"
+                    "1: {" + describe( "00000000000001" ) + "}\n *** no longer sold in this store and will not be re-ordered\n\n"
+                    "2: {" + describe( "00000000000042" ) + "}\n only 3 remain in stock which is 12 unit(s) below reorder threshold (15), re-ordering 20 more\n\n"
+                    "3: {" + describe( "00025317533003" ) + "}\n only 8 remain in stock which is 7 unit(s) below reorder threshold (15), re-ordering 20 more\n\n"
+                    "4: {" + describe( "00041331092609" ) + "}\n *** no longer sold in this store and will not be re-ordered\n\n";
+
+    affirm.is_equal( "Reorder - report",                                       expected,           report.str() );
+    affirm.is_true ( "Reorder - grocery items below the threshold restocked",  store.inventory().at( "00000000000042" ) == 23  &&  store.inventory().at( "00025317533003" ) == 28 );
+    affirm.is_equal( "Reorder - grocery items above the threshold untouched",  23U,                store.inventory().at( "00038000291210" ) );
+    affirm.is_true ( "Reorder - grocery items sold cleared",                   sold.empty() );
+  }
+
+
+
+
+
+
+  void GroceryStoreRegressionTest::test_8()
+  {
+    // A store replenishing continuously re-orders grocery items in the background as they're sold below the threshold, so by the
+    // end of the day there's nothing left to re-order
+    GroceryStore                                 store;
+    std::vector<ReorderScheduler::PurchaseOrder> orders;
+    store.replenishContinuously( ReorderScheduler::DEFAULT_CADENCE, [&orders]( const ReorderScheduler::PurchaseOrder & order ) { orders.push_back( order ); } );
+
+    std::ostringstream receipts, report;
+    auto               sold = store.ringUpCustomers( store.makeShoppingCarts(), receipts, 4 );
+    store.reorderItems( sold, report );
+
+    auto statistics = store.replenishmentStatistics();
+    affirm.is_true ( "Replenishment - nothing left to re-order at close", report.str().find( "re-ordering" ) == std::string::npos );
+    affirm.is_true ( "Replenishment - purchase orders placed",           !orders.empty()  &&  statistics.purchaseOrders == orders.size() );
+    affirm.is_equal( "Replenishment - sold below the threshold, restocked", 28U,              store.inventory().at( "00025317533003" ) );
+  }
+
+
+
+
+
+
+  void GroceryStoreRegressionTest::test_9()
+  {
+    // Each line of a cart is charged and taken from inventory by its quantity.  A line for more units than the inventory shows is
+    // still sold in full, the units are in the customer's cart, and the inventory stops at zero.  "00000000000000" is never in the
+    // database, and is free.
+    const std::string inventoryFilename = "GroceryStoreTests-quantities.dat";
+    std::ofstream( inventoryFilename ) << "00025317533003   8\n00038000291210   23\n";
+
+    GroceryStore                store( inventoryFilename );
+    GroceryStore::ShoppingCarts carts = { { "Bulk Buyer", { { "00025317533003", "hotdogs", 12 }, { "00038000291210", "", 3 }, { "00000000000000", "mystery", 5 } } } };
+    std::ostringstream          receipts;
+    auto                        sold = store.ringUpCustomers( carts, receipts );
+    std::filesystem::remove( inventoryFilename );
+
+    Money              total;
+    std::ostringstream expected;
+    expected << "Bulk Buyer's shopping cart contains:\n"
+             << "  \"00000000000000\" (mystery) not found, the item is free!\n";
+    for( const auto & [upc, quantity] : carts.begin()->second )
+    {
+      if( upc == Upc( "00000000000000" ) ) continue;
+
+      auto groceryItem = GroceryItemDatabase::instance().find( upc );
+      if( groceryItem == nullptr )
+      {
+        expected << "  " << std::quoted( upc.to_string() ) << " (" << carts.begin()->second.label( upc ) << ") not found, the item is free!\n";
+        continue;
+      }
+      expected << "  " << groceryItem << " x " << quantity << " = " << groceryItem.price() * quantity << '\n';
+      total += groceryItem.price() * quantity;
+    }
+    expected << "-------------------------\nTotal $" << total << "\n\n";
+
+    affirm.is_equal( "Quantities - receipt",                                  expected.str(), receipts.str() );
+    affirm.is_equal( "Quantities - inventory taken by quantity",              20U,            store.inventory().at( "00038000291210" ) );
+    affirm.is_equal( "Quantities - more than in stock stops at zero",         0U,             store.inventory().at( "00025317533003" ) );
+    affirm.is_true ( "Quantities - grocery items sold",                       sold == GroceryStore::GroceryItemsSold{ "00025317533003", "00038000291210" } );
+  }
 } // namespace
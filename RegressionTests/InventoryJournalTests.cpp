@@ -0,0 +1,296 @@
+#include <cstddef>                                                                          // size_t
+#include <cstdint>                                                                          // uintmax_t
+#include <exception>
+#include <filesystem>                                                                       // exists(), file_size(), remove(), rename()
+#include <fstream>                                                                          // ifstream, ofstream
+#include <iomanip>                                                                          // setprecision()
+#include <iostream>                                                                         // boolalpha(), showpoint(), fixed(), clog
+#include <optional>
+#include <sstream>                                                                          // ostringstream
+#include <string>
+#include <thread>                                                                           // jthread
+#include <vector>
+
+#include <fcntl.h>                                                                          // open()
+#include <unistd.h>                                                                         // dup2(), close()
+
+#include "RegressionTests/CheckResults.hpp"
+#include "Inventory.hpp"
+#include "InventoryJournal.hpp"
+#include "InventoryLoader.hpp"
+#include "Upc.hpp"
+
+
+
+
+namespace  // anonymous
+{
+  const std::string INVENTORY_FILENAME = "InventoryJournalTests.dat";         // Defined before the test object, which uses it as it's constructed
+
+
+
+  class InventoryJournalRegressionTest
+  {
+    public:
+      InventoryJournalRegressionTest();
+
+    private:
+      void replaying();
+      void tornWrites();
+      void failedWrites();
+      void checkpoints();
+      void groupCommit();
+
+      Regression::CheckResults affirm;
+  } run_inventoryJournal_tests;
+
+
+
+
+  void removeFiles()
+  {
+    for( const auto & filename : { INVENTORY_FILENAME, InventoryJournal::logFilename( INVENTORY_FILENAME ), InventoryJournal::retiredLogFilename( INVENTORY_FILENAME ) } )
+    {
+      std::filesystem::remove( filename );
+    }
+  }
+
+  void writeInventoryFile()
+  {
+    removeFiles();
+    std::ofstream( INVENTORY_FILENAME ) << "00000000000001   10\n\"00000000000002\" 20\n00000000000003   30\n";
+  }
+
+  // What a store starting up would have:  the inventory file, brought up to date from the log
+  Inventory recover( std::ostream & diagnostics = std::clog )
+  {
+    std::ifstream file( INVENTORY_FILENAME );
+    auto inventory = loadInventory( file, INVENTORY_FILENAME ).inventory;
+    InventoryJournal::replay( inventory, INVENTORY_FILENAME, diagnostics );
+    return inventory;
+  }
+
+  // Swaps the descriptor this process has the log open with for one that can only read it, so writing to it fails
+  void breakLog()
+  {
+    auto log      = std::filesystem::absolute( InventoryJournal::logFilename( INVENTORY_FILENAME ) );
+    int  readOnly = ::open( log.c_str(), O_RDONLY | O_CLOEXEC );
+    for( const auto & entry : std::filesystem::directory_iterator( "/proc/self/fd" ) )
+    {
+      std::error_code error;
+      if( std::filesystem::read_symlink( entry.path(), error ) == log ) ::dup2( readOnly, std::stoi( entry.path().filename().string() ) );
+    }
+    ::close( readOnly );
+  }
+
+  // An inventory loaded from the inventory file whose changes are journaled
+  struct Journaled
+  {
+    Journaled( std::size_t checkpointInterval = InventoryJournal::DEFAULT_CHECKPOINT_INTERVAL )
+      : inventory( recover() ),
+        journal  ( INVENTORY_FILENAME, checkpointInterval )
+    { inventory.observe( [this]( const Upc & upc, std::optional<Inventory::Quantity> quantity ) { journal.append( upc, quantity ); } ); }
+
+    Inventory        inventory;
+    InventoryJournal journal;
+  };
+
+
+
+
+  void InventoryJournalRegressionTest::replaying()
+  {
+    writeInventoryFile();
+    {
+      Journaled store;
+      store.inventory.decrementIfAvailable( "00000000000001" );
+      store.inventory.restock             ( "00000000000002", 5 );
+      store.inventory.erase               ( "00000000000003" );
+      store.inventory.decrementIfAvailable( "00000000000001" );
+      store.journal.commit();
+
+      std::ifstream file( INVENTORY_FILENAME );
+      affirm.is_equal( "Replay - log holds every change                   ", std::uintmax_t{ 4 * 16 }, std::filesystem::file_size( InventoryJournal::logFilename( INVENTORY_FILENAME ) ) );
+      affirm.is_equal( "Replay - inventory file untouched until checkpoint", 10U, loadInventory( file, INVENTORY_FILENAME ).inventory.at( "00000000000001" ) );
+    }
+
+    auto recovered = recover();
+    affirm.is_true ( "Replay - changes survive a restart                ", recovered.snapshot() == std::vector<Inventory::Item>{ { "00000000000001", 8 }, { "00000000000002", 25 } } );
+
+    Inventory untouched;
+    {
+      std::ifstream file( INVENTORY_FILENAME );
+      untouched = loadInventory( file, INVENTORY_FILENAME ).inventory;
+    }
+    affirm.is_equal( "Replay - replaying again changes nothing more     ", std::size_t{ 4 }, InventoryJournal::replay( untouched, INVENTORY_FILENAME ) );
+    affirm.is_true ( "Replay - same result every time                   ", untouched == recovered );
+
+    // Changes are buffered in memory until committed, and the journal commits whatever is left when it's destroyed
+    {
+      Journaled store;
+      store.inventory.restock( "00000000000001", 1 );
+    }
+    affirm.is_equal( "Replay - destroying the journal commits           ", 9U, recover().at( "00000000000001" ) );
+    removeFiles();
+  }
+
+
+
+
+  void InventoryJournalRegressionTest::tornWrites()
+  {
+    // A crash part way through writing a change leaves a fragment at the end of the log, which is ignored and cut off so that changes
+    // appended afterwards are replayed
+    writeInventoryFile();
+    {
+      Journaled store;
+      store.inventory.decrementIfAvailable( "00000000000002" );
+    }
+    std::ofstream( InventoryJournal::logFilename( INVENTORY_FILENAME ), std::ios::binary | std::ios::app ) << "partial";
+
+    std::ostringstream diagnostics;
+    affirm.is_equal( "Torn write - fragment ignored                     ", 19U, recover( diagnostics ).at( "00000000000002" ) );
+    affirm.is_true ( "Torn write - reported                             ", diagnostics.str().find( "7 byte(s)" ) != std::string::npos );
+    affirm.is_equal( "Torn write - log cut back to the last change      ", std::uintmax_t{ 16 }, std::filesystem::file_size( InventoryJournal::logFilename( INVENTORY_FILENAME ) ) );
+
+    {
+      Journaled store;
+      store.inventory.decrementIfAvailable( "00000000000002" );
+    }
+    affirm.is_equal( "Torn write - later changes replayed               ", 18U, recover().at( "00000000000002" ) );
+
+    // Zeros where a change should be, as a crash can leave when the log grew but its contents never reached the disk
+    std::ofstream( InventoryJournal::logFilename( INVENTORY_FILENAME ), std::ios::binary | std::ios::app ) << std::string( 16, '\0' );
+    affirm.is_equal( "Torn write - unwritten change ignored             ", 18U, recover( diagnostics ).at( "00000000000002" ) );
+    removeFiles();
+  }
+
+
+
+
+  void InventoryJournalRegressionTest::failedWrites()
+  {
+    // A write that fails, here after part of a change already reached the log, leaves the log as it was before the write and is
+    // reported, and its changes are written by the next commit ahead of the changes made since
+    writeInventoryFile();
+    {
+      Journaled store;
+      store.inventory.decrementIfAvailable( "00000000000001" );
+      affirm.is_true ( "Failed write - committed before the failure       ", store.journal.commit() );
+
+      std::ofstream( InventoryJournal::logFilename( INVENTORY_FILENAME ), std::ios::binary | std::ios::app ) << "partial";
+      breakLog();
+      store.inventory.decrementIfAvailable( "00000000000002" );
+      affirm.is_true ( "Failed write - reported                           ", !store.journal.commit() );
+      affirm.is_equal( "Failed write - log cut back to the last change    ", std::uintmax_t{ 16 }, std::filesystem::file_size( InventoryJournal::logFilename( INVENTORY_FILENAME ) ) );
+
+      store.inventory.decrementIfAvailable( "00000000000003" );
+      affirm.is_true ( "Failed write - later commit succeeds              ", store.journal.commit() );
+    }
+
+    std::ostringstream diagnostics;
+    affirm.is_true ( "Failed write - every change replayed              ", recover( diagnostics ).snapshot() == std::vector<Inventory::Item>{ { "00000000000001", 9 }, { "00000000000002", 19 }, { "00000000000003", 29 } } );
+    affirm.is_true ( "Failed write - nothing partly written left        ", diagnostics.str().empty() );
+    removeFiles();
+  }
+
+
+
+
+  void InventoryJournalRegressionTest::checkpoints()
+  {
+    writeInventoryFile();
+    {
+      Journaled store( 3 );
+      store.inventory.decrementIfAvailable( "00000000000001" );
+      store.inventory.erase               ( "00000000000002" );
+      affirm.is_true ( "Checkpoint - not due before the interval          ", !store.journal.checkpointDue() );
+
+      store.inventory.restock( "00000000000003", 3 );
+      affirm.is_true ( "Checkpoint - due after the interval               ", store.journal.checkpointDue() );
+      affirm.is_true ( "Checkpoint - written                              ", store.journal.checkpoint( store.inventory ) );
+      affirm.is_true ( "Checkpoint - no longer due                        ", !store.journal.checkpointDue() );
+
+      std::ifstream file( INVENTORY_FILENAME );
+      affirm.is_true ( "Checkpoint - inventory file rewritten             ", loadInventory( file, INVENTORY_FILENAME ).inventory == store.inventory );
+      affirm.is_equal( "Checkpoint - log emptied                          ", std::uintmax_t{ 0 }, std::filesystem::file_size( InventoryJournal::logFilename( INVENTORY_FILENAME ) ) );
+      affirm.is_true ( "Checkpoint - log set aside is removed             ", !std::filesystem::exists( InventoryJournal::retiredLogFilename( INVENTORY_FILENAME ) ) );
+
+      store.inventory.decrementIfAvailable( "00000000000003" );
+    }
+    affirm.is_true ( "Checkpoint - then the log tail                    ", recover().snapshot() == std::vector<Inventory::Item>{ { "00000000000001", 9 }, { "00000000000003", 32 } } );
+
+    // A checkpoint that stopped after setting the log aside leaves two logs, both replayed, oldest first
+    writeInventoryFile();
+    {
+      Journaled store;
+      store.inventory.decrementIfAvailable( "00000000000001" );
+      store.inventory.decrementIfAvailable( "00000000000002" );
+    }
+    std::filesystem::rename( InventoryJournal::logFilename( INVENTORY_FILENAME ), InventoryJournal::retiredLogFilename( INVENTORY_FILENAME ) );
+    {
+      Journaled store;
+      store.inventory.restock( "00000000000001", 1 );
+      affirm.is_true ( "Checkpoint - after an unfinished one              ", store.journal.checkpoint( store.inventory ) );
+    }
+    affirm.is_true ( "Checkpoint - both logs replayed in order          ", recover().snapshot() == std::vector<Inventory::Item>{ { "00000000000001", 10 }, { "00000000000002", 19 }, { "00000000000003", 30 } } );
+    removeFiles();
+  }
+
+
+
+
+  void InventoryJournalRegressionTest::groupCommit()
+  {
+    // Lanes committing after every sale share writes to disk, and every sale is replayed
+    constexpr unsigned LANES = 4, SALES_PER_LANE = 250;
+
+    removeFiles();
+    std::ofstream( INVENTORY_FILENAME ) << "00000000000001   10000\n";
+    {
+      Journaled store;
+      {
+        std::vector<std::jthread> lanes;
+        for( unsigned lane = 0; lane < LANES; ++lane ) lanes.emplace_back( [&store]
+        {
+          for( unsigned sale = 0; sale < SALES_PER_LANE; ++sale )
+          {
+            store.inventory.decrementIfAvailable( "00000000000001" );
+            store.journal.commit();
+          }
+        } );
+      }
+
+      auto statistics = store.journal.statistics();
+      affirm.is_equal( "Group commit - every change logged                ", std::size_t{ LANES * SALES_PER_LANE }, statistics.changes );
+      affirm.is_true ( "Group commit - never more syncs than changes      ", statistics.syncs <= statistics.changes );
+    }
+    affirm.is_equal( "Group commit - every sale recovered               ", 10'000U - LANES * SALES_PER_LANE, recover().at( "00000000000001" ) );
+    removeFiles();
+  }
+
+
+
+
+  InventoryJournalRegressionTest::InventoryJournalRegressionTest()
+  {
+    std::clog << std::boolalpha << std::showpoint << std::fixed << std::setprecision( 2 );
+
+    try
+    {
+      std::clog << "\n\n\nInventoryJournal Regression Test:\n";
+      replaying();
+      tornWrites();
+      failedWrites();
+      checkpoints();
+      groupCommit();
+
+      std::clog << "\n\nInventoryJournal Regression Test " << affirm << "\n\n";
+    }
+    catch( const std::exception & ex )
+    {
+      std::clog << "FAILURE:  Regression test for \"class InventoryJournal\" failed with an unhandled exception. \n\n\n"
+                << ex.what() << std::endl;
+    }
+  }
+} // namespace
@@ -0,0 +1,226 @@
+#include <cstddef>                                                                          // size_t
+#include <exception>
+#include <iomanip>                                                                          // setprecision()
+#include <iostream>                                                                         // boolalpha(), showpoint(), fixed(), clog
+#include <optional>
+#include <sstream>                                                                          // istringstream, ostringstream
+#include <stdexcept>                                                                        // out_of_range
+#include <string>
+#include <thread>                                                                           // jthread
+#include <utility>                                                                          // pair
+#include <vector>
+
+#include "RegressionTests/CheckResults.hpp"
+#include "Inventory.hpp"
+#include "InventoryLoader.hpp"
+#include "Upc.hpp"
+
+
+
+
+namespace  // anonymous
+{
+  class InventoryRegressionTest
+  {
+    public:
+      InventoryRegressionTest();
+
+    private:
+      void construction();
+      void modifiers();
+      void concurrency();
+      void loading();
+      void merging();
+
+      Regression::CheckResults affirm;
+  } run_inventory_tests;
+
+
+
+
+  void InventoryRegressionTest::construction()
+  {
+    Inventory inventory( { { "00000000000003", 30 }, { "00000000000001", 10 }, { "00000000000002", 20 }, { "00000000000001", 99 } } );
+
+    affirm.is_equal( "Construction - duplicates collapse                ", std::size_t{ 3 }, inventory.size() );
+    affirm.is_equal( "Construction - first occurrence wins              ", 10U,              inventory.at( "00000000000001" ) );
+    affirm.is_true ( "Construction - unknown UPC not carried            ", !inventory.contains( "00000000000004" ) );
+
+    auto snapshot = inventory.snapshot();
+    affirm.is_true ( "Snapshot - every item, in UPC order               ", snapshot == std::vector<Inventory::Item>{ { "00000000000001", 10 }, { "00000000000002", 20 }, { "00000000000003", 30 } } );
+
+    bool threw = false;
+    try                                    { inventory.at( "00000000000004" ); }
+    catch( const std::out_of_range & )     { threw = true; }
+    affirm.is_true ( "Query - at() throws for an item not carried       ", threw );
+
+    affirm.is_true ( "Construction - default constructed is empty      ", Inventory().empty() );
+  }
+
+
+
+
+  void InventoryRegressionTest::modifiers()
+  {
+    Inventory inventory( { { "00000000000001", 1 }, { "00000000000002", 5 } } );
+
+    affirm.is_true ( "Decrement - sells an available unit               ", inventory.decrementIfAvailable( "00000000000001" ) == Inventory::Sale::SOLD         );
+    affirm.is_true ( "Decrement - never goes below zero                 ", inventory.decrementIfAvailable( "00000000000001" ) == Inventory::Sale::OUT_OF_STOCK );
+    affirm.is_equal( "Decrement - quantity stays at zero                ", 0U, inventory.at( "00000000000001" ) );
+    affirm.is_true ( "Decrement - item not carried                      ", inventory.decrementIfAvailable( "00000000000009" ) == Inventory::Sale::NOT_CARRIED  );
+
+    affirm.is_true ( "Decrement - sells several units                   ", inventory.decrementIfAvailable( "00000000000002", 3 ) == Inventory::Sale::SOLD  &&  inventory.at( "00000000000002" ) == 2 );
+    affirm.is_true ( "Decrement - more than on hand takes what's left   ", inventory.decrementIfAvailable( "00000000000002", 3 ) == Inventory::Sale::OUT_OF_STOCK  &&  inventory.at( "00000000000002" ) == 0 );
+    affirm.is_true ( "Decrement - none at all is a sale                 ", inventory.decrementIfAvailable( "00000000000002", 0 ) == Inventory::Sale::SOLD );
+    Inventory::Hint saleHint;
+    affirm.is_true ( "Decrement - hinted, in UPC order                  ", inventory.decrementIfAvailable( "00000000000001", 0, saleHint ) == Inventory::Sale::SOLD
+                                                                         &&  inventory.decrementIfAvailable( "00000000000002", 1, saleHint ) == Inventory::Sale::OUT_OF_STOCK
+                                                                         &&  inventory.decrementIfAvailable( "00000000000009", 1, saleHint ) == Inventory::Sale::NOT_CARRIED );
+    inventory.restock( "00000000000002", 5 );
+
+    affirm.is_true ( "Restock - adds units                              ", inventory.restock( "00000000000001", 20 ) );
+    affirm.is_equal( "Restock - new quantity                            ", 20U, inventory.at( "00000000000001" ) );
+    affirm.is_true ( "Restock - item not carried                        ", !inventory.restock( "00000000000009", 20 ) );
+
+    affirm.is_equal( "Erase - erases a carried item                     ", std::size_t{ 1 }, inventory.erase( "00000000000002" ) );
+    affirm.is_equal( "Erase - erasing again is a no-op                  ", std::size_t{ 0 }, inventory.erase( "00000000000002" ) );
+    affirm.is_equal( "Erase - size reflects erasure                     ", std::size_t{ 1 }, inventory.size() );
+    affirm.is_true ( "Erase - erased item is no longer carried          ", !inventory.quantity( "00000000000002" ).has_value() );
+    affirm.is_true ( "Erase - erased item can't be sold                 ", inventory.decrementIfAvailable( "00000000000002" ) == Inventory::Sale::NOT_CARRIED );
+    affirm.is_true ( "Erase - erased item can't be restocked            ", !inventory.restock( "00000000000002", 1 ) );
+    affirm.is_equal( "Erase - snapshot omits erased items               ", std::size_t{ 1 }, inventory.snapshot().size() );
+
+    // Only changes are observed, each with the quantity afterwards
+    std::vector<std::pair<Upc, std::optional<Inventory::Quantity>>> observed;
+    inventory.observe( [&observed]( const Upc & upc, std::optional<Inventory::Quantity> quantity ) { observed.emplace_back( upc, quantity ); } );
+    inventory.decrementIfAvailable( "00000000000001" );
+    inventory.decrementIfAvailable( "00000000000009" );
+    inventory.restock             ( "00000000000001", 5 );
+    inventory.restock             ( "00000000000002", 5 );
+    inventory.erase               ( "00000000000001" );
+    // Hinted searches for increasing UPCs, including UPCs not carried and a UPC before the hint, find what unhinted ones do
+    Inventory       many( { { "00000000000010", 10 }, { "00000000000020", 20 }, { "00000000000030", 30 }, { "00000000000040", 40 }, { "00000000000050", 50 } } );
+    Inventory::Hint hint;
+    affirm.is_true ( "Hint - finds each UPC in turn                     ", many.quantity( "00000000000010", hint ) == 10U  &&  !many.quantity( "00000000000025", hint )
+                                                                         &&  many.quantity( "00000000000040", hint ) == 40U  &&  !many.quantity( "00000000000099", hint ) );
+    affirm.is_true ( "Hint - a UPC before the hint is still found       ", many.quantity( "00000000000020", hint ) == 20U );
+    affirm.is_true ( "Hint - restocks                                   ", many.restock( "00000000000050", 5, hint )  &&  many.at( "00000000000050" ) == 55U  &&  !many.restock( "00000000000051", 5, hint ) );
+
+    affirm.is_true ( "Observe - every change, in order                  ", observed == std::vector<std::pair<Upc, std::optional<Inventory::Quantity>>>{ { "00000000000001", 19 }, { "00000000000001", 24 }, { "00000000000001", std::nullopt } } );
+  }
+
+
+
+
+  void InventoryRegressionTest::concurrency()
+  {
+    // Many lanes selling the same few grocery items at once must neither lose nor invent a single unit
+    constexpr unsigned LANES = 8, SALES_PER_LANE = 10'000, STOCK = LANES * SALES_PER_LANE / 2;
+
+    Inventory inventory( { { "00000000000001", STOCK }, { "00000000000002", STOCK } } );
+    std::vector<std::size_t> sold( LANES, 0 );
+    {
+      std::vector<std::jthread> lanes;
+      for( unsigned lane = 0; lane < LANES; ++lane ) lanes.emplace_back( [&, lane]
+      {
+        for( unsigned sale = 0; sale < SALES_PER_LANE; ++sale )
+        {
+          if( inventory.decrementIfAvailable( sale % 2 == 0 ? "00000000000001" : "00000000000002" ) == Inventory::Sale::SOLD ) ++sold[lane];
+          if( sale % 4 == 0 ) inventory.restock( "00000000000002", 1 );
+        }
+      } );
+    }
+
+    std::size_t totalSold = 0;
+    for( auto count : sold ) totalSold += count;
+
+    std::size_t restocked = LANES * ( ( SALES_PER_LANE + 3 ) / 4 );
+    affirm.is_equal( "Concurrency - no unit lost or invented            ", std::size_t{ 2 } * STOCK + restocked, totalSold + inventory.at( "00000000000001" ) + inventory.at( "00000000000002" ) );
+  }
+
+
+
+
+  void InventoryRegressionTest::loading()
+  {
+    std::istringstream file( "\"00000000000003\"  30\n"
+                             "00000000000001 10\r\n"
+                             "\n"
+                             "  \"00000000000003\"\t 99  \n"
+                             "0000000000002   7\n"                                         // line 5:  13 digits
+                             "\"00000000000002   7\n"                                     // line 6:  no closing quote
+                             "00000000000002   seven\n"                                    // line 7:  not a number
+                             "00000000000002   -7\n"                                       // line 8:  negative
+                             "00000000000002   99999999999\n"                              // line 9:  too large
+                             "00000000000002   7 units\n"                                  // line 10: trailing text
+                             "00000000000004 4" );                                         // no final newline
+    std::ostringstream diagnostics;
+    auto result = loadInventory( file, "test.dat", MergePolicy::FIRST_WINS, diagnostics );
+
+    affirm.is_equal( "Loading - well formed records read                ", std::size_t{ 4 }, result.records  );
+    affirm.is_equal( "Loading - malformed lines rejected                ", std::size_t{ 6 }, result.rejected );
+    affirm.is_equal( "Loading - duplicate records merged                ", std::size_t{ 1 }, result.merged   );
+    affirm.is_true ( "Loading - quoted, unquoted, and unterminated last ", result.inventory.snapshot() == std::vector<Inventory::Item>{ { "00000000000001", 10 }, { "00000000000003", 30 }, { "00000000000004", 4 } } );
+
+    auto report = diagnostics.str();
+    bool allReported = true;
+    for( auto line : { ":5:", ":6:", ":7:", ":8:", ":9:", ":10:" } ) allReported = allReported  &&  report.find( std::string( "test.dat" ) + line ) != std::string::npos;
+    affirm.is_true ( "Loading - malformed lines reported by line number ", allReported );
+
+    // A line straddling the boundary between two blocks, and a line longer than a block, are both read intact
+    std::string big( ( 1 << 20 ) - 10, ' ' );
+    big += "00000000000005 5\n";
+    big += std::string( 3 << 20, ' ' ) + "00000000000006 6\n";
+    std::istringstream bigFile( big );
+    affirm.is_true ( "Loading - lines spanning read blocks              ", loadInventory( bigFile, "big.dat", MergePolicy::FIRST_WINS, diagnostics ).inventory.snapshot() == std::vector<Inventory::Item>{ { "00000000000005", 5 }, { "00000000000006", 6 } } );
+  }
+
+
+
+
+  void InventoryRegressionTest::merging()
+  {
+    // An append-only feed:  the same grocery items reported again and again, interleaved
+    constexpr char feed[] = "00000000000002 5\n00000000000001 1\n00000000000002 6\n00000000000001 2\n00000000000002 4294967295\n00000000000003 3\n";
+
+    auto load = [&]( MergePolicy policy )
+    {
+      std::istringstream file( feed );
+      return loadInventory( file, "feed.dat", policy );
+    };
+
+    auto first = load( MergePolicy::FIRST_WINS );
+    auto last  = load( MergePolicy::LAST_WINS  );
+    auto sum   = load( MergePolicy::SUM        );
+
+    affirm.is_equal( "Merging - records merged                          ", std::size_t{ 3 }, first.merged );
+    affirm.is_true ( "Merging - first wins                              ", first.inventory.snapshot() == std::vector<Inventory::Item>{ { "00000000000001", 1 }, { "00000000000002", 5          }, { "00000000000003", 3 } } );
+    affirm.is_true ( "Merging - last wins                               ", last .inventory.snapshot() == std::vector<Inventory::Item>{ { "00000000000001", 2 }, { "00000000000002", 4294967295 }, { "00000000000003", 3 } } );
+    affirm.is_true ( "Merging - sum, saturating                         ", sum  .inventory.snapshot() == std::vector<Inventory::Item>{ { "00000000000001", 3 }, { "00000000000002", 4294967295 }, { "00000000000003", 3 } } );
+  }
+
+
+
+
+  InventoryRegressionTest::InventoryRegressionTest()
+  {
+    std::clog << std::boolalpha << std::showpoint << std::fixed << std::setprecision( 2 );
+
+    try
+    {
+      std::clog << "\n\n\nInventory Regression Test:\n";
+      construction();
+      modifiers();
+      concurrency();
+      loading();
+      merging();
+
+      std::clog << "\n\nInventory Regression Test " << affirm << "\n\n";
+    }
+    catch( const std::exception & ex )
+    {
+      std::clog << "FAILURE:  Regression test for \"class Inventory\" failed with an unhandled exception. \n\n\n"
+                << ex.what() << std::endl;
+    }
+  }
+} // namespace
@@ -0,0 +1,134 @@
+#include <exception>
+#include <iomanip>                                                                          // setprecision()
+#include <iostream>                                                                         // boolalpha(), showpoint(), fixed(), clog
+#include <sstream>                                                                          // istringstream, ostringstream
+#include <string>
+#include <string_view>
+#include <system_error>                                                                     // errc
+
+#include "CheckResults.hpp"
+#include "Money.hpp"
+
+
+
+
+namespace  // anonymous
+{
+  class MoneyRegressionTest
+  {
+    public:
+      MoneyRegressionTest();
+
+    private:
+      void construction();
+      void arithmetic();
+      void io();
+
+      Regression::CheckResults affirm;
+  } run_money_tests;
+
+
+
+
+  // The amount text parses to, or nothing if text is malformed or not entirely consumed
+  bool parses( std::string_view text, Money expected )
+  {
+    Money money = -999.99;
+    auto [last, error] = Money::from_chars( text.data(), text.data() + text.size(), money );
+    return error == std::errc{}  &&  last == text.data() + text.size()  &&  money == expected;
+  }
+
+  bool rejects( std::string_view text )
+  {
+    Money money = -999.99;
+    auto [last, error] = Money::from_chars( text.data(), text.data() + text.size(), money );
+    return error != std::errc{}  &&  last == text.data()  &&  money == -999.99;
+  }
+
+
+
+
+  void MoneyRegressionTest::construction()
+  {
+    affirm.is_equal( "Default is zero                                  ", Money::Cents{ 0    }, Money().cents()                  );
+    affirm.is_equal( "Dollars to cents                                 ", Money::Cents{ 229  }, Money( 2.29 ).cents()            );
+    affirm.is_equal( "Dollars round to the nearest cent                ", Money::Cents{ 1000 }, Money( 9.996 ).cents()           );
+    affirm.is_equal( "Negative dollars round away from zero            ", Money::Cents{ -5   }, Money( -0.046 ).cents()          );
+    affirm.is_equal( "From cents                                       ", Money( 13.99 ),       Money::fromCents( 1399 )         );
+  }
+
+
+
+
+  void MoneyRegressionTest::arithmetic()
+  {
+    // A dime added ten thousand times is exactly a thousand dollars, which 0.1 added as a double is not
+    Money total;
+    for( int i = 0; i < 10'000; ++i ) total += 0.10;
+    affirm.is_equal( "Sums are exact                                   ", Money( 1'000.0 ), total );
+
+    affirm.is_equal( "Subtraction                                      ", Money( 0.01 ),  Money( 10.0 ) - Money( 9.99 ) );
+    affirm.is_equal( "Multiplication by a quantity                     ", Money( 29.97 ), Money( 9.99 ) * 3             );
+    affirm.is_equal( "Negation                                         ", Money( -9.99 ), -Money( 9.99 )                );
+
+    affirm.is_true ( "Strong ordering                                  ", Money( 9.99 ) < Money( 10.0 )  &&  Money( -1.0 ) < Money()  &&  Money( 2.5 ) >= Money( 2.50 ) );
+  }
+
+
+
+
+  void MoneyRegressionTest::io()
+  {
+    affirm.is_true( "Parse dollars and cents                          ", parses( "2.29",       2.29     ) );
+    affirm.is_true( "Parse whole dollars                              ", parses( "13",         13.0     ) );
+    affirm.is_true( "Parse one fractional digit                       ", parses( "0.5",        0.50     ) );
+    affirm.is_true( "Parse without leading digits                     ", parses( ".05",        0.05     ) );
+    affirm.is_true( "Parse a trailing decimal point                   ", parses( "7.",         7.0      ) );
+    affirm.is_true( "Parse rounds half up to the cent                 ", parses( "1.005",      1.01     ) );
+    affirm.is_true( "Parse rounds down to the cent                    ", parses( "1.0049999",  1.00     ) );
+    affirm.is_true( "Parse negative amounts                           ", parses( "-12.345",    -12.35   ) );
+    affirm.is_true( "Parse rejects no digits                          ", rejects( "-."         ) );
+    affirm.is_true( "Parse rejects a leading plus                     ", rejects( "+1.00"      ) );
+    affirm.is_true( "Parse rejects overflow                           ", rejects( "99999999999999999999" ) );
+
+    std::ostringstream out;
+    out << std::scientific << std::setprecision( 5 ) << Money( 1234.5 ) << ' ' << Money( -0.07 ) << ' ' << Money() << ' ' << std::setw( 8 ) << Money( 1.0 );
+    affirm.is_equal( "Inserted as dollars and exactly two places       ", std::string( "1234.50 -0.07 0.00     1.00" ), out.str() );
+
+    std::istringstream in( " 2.29, +13 -0.5 x" );
+    Money a, b, c, d = 1.0;
+    char  comma = '\0';
+    in >> a >> comma >> b >> c;
+    affirm.is_true ( "Extracted amounts                                ", in  &&  a == 2.29  &&  comma == ','  &&  b == 13.0  &&  c == -0.50 );
+
+    in >> d;
+    affirm.is_true ( "Failed extraction leaves the amount unchanged    ", in.fail()  &&  d == 1.0 );
+
+    std::istringstream last( "9.99" );
+    last >> a;
+    affirm.is_true ( "Extraction at the end of input                   ", !last.fail()  &&  last.eof()  &&  a == 9.99 );
+  }
+
+
+
+
+  MoneyRegressionTest::MoneyRegressionTest()
+  {
+    std::clog << std::boolalpha << std::showpoint << std::fixed << std::setprecision( 2 );
+
+    try
+    {
+      std::clog << "\n\n\nMoney Regression Test:\n";
+      construction();
+      arithmetic();
+      io();
+
+      std::clog << "\n\nMoney Regression Test " << affirm << "\n\n";
+    }
+    catch( const std::exception & ex )
+    {
+      std::clog << "FAILURE:  Regression test for \"class Money\" failed with an unhandled exception. \n\n\n"
+                << ex.what() << std::endl;
+    }
+  }
+} // namespace
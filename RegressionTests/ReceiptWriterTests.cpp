@@ -0,0 +1,144 @@
+#include <exception>
+#include <iomanip>                                                                          // setprecision(), quoted()
+#include <iostream>                                                                         // boolalpha(), showpoint(), fixed(), clog
+#include <sstream>                                                                          // ostringstream
+#include <string>
+
+#include "CheckResults.hpp"
+#include "GroceryItemDatabase.hpp"
+#include "Money.hpp"
+#include "ReceiptWriter.hpp"
+#include "Upc.hpp"
+
+
+
+
+namespace  // anonymous
+{
+  class ReceiptWriterRegressionTest
+  {
+    public:
+      ReceiptWriterRegressionTest();
+
+    private:
+      void tests();
+
+      Regression::CheckResults affirm;
+  } run_receiptWriter_tests;
+
+
+
+
+  // Renders one receipt both ways, through a ReceiptWriter and through the stream insertion it replaces, in the given stream format.
+  // Prices are Money, which ignores the floating point format, so the bytes match whatever the format.
+  template<typename Format>
+  bool sameAsStream( const GroceryItemView & groceryItem, Format format )
+  {
+    const Money        amount = 1234.5678;
+    std::ostringstream expected, actual;
+    format( expected );
+    format( actual   );
+
+    expected << "Shopper's shopping cart contains:\n"
+             << "  " << groceryItem << '\n'
+             << "  " << std::quoted( std::string( "00000000000001" ) ) << " (milk) not found, the item is free!\n"
+             << "-------------------------\nTotal $" << amount << "\n\n";
+    {
+      ReceiptWriter receipt( actual );
+      receipt.customer( "Shopper" ).item( groceryItem ).notFound( "00000000000001", "milk" ).total( amount );
+    }
+    return expected.str() == actual.str();
+  }
+
+
+
+
+  void ReceiptWriterRegressionTest::tests()
+  {
+    auto groceryItem = GroceryItemDatabase::instance().find( "00038000291210" );
+
+    affirm.is_true( "Same bytes as the stream - fixed, 2 places      ", sameAsStream( groceryItem, []( std::ostream & s ) { s << std::fixed << std::setprecision( 2 ) << std::showpoint; } ) );
+    affirm.is_true( "Same bytes as the stream - fixed, 0 places      ", sameAsStream( groceryItem, []( std::ostream & s ) { s << std::fixed << std::setprecision( 0 ) << std::showpoint; } ) );
+    affirm.is_true( "Same bytes as the stream - default format       ", sameAsStream( groceryItem, []( std::ostream &   ) {                                                              } ) );
+    affirm.is_true( "Same bytes as the stream - scientific           ", sameAsStream( groceryItem, []( std::ostream & s ) { s << std::scientific << std::setprecision( 3 );               } ) );
+    affirm.is_true( "Same bytes as the stream - item not found       ", sameAsStream( nullptr,     []( std::ostream & s ) { s << std::fixed << std::setprecision( 2 );                  } ) );
+
+    // Quotes and backslashes are escaped exactly as std::quoted() escapes them.  The change is undone so the rest of the program
+    // sees the database as it was.
+    if( groceryItem != nullptr )
+    {
+      auto original = groceryItem->productName();
+      groceryItem->productName( R"(Kellogg's "Rice" \Krispies\ "")" );
+      affirm.is_true( "Same bytes as the stream - escaped characters   ", sameAsStream( groceryItem, []( std::ostream & s ) { s << std::fixed << std::setprecision( 2 ); } ) );
+      groceryItem->productName( original );
+    }
+
+    // Re-order report lines, the same bytes as the stream insertion they replace.  A grocery item missing from the database shows
+    // its UPC alone.
+    {
+      std::ostringstream expected, actual;
+      expected << "Re-Ordering grocery items the store is running low on\n\n" << 1 << ": {";
+      if( groceryItem != nullptr ) expected << groceryItem;
+      else                         expected << std::quoted( std::string( "00038000291210" ) );
+      expected << "}\n *** no longer sold in this store and will not be re-ordered\n\n"
+               << 2 << ": {" << std::quoted( std::string( "00000000000001" ) ) << "}\n only " << 3 << " remain in stock which is " << 12
+               << " unit(s) below reorder threshold (" << 15 << "), re-ordering " << 20 << " more\n\n";
+      {
+        ReceiptWriter report( actual );
+        report.reorderHeading().discontinued( 1, "00038000291210", groceryItem ).reordered( 2, "00000000000001", nullptr, 3, 15, 20 );
+      }
+      affirm.is_equal( "Re-order report lines                          ", expected.str(), actual.str() );
+    }
+
+    // Several units of a grocery item show how many and their extended price
+    if( groceryItem != nullptr )
+    {
+      std::ostringstream expected, actual;
+      expected << "  " << groceryItem << " x " << 3 << " = " << groceryItem.price() * 3 << '\n';
+      ReceiptWriter( actual ).item( groceryItem, 3 );
+      affirm.is_equal( "Item with a quantity                           ", expected.str(), actual.str() );
+    }
+
+    // A writer holding its text until asked for it, as a checkout lane does
+    ReceiptWriter held;
+    for( int i = 0; i < 10'000; ++i ) held.total( 1.0 );
+    affirm.is_equal( "Held text is kept in full                      ", std::size_t{ 10'000 * 39 }, held.text().size() );
+    affirm.is_true ( "Held text totals are exact                     ", held.text().starts_with( "-------------------------\nTotal $1.00\n\n" ) );
+
+    held.clear();
+    affirm.is_true ( "Cleared text is discarded                      ", held.text().empty() );
+
+    // A writer bound to a stream writes in large blocks as its buffer fills, and the rest when flushed
+    std::ostringstream stream;
+    ReceiptWriter      bound( stream );
+    bound.total( 1.0 );
+    affirm.is_true ( "Bound writer buffers small amounts             ", stream.str().empty() );
+
+    for( int i = 0; i < 10'000; ++i ) bound.total( 1.0 );
+    affirm.is_true ( "Bound writer writes when its buffer fills      ", !stream.str().empty() );
+
+    bound.flush();
+    affirm.is_equal( "Bound writer flushes everything                ", std::size_t{ 10'001 * 39 }, stream.str().size() );
+  }
+
+
+
+
+  ReceiptWriterRegressionTest::ReceiptWriterRegressionTest()
+  {
+    std::clog << std::boolalpha << std::showpoint << std::fixed << std::setprecision( 2 );
+
+    try
+    {
+      std::clog << "\n\n\nReceiptWriter Regression Test:\n";
+      tests();
+
+      std::clog << "\n\nReceiptWriter Regression Test " << affirm << "\n\n";
+    }
+    catch( const std::exception & ex )
+    {
+      std::clog << "FAILURE:  Regression test for \"class ReceiptWriter\" failed with an unhandled exception. \n\n\n"
+                << ex.what() << std::endl;
+    }
+  }
+} // namespace
@@ -0,0 +1,189 @@
+#include <atomic>
+#include <chrono>                                                                           // milliseconds, hours
+#include <cstddef>                                                                          // size_t
+#include <exception>
+#include <iomanip>                                                                          // setprecision()
+#include <iostream>                                                                         // boolalpha(), showpoint(), fixed(), clog
+#include <optional>
+#include <thread>                                                                           // jthread, sleep_for()
+#include <vector>
+
+#include "RegressionTests/CheckResults.hpp"
+#include "BoundedQueue.hpp"
+#include "Inventory.hpp"
+#include "ReorderScheduler.hpp"
+#include "Upc.hpp"
+
+
+
+
+namespace  // anonymous
+{
+  class ReorderSchedulerRegressionTest
+  {
+    public:
+      ReorderSchedulerRegressionTest();
+
+    private:
+      void queueing();
+      void purchaseOrders();
+      void cadence();
+      void concurrency();
+
+      Regression::CheckResults affirm;
+  } run_reorderScheduler_tests;
+
+
+
+
+  constexpr Inventory::Quantity THRESHOLD = 15;
+  constexpr Inventory::Quantity LOT_COUNT = 20;
+  constexpr auto                NEVER     = std::chrono::hours( 1 );           // A cadence long enough that only flushes start passes
+
+
+
+
+  void ReorderSchedulerRegressionTest::queueing()
+  {
+    BoundedQueue<int> queue( 3 );
+    affirm.is_equal( "Queue - capacity rounded up to a power of 2       ", std::size_t{ 4 }, queue.capacity() );
+
+    bool pushed = true;
+    for( int i = 1; i <= 4; ++i ) pushed = queue.push( i )  &&  pushed;
+    affirm.is_true ( "Queue - holds its capacity                        ", pushed  &&  queue.size() == 4 );
+    affirm.is_true ( "Queue - a push to a full queue fails              ", !queue.push( 5 ) );
+
+    std::vector<int> popped;
+    while( auto value = queue.pop() ) popped.push_back( *value );
+    affirm.is_true ( "Queue - first in, first out                       ", popped == std::vector<int>{ 1, 2, 3, 4 } );
+    affirm.is_true ( "Queue - wraps around                              ", queue.push( 6 )  &&  queue.pop() == 6  &&  !queue.pop() );
+  }
+
+
+
+
+  void ReorderSchedulerRegressionTest::purchaseOrders()
+  {
+    // Two manufacturers, "0004133" and "0007059", and a grocery item low on stock that isn't carried any more
+    Inventory inventory( { { "00041331092609", 3 }, { "00041331092610", 14 }, { "00041331092611", 30 }, { "00070596000647", 0 }, { "00099999999999", 1 } } );
+    inventory.erase( "00099999999999" );
+
+    std::vector<ReorderScheduler::PurchaseOrder> orders;
+    {
+      ReorderScheduler scheduler( inventory, THRESHOLD, LOT_COUNT, NEVER, [&orders]( const ReorderScheduler::PurchaseOrder & order ) { orders.push_back( order ); } );
+      for( auto upc : { "00070596000647", "00041331092610", "00041331092609", "00041331092610", "00041331092611", "00099999999999", "00070596000647" } )
+      {
+        scheduler.lowStock( upc );
+      }
+      affirm.is_equal( "Orders - reports wait for the next pass           ", std::size_t{ 7 }, scheduler.queueDepth() );
+
+      scheduler.flush();
+      auto statistics = scheduler.statistics();
+      affirm.is_equal( "Orders - every report taken                       ", std::size_t{ 7 }, statistics.reports );
+      affirm.is_true ( "Orders - one per manufacturer, each item once     ", statistics.purchaseOrders == 2  &&  statistics.itemsOrdered == 3  &&  statistics.unitsOrdered == 3 * LOT_COUNT );
+      affirm.is_equal( "Orders - queue depth recorded                     ", std::size_t{ 7 }, statistics.maxQueueDepth );
+    }
+
+    affirm.is_true ( "Orders - grouped by manufacturer, in UPC order    ", orders.size() == 2
+                                                                         &&  orders[0].supplier == "0004133"  &&  orders[0].lines == std::vector<Inventory::Item>{ { "00041331092609", LOT_COUNT }, { "00041331092610", LOT_COUNT } }
+                                                                         &&  orders[1].supplier == "0007059"  &&  orders[1].lines == std::vector<Inventory::Item>{ { "00070596000647", LOT_COUNT } } );
+    affirm.is_true ( "Orders - restocked                                ", inventory.at( "00041331092609" ) == 23  &&  inventory.at( "00041331092610" ) == 34  &&  inventory.at( "00070596000647" ) == 20 );
+    affirm.is_equal( "Orders - items above the threshold not ordered    ", 30U, inventory.at( "00041331092611" ) );
+    affirm.is_true ( "Orders - items no longer carried not ordered      ", !inventory.contains( "00099999999999" ) );
+  }
+
+
+
+
+  void ReorderSchedulerRegressionTest::cadence()
+  {
+    // Without being flushed, reports are re-ordered on the next pass, and whatever is reported when the scheduler stops is
+    // re-ordered before it does
+    Inventory inventory( { { "00000000000001", 0 }, { "00000000000002", 0 } } );
+    {
+      ReorderScheduler scheduler( inventory, THRESHOLD, LOT_COUNT, std::chrono::milliseconds( 1 ) );
+      scheduler.lowStock( "00000000000001" );
+
+      for( int wait = 0;  wait < 5'000  &&  inventory.at( "00000000000001" ) == 0;  ++wait ) std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+      affirm.is_equal( "Cadence - re-ordered on the next pass             ", LOT_COUNT, inventory.at( "00000000000001" ) );
+    }
+    {
+      ReorderScheduler scheduler( inventory, THRESHOLD, LOT_COUNT, NEVER );
+      scheduler.lowStock( "00000000000002" );
+    }
+    affirm.is_equal( "Cadence - re-ordered before stopping              ", LOT_COUNT, inventory.at( "00000000000002" ) );
+
+    // A full queue drops reports, and counts them
+    ReorderScheduler scheduler( inventory, THRESHOLD, LOT_COUNT, NEVER, {}, 2 );
+    bool accepted = scheduler.lowStock( "00000000000001" )  &&  scheduler.lowStock( "00000000000002" );
+    affirm.is_true ( "Cadence - full queue drops reports                ", accepted  &&  !scheduler.lowStock( "00000000000001" )  &&  scheduler.statistics().dropped == 1 );
+  }
+
+
+
+
+  void ReorderSchedulerRegressionTest::concurrency()
+  {
+    // Lanes selling as fast as they can report every sale below the threshold, as a store's inventory observer does, while the
+    // scheduler restocks in the background.  Nothing is oversold, and afterwards nothing sold is left below the threshold.
+    constexpr unsigned LANES = 4, SALES_PER_LANE = 2'000, ITEMS = 50;
+
+    std::vector<Inventory::Item> items;
+    for( unsigned i = 0; i < ITEMS; ++i ) items.emplace_back( *Upc::fromValue( 41'331'000'000ULL + i ), THRESHOLD );
+    Inventory inventory( items );
+
+    ReorderScheduler scheduler( inventory, THRESHOLD, LOT_COUNT, std::chrono::milliseconds( 1 ) );
+    inventory.observe( [&scheduler]( const Upc & upc, std::optional<Inventory::Quantity> quantity ) noexcept { if( quantity  &&  *quantity < THRESHOLD ) scheduler.lowStock( upc ); } );
+
+    std::atomic<std::size_t> sold = 0;
+    {
+      std::vector<std::jthread> lanes;
+      for( unsigned lane = 0; lane < LANES; ++lane ) lanes.emplace_back( [&, lane]
+      {
+        for( unsigned sale = 0; sale < SALES_PER_LANE; ++sale )
+        {
+          if( inventory.decrementIfAvailable( items[( lane + sale ) % ITEMS].first ) == Inventory::Sale::SOLD ) sold.fetch_add( 1, std::memory_order_relaxed );
+        }
+      } );
+    }
+    scheduler.flush();
+
+    auto        statistics = scheduler.statistics();
+    std::size_t onHand = 0, belowThreshold = 0;
+    for( const auto & [upc, quantity] : inventory.snapshot() )
+    {
+      onHand += quantity;
+      if( quantity < THRESHOLD ) ++belowThreshold;
+    }
+
+    affirm.is_equal( "Concurrency - no unit lost or invented            ", ITEMS * THRESHOLD + statistics.unitsOrdered, onHand + sold.load() );
+    affirm.is_equal( "Concurrency - nothing left below the threshold    ", std::size_t{ 0 }, belowThreshold );
+    affirm.is_equal( "Concurrency - no report dropped                   ", std::size_t{ 0 }, statistics.dropped );
+
+    inventory.observe( nullptr );
+  }
+
+
+
+
+  ReorderSchedulerRegressionTest::ReorderSchedulerRegressionTest()
+  {
+    std::clog << std::boolalpha << std::showpoint << std::fixed << std::setprecision( 2 );
+
+    try
+    {
+      std::clog << "\n\n\nReorderScheduler Regression Test:\n";
+      queueing();
+      purchaseOrders();
+      cadence();
+      concurrency();
+
+      std::clog << "\n\nReorderScheduler Regression Test " << affirm << "\n\n";
+    }
+    catch( const std::exception & ex )
+    {
+      std::clog << "FAILURE:  Regression test for \"class ReorderScheduler\" failed with an unhandled exception. \n\n\n"
+                << ex.what() << std::endl;
+    }
+  }
+} // namespace
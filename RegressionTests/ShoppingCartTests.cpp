@@ -0,0 +1,170 @@
+#include <array>
+#include <cstddef>                                                                          // size_t, byte
+#include <exception>
+#include <iomanip>                                                                          // setprecision()
+#include <iostream>                                                                         // boolalpha(), showpoint(), fixed(), clog
+#include <memory_resource>                                                                  // monotonic_buffer_resource, null_memory_resource()
+#include <string_view>
+#include <utility>                                                                          // move()
+#include <vector>
+
+#include "RegressionTests/CheckResults.hpp"
+#include "ShoppingCart.hpp"
+#include "Upc.hpp"
+
+
+
+
+namespace  // anonymous
+{
+  class ShoppingCartRegressionTest
+  {
+    public:
+      ShoppingCartRegressionTest();
+
+    private:
+      void construction();
+      void closing();
+      void spilling();
+      void labels();
+      void resources();
+
+      Regression::CheckResults affirm;
+  } run_shoppingCart_tests;
+
+
+
+
+  std::vector<ShoppingCart::Line> linesOf( const ShoppingCart & cart )
+  { return { cart.begin(), cart.end() }; }
+
+
+
+
+  void ShoppingCartRegressionTest::construction()
+  {
+    ShoppingCart empty;
+    affirm.is_true ( "Construction - default is empty and closed         ", empty.empty()  &&  empty.size() == 0  &&  empty.closed()  &&  empty.begin() == empty.end() );
+
+    ShoppingCart cart = { { "00075457129000", "milk" }, { "00038000291210", "rice krispies", 2 }, { "00025317533003" } };
+    affirm.is_true ( "Construction - closed, in UPC order                ", cart.closed()  &&  linesOf( cart ) == std::vector<ShoppingCart::Line>{ { "00025317533003", 1 }, { "00038000291210", 2 }, { "00075457129000", 1 } } );
+    affirm.is_true ( "Construction - UPCs and quantities side by side    ", cart.upcs().size() == 3  &&  cart.upcs()[1] == Upc( "00038000291210" )  &&  cart.quantities()[1] == 2 );
+
+    auto copy = cart;
+    affirm.is_true ( "Construction - copies compare equal                ", copy == cart );
+    copy.add( "00025317533003" ).close();
+    affirm.is_true ( "Construction - copies are independent              ", !( copy == cart )  &&  cart.quantities()[0] == 1 );
+  }
+
+
+
+
+  void ShoppingCartRegressionTest::closing()
+  {
+    ShoppingCart cart;
+    cart.add( "00000000000001" ).add( "00000000000005" );
+    affirm.is_true ( "Closing - added in UPC order stays closed          ", cart.closed() );
+
+    cart.add( "00000000000003", 4 ).add( "00000000000005", 2 );
+    affirm.is_true ( "Closing - added out of order reopens               ", !cart.closed()  &&  cart.size() == 4 );
+
+    cart.close();
+    affirm.is_true ( "Closing - sorted, same item combined               ", cart.closed()  &&  linesOf( cart ) == std::vector<ShoppingCart::Line>{ { "00000000000001", 1 }, { "00000000000003", 4 }, { "00000000000005", 3 } } );
+  }
+
+
+
+
+  void ShoppingCartRegressionTest::spilling()
+  {
+    // Lines beyond the inline capacity move the whole cart out of line, added in reverse so closing has to sort all of them
+    constexpr std::size_t LINES = ShoppingCart::INLINE_CAPACITY * 3;
+
+    ShoppingCart cart;
+    for( auto i = LINES; i > 0; --i ) cart.add( *Upc::fromValue( i ), static_cast<ShoppingCart::Quantity>( i ) );
+    cart.add( "00000000000001" );
+    cart.close();
+
+    bool ordered = cart.size() == LINES;
+    for( std::size_t i = 0;  ordered  &&  i < LINES;  ++i ) ordered = cart.upcs()[i].value() == i + 1  &&  cart.quantities()[i] == ( i == 0  ?  2  :  i + 1 );
+    affirm.is_true ( "Spilling - every line kept, sorted, and combined   ", ordered );
+
+    ShoppingCart full;
+    for( std::size_t i = 1; i <= ShoppingCart::INLINE_CAPACITY; ++i ) full.add( *Upc::fromValue( i ) );
+    affirm.is_true ( "Spilling - a full inline cart reads the same       ", full.size() == ShoppingCart::INLINE_CAPACITY  &&  full.upcs().back().value() == ShoppingCart::INLINE_CAPACITY );
+  }
+
+
+
+
+  void ShoppingCartRegressionTest::labels()
+  {
+    ShoppingCart cart = { { "00075457129000", "milk" }, { "00611508524006" } };
+    affirm.is_true ( "Labels - found by UPC                              ", cart.label( "00075457129000" ) == "milk" );
+    affirm.is_true ( "Labels - empty when none given                     ", cart.label( "00611508524006" ).empty()  &&  cart.label( "00000000000000" ).empty() );
+
+    cart.add( "00075457129000", 1, "2% milk" ).add( "00025317533003", 1, "hotdogs" );
+    affirm.is_true ( "Labels - the first label given is kept             ", cart.label( "00075457129000" ) == "milk"  &&  cart.label( "00025317533003" ) == "hotdogs" );
+
+    auto copy = cart;
+    copy.add( "00036192122930", 1, "Applesauce" );
+    affirm.is_true ( "Labels - a copy's new labels aren't shared         ", copy.label( "00036192122930" ) == "Applesauce"  &&  cart.label( "00036192122930" ).empty() );
+
+    ShoppingCart unlabeled = { { "00075457129000" } }, labeled = { { "00075457129000", "milk" } };
+    affirm.is_true ( "Labels - compared                                  ", !( unlabeled == labeled ) );
+  }
+
+
+
+
+  void ShoppingCartRegressionTest::resources()
+  {
+    // A cart on an arena with nothing behind it:  anything allocated anywhere else would throw
+    std::array<std::byte, 16 * 1024>    buffer;
+    std::pmr::monotonic_buffer_resource arena( buffer.data(), buffer.size(), std::pmr::null_memory_resource() );
+
+    ShoppingCart cart( &arena );
+    for( std::size_t i = ShoppingCart::INLINE_CAPACITY * 2; i > 0; --i ) cart.add( *Upc::fromValue( i ), 1, i == 1  ?  "milk"  :  "" );
+    cart.close();
+    affirm.is_true ( "Resources - spilled and labeled on the arena       ", cart.get_allocator().resource() == &arena  &&  cart.size() == ShoppingCart::INLINE_CAPACITY * 2  &&  cart.label( "00000000000001" ) == "milk" );
+
+    ShoppingCart copy( cart );
+    affirm.is_true ( "Resources - copies use the default resource        ", copy.get_allocator().resource() == std::pmr::get_default_resource()  &&  copy == cart );
+
+    auto label = copy.label( "00000000000001" );
+    affirm.is_true ( "Resources - a copy's labels aren't on the arena    ", label.data() < static_cast<const void *>( buffer.data() )  ||  label.data() >= static_cast<const void *>( buffer.data() + buffer.size() ) );
+
+    ShoppingCart assigned( &arena );
+    assigned = std::move( copy );
+    affirm.is_true ( "Resources - assignment keeps the cart's resource   ", assigned.get_allocator().resource() == &arena  &&  assigned == cart );
+
+    std::pmr::vector<ShoppingCart> carts( &arena );
+    carts.emplace_back( ShoppingCart{ { "00075457129000", "milk" } } );
+    affirm.is_true ( "Resources - carts in a container use its resource  ", carts.front().get_allocator().resource() == &arena  &&  carts.front().label( "00075457129000" ) == "milk" );
+  }
+
+
+
+
+  ShoppingCartRegressionTest::ShoppingCartRegressionTest()
+  {
+    std::clog << std::boolalpha << std::showpoint << std::fixed << std::setprecision( 2 );
+
+    try
+    {
+      std::clog << "\n\n\nShoppingCart Regression Test:\n";
+      construction();
+      closing();
+      spilling();
+      labels();
+      resources();
+
+      std::clog << "\n\nShoppingCart Regression Test " << affirm << "\n\n";
+    }
+    catch( const std::exception & ex )
+    {
+      std::clog << "FAILURE:  Regression test for \"class ShoppingCart\" failed with an unhandled exception. \n\n\n"
+                << ex.what() << std::endl;
+    }
+  }
+} // namespace
@@ -0,0 +1,201 @@
+#include <algorithm>                                                      // max(), sort(), unique()
+#include <chrono>                                                         // steady_clock, duration
+#include <cstddef>                                                        // size_t
+#include <cstdint>                                                        // uint64_t
+#include <mutex>                                                          // lock_guard, unique_lock
+#include <stop_token>
+#include <utility>                                                        // move()
+
+#include "Inventory.hpp"
+#include "ReorderScheduler.hpp"
+#include "Upc.hpp"
+
+
+
+namespace  // anonymous
+{
+  // Grocery items from the same manufacturer share the leading digits of their UPCs
+  std::uint64_t supplierOf( const Upc & upc ) noexcept
+  {
+    std::uint64_t divisor = 1;
+    for( auto i = ReorderScheduler::PREFIX_DIGITS; i < Upc::DIGITS; ++i ) divisor *= 10;
+    return upc.value() / divisor;
+  }
+}    // namespace
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Constructors, assignments, and destructor
+*******************************************************************************/
+ReorderScheduler::ReorderScheduler( Inventory & inventory, Inventory::Quantity threshold, Inventory::Quantity lotCount, std::chrono::milliseconds cadence,
+                                    Supplier supplier, std::size_t queueCapacity )
+  : _inventory( inventory ),
+    _threshold( threshold ),
+    _lotCount ( lotCount  ),
+    _cadence  ( cadence   ),
+    _supplier ( std::move( supplier ) ),
+    _queue    ( queueCapacity ),
+    _thread   ( [this]( std::stop_token stopToken ) { run( stopToken ); } )
+{}
+
+
+
+
+ReorderScheduler::~ReorderScheduler() noexcept
+{
+  _thread.request_stop();                                         // wakes the thread for one last pass
+  if( _thread.joinable() ) _thread.join();
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Reporting and scheduling
+*******************************************************************************/
+bool ReorderScheduler::lowStock( const Upc & upc ) noexcept
+{
+  if( _queue.push( upc ) ) return true;
+
+  _dropped.fetch_add( 1, std::memory_order_relaxed );
+  return false;
+}
+
+
+
+void ReorderScheduler::flush()
+{
+  std::unique_lock lock( _mutex );
+  auto ticket = ++_requested;
+  _wake.notify_all();
+  _wake.wait( lock, [&] { return _completed >= ticket; } );
+}
+
+
+
+std::size_t ReorderScheduler::queueDepth() const noexcept
+{ return _queue.size(); }
+
+
+
+ReorderScheduler::Statistics ReorderScheduler::statistics() const
+{
+  std::lock_guard lock( _mutex );
+  auto statistics    = _statistics;
+  statistics.dropped = _dropped.load( std::memory_order_relaxed );
+  return statistics;
+}
+
+
+
+double ReorderScheduler::Statistics::reportsPerSecond() const
+{
+  auto seconds = std::chrono::duration<double>( busyTime ).count();
+  return seconds > 0.0  ?  static_cast<double>( reports ) / seconds  :  0.0;
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Background thread
+*******************************************************************************/
+// A pass runs every cadence, or as soon as a flush asks for one.  Flushes asked for before a pass starts are answered when it
+// finishes; those asked for while it runs start another right after.  Once asked to stop, the thread makes one last pass so nothing
+// reported is left behind.
+void ReorderScheduler::run( std::stop_token stopToken )
+{
+  std::unique_lock lock( _mutex );
+  for( ;; )
+  {
+    _wake.wait_for( lock, stopToken, _cadence, [this] { return _requested != _completed; } );
+
+    auto stopping = stopToken.stop_requested();
+    auto answers  = _requested;
+
+    lock.unlock();
+    pass();
+    lock.lock();
+
+    _completed = answers;
+    _wake.notify_all();
+    if( stopping ) break;
+  }
+}
+
+
+
+// Reports are drained, then sorted so each grocery item is considered once and in UPC order.  Grocery items from one manufacturer
+// are then next to each other, so each purchase order is a single run, and the inventory is walked once, as a merge, both to check
+// what is still below the threshold and to restock it.
+void ReorderScheduler::pass()
+{
+  auto started = std::chrono::steady_clock::now();
+  auto depth   = _queue.size();
+
+  _reported.clear();
+  while( auto upc = _queue.pop() ) _reported.push_back( *upc );
+  auto reports = _reported.size();
+
+  std::sort( _reported.begin(), _reported.end() );
+  _reported.erase( std::unique( _reported.begin(), _reported.end() ), _reported.end() );
+
+  PurchaseOrder   order;
+  Inventory::Hint lookupHint, restockHint;
+  std::size_t     purchaseOrders = 0, itemsOrdered = 0;
+
+  for( const auto & upc : _reported )
+  {
+    auto onHand = _inventory.quantity( upc, lookupHint );
+    if( !onHand  ||  *onHand >= _threshold ) continue;                   // no longer carried, or restocked since it was reported
+
+    if( !order.lines.empty()  &&  supplierOf( order.lines.front().first ) != supplierOf( upc ) )
+    {
+      ++purchaseOrders;
+      itemsOrdered += order.lines.size();
+      place( order, restockHint );
+    }
+
+    if( order.lines.empty() ) order.supplier = upc.to_string().substr( 0, PREFIX_DIGITS );
+    order.lines.emplace_back( upc, _lotCount );
+  }
+
+  if( !order.lines.empty() )
+  {
+    ++purchaseOrders;
+    itemsOrdered += order.lines.size();
+    place( order, restockHint );
+  }
+
+  std::lock_guard lock( _mutex );
+  _statistics.reports        += reports;
+  _statistics.passes         += 1;
+  _statistics.purchaseOrders += purchaseOrders;
+  _statistics.itemsOrdered   += itemsOrdered;
+  _statistics.unitsOrdered   += itemsOrdered * _lotCount;
+  _statistics.maxQueueDepth   = std::max( _statistics.maxQueueDepth, depth );
+  _statistics.busyTime       += std::chrono::steady_clock::now() - started;
+}
+
+
+
+void ReorderScheduler::place( PurchaseOrder & order, Inventory::Hint & hint )
+{
+  if( _supplier ) _supplier( order );
+  for( const auto & [upc, quantity] : order.lines ) _inventory.restock( upc, quantity, hint );
+  order.lines.clear();
+}
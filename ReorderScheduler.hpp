@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>                                                               // milliseconds, nanoseconds
+#include <condition_variable>
+#include <cstddef>                                                              // size_t
+#include <cstdint>                                                              // uint64_t
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>                                                               // jthread
+#include <vector>
+
+#include "BoundedQueue.hpp"
+#include "Inventory.hpp"
+#include "Upc.hpp"
+
+
+
+// Restocks an inventory in the background while checkout lanes keep selling from it.
+//
+// A lane that leaves a grocery item below the re-order threshold reports it with lowStock(), which only pushes the UPC onto a
+// lock-free queue, so checkout never waits on re-ordering.  On a fixed cadence, a background thread drains the queue, coalesces the
+// reports (an item sold down ten times is ordered once), and groups the items still below the threshold into one purchase order
+// per supplier, identified by the manufacturer prefix of the UPC.  Each order is handed to the supplier callback, if there is one,
+// and then the items it orders are restocked as though the shipment had arrived.
+//
+// A report pushed onto a full queue is dropped and counted.  The grocery item is reported again by its next sale, and re-ordering
+// at the end of the day catches any that aren't.
+class ReorderScheduler
+{
+  public:
+    inline static constexpr std::chrono::milliseconds DEFAULT_CADENCE        { 100 };  // Time between re-ordering passes
+    inline static constexpr std::size_t               DEFAULT_QUEUE_CAPACITY = 65'536;  // Reports held between passes
+    inline static constexpr std::size_t               PREFIX_DIGITS          = 7;       // Leading UPC digits identifying the manufacturer
+
+    struct PurchaseOrder
+    {
+      std::string                  supplier;                                    // Manufacturer prefix of every UPC ordered, Ex: "0004133"
+      std::vector<Inventory::Item> lines;                                       // UPC and quantity ordered, by UPC
+    };
+
+    using Supplier = std::function<void( const PurchaseOrder & order )>;         // Called on the scheduler's thread before the order is restocked
+
+    struct Statistics
+    {
+      std::size_t              reports        = 0;                              // Low stock reports taken from the queue
+      std::size_t              dropped        = 0;                              // Reports lost to a full queue
+      std::size_t              passes         = 0;                              // Times the queue was drained
+      std::size_t              purchaseOrders = 0;
+      std::size_t              itemsOrdered   = 0;                              // Order lines, each a distinct grocery item
+      std::size_t              unitsOrdered   = 0;
+      std::size_t              maxQueueDepth  = 0;                              // Most reports waiting at the start of a pass
+      std::chrono::nanoseconds busyTime       {};                               // Spent draining, ordering, and restocking
+
+      double reportsPerSecond() const;                                          // Throughput while busy
+    };
+
+
+    // Constructors, assignments, and destructor
+    ReorderScheduler( Inventory &               inventory,
+                      Inventory::Quantity       threshold,                      // Items below this quantity are re-ordered
+                      Inventory::Quantity       lotCount,                       // Units ordered per item
+                      std::chrono::milliseconds cadence       = DEFAULT_CADENCE,
+                      Supplier                  supplier      = {},
+                      std::size_t               queueCapacity = DEFAULT_QUEUE_CAPACITY );
+
+    ReorderScheduler( const ReorderScheduler & )             = delete;          // intentionally prohibit making copies
+    ReorderScheduler & operator=( const ReorderScheduler & ) = delete;          // intentionally prohibit copy assignments
+
+   ~ReorderScheduler() noexcept;                                                // Re-orders whatever is still reported, then stops
+
+
+    // Reporting, lock-free and safe to call from any number of threads
+    bool lowStock( const Upc & upc ) noexcept;                                  // Returns false if the report was dropped
+
+    // Scheduling
+    void        flush();                                                        // Returns once everything reported so far is re-ordered
+    std::size_t queueDepth() const noexcept;                                    // Reports waiting right now
+    Statistics  statistics() const;
+
+  private:
+    void run ( std::stop_token stopToken );                                     // The background thread
+    void pass();                                                                // Drains the queue and re-orders what it reported
+    void place( PurchaseOrder & order, Inventory::Hint & hint );                // Hands an order to the supplier and restocks it
+
+    Inventory &                     _inventory;
+    const Inventory::Quantity       _threshold;
+    const Inventory::Quantity       _lotCount;
+    const std::chrono::milliseconds _cadence;
+    Supplier                        _supplier;
+
+    BoundedQueue<Upc>               _queue;
+    std::atomic<std::size_t>        _dropped = 0;
+    std::vector<Upc>                _reported;                                  // Reports drained by the current pass.  Scheduler thread only
+
+    mutable std::mutex              _mutex;                                     // Guards everything below
+    std::condition_variable_any     _wake;                                      // Signaled to start a pass early, and at the end of each pass
+    std::uint64_t                   _requested = 0;                             // Flushes asked for
+    std::uint64_t                   _completed = 0;                             // Flushes answered by a finished pass
+    Statistics                      _statistics;
+
+    std::jthread                    _thread;                                    // Declared last, so it starts once everything else is ready
+};
@@ -0,0 +1,310 @@
+#include <algorithm>                                                      // all_of(), equal(), lower_bound(), sort()
+#include <array>
+#include <cstddef>                                                        // size_t
+#include <cstdint>                                                        // uint32_t
+#include <memory>                                                         // allocate_shared()
+#include <memory_resource>                                                // pmr::vector
+#include <span>
+#include <string_view>
+#include <utility>                                                        // move()
+
+#include "ShoppingCart.hpp"
+#include "Upc.hpp"
+
+
+
+namespace  // anonymous
+{
+  // Sorts lines by UPC, combining lines for the same grocery item into one, and returns the end of the combined lines
+  ShoppingCart::Line * sortAndCombine( ShoppingCart::Line * first, ShoppingCart::Line * last )
+  {
+    std::sort( first, last, []( const ShoppingCart::Line & lhs, const ShoppingCart::Line & rhs ) { return lhs.upc < rhs.upc; } );
+
+    auto combined = first;
+    for( auto line = first; line != last; ++line )
+    {
+      if( combined != first  &&  ( combined - 1 )->upc == line->upc ) ( combined - 1 )->quantity += line->quantity;
+      else                                                            *combined++ = *line;
+    }
+    return combined;
+  }
+}    // namespace
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Constructors and assignments
+*******************************************************************************/
+ShoppingCart::ShoppingCart( const allocator_type & allocator ) noexcept
+  : _spilledUpcs( allocator ), _spilledQuantities( allocator )
+{}
+
+
+
+ShoppingCart::ShoppingCart( std::initializer_list<Entry> entries, const allocator_type & allocator )
+  : ShoppingCart( allocator )
+{
+  for( const auto & [upc, label, quantity] : entries ) add( upc, quantity, label );
+  close();
+}
+
+
+
+ShoppingCart::ShoppingCart( const ShoppingCart & other )
+  : ShoppingCart( other, allocator_type() )
+{}
+
+
+
+ShoppingCart::ShoppingCart( const ShoppingCart & other, const allocator_type & allocator )
+  : _size             ( other._size                        ),
+    _closed           ( other._closed                      ),
+    _inlineUpcs       ( other._inlineUpcs                  ),
+    _inlineQuantities ( other._inlineQuantities            ),
+    _spilledUpcs      ( other._spilledUpcs,       allocator ),
+    _spilledQuantities( other._spilledQuantities, allocator )
+{ copyLabels( other ); }
+
+
+
+ShoppingCart::ShoppingCart( ShoppingCart && other, const allocator_type & allocator )
+  : ShoppingCart( allocator )
+{ *this = std::move( other ); }
+
+
+
+ShoppingCart & ShoppingCart::operator=( const ShoppingCart & rhs )
+{
+  if( this != &rhs ) *this = ShoppingCart( rhs, get_allocator() );
+  return *this;
+}
+
+
+
+// Moving between carts in different resources copies, since neither cart's resource may hold the other's memory
+ShoppingCart & ShoppingCart::operator=( ShoppingCart && rhs )
+{
+  if( this == &rhs ) return *this;
+  if( get_allocator() != rhs.get_allocator() ) return *this = static_cast<const ShoppingCart &>( rhs );
+
+  _size              = rhs._size;
+  _closed            = rhs._closed;
+  _inlineUpcs        = rhs._inlineUpcs;
+  _inlineQuantities  = rhs._inlineQuantities;
+  _spilledUpcs       = std::move( rhs._spilledUpcs       );
+  _spilledQuantities = std::move( rhs._spilledQuantities );
+  _labels            = std::move( rhs._labels            );
+  return *this;
+}
+
+
+
+ShoppingCart::allocator_type ShoppingCart::get_allocator() const noexcept
+{ return _spilledUpcs.get_allocator(); }
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Filling the cart
+*******************************************************************************/
+ShoppingCart & ShoppingCart::add( const Upc & upc, Quantity quantity, std::string_view label )
+{
+  if( _closed  &&  _size != 0  &&  !( upcData()[_size - 1] < upc ) ) _closed = false;   // still closed if added in UPC order
+
+  if( _size == INLINE_CAPACITY  &&  !spilled() )
+  {
+    _spilledUpcs      .assign( _inlineUpcs      .begin(), _inlineUpcs      .end() );
+    _spilledQuantities.assign( _inlineQuantities.begin(), _inlineQuantities.end() );
+  }
+
+  if( spilled() )
+  {
+    _spilledUpcs      .push_back( upc      );
+    _spilledQuantities.push_back( quantity );
+  }
+  else
+  {
+    _inlineUpcs      [_size] = upc;
+    _inlineQuantities[_size] = quantity;
+  }
+  ++_size;
+
+  if( !label.empty() )
+  {
+    auto & labels = ownLabels();
+    auto   place  = std::lower_bound( labels.index.begin(), labels.index.end(), upc, []( const Labels::Label & lhs, const Upc & rhs ) { return lhs.upc < rhs; } );
+    if( place == labels.index.end()  ||  place->upc != upc )
+    {
+      labels.index.insert( place, { upc, static_cast<std::uint32_t>( labels.text.size() ), static_cast<std::uint32_t>( label.size() ) } );
+      labels.text += label;
+    }
+  }
+  return *this;
+}
+
+
+
+// Lines are gathered into whole Lines, sorted, and scattered back.  Carts that fit inline are sorted on the stack, so closing them
+// never allocates, and carts filled in UPC order, the usual case, aren't sorted at all.
+void ShoppingCart::close()
+{
+  if( _closed ) return;
+  _closed = true;
+
+  auto rearrange = [this]( Line * lines )
+  {
+    auto upcLines      = upcData();
+    auto quantityLines = quantityData();
+    for( std::size_t i = 0; i < _size; ++i ) lines[i] = { upcLines[i], quantityLines[i] };
+
+    _size = static_cast<std::size_t>( sortAndCombine( lines, lines + _size ) - lines );
+    for( std::size_t i = 0; i < _size; ++i )
+    {
+      upcLines     [i] = lines[i].upc;
+      quantityLines[i] = lines[i].quantity;
+    }
+  };
+
+  if( spilled() )
+  {
+    std::pmr::vector<Line> lines( _size, get_allocator() );
+    rearrange( lines.data() );
+    _spilledUpcs      .resize( _size );
+    _spilledQuantities.resize( _size );
+  }
+  else
+  {
+    std::array<Line, INLINE_CAPACITY> lines;
+    rearrange( lines.data() );
+  }
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Queries
+*******************************************************************************/
+bool ShoppingCart::closed() const noexcept
+{ return _closed; }
+
+
+
+std::size_t ShoppingCart::size() const noexcept
+{ return _size; }
+
+
+
+bool ShoppingCart::empty() const noexcept
+{ return _size == 0; }
+
+
+
+std::span<const Upc> ShoppingCart::upcs() const noexcept
+{ return { spilled()  ?  _spilledUpcs.data()  :  _inlineUpcs.data(), _size }; }
+
+
+
+std::span<const ShoppingCart::Quantity> ShoppingCart::quantities() const noexcept
+{ return { spilled()  ?  _spilledQuantities.data()  :  _inlineQuantities.data(), _size }; }
+
+
+
+std::string_view ShoppingCart::label( const Upc & upc ) const noexcept
+{
+  if( _labels == nullptr ) return {};
+
+  auto place = std::lower_bound( _labels->index.begin(), _labels->index.end(), upc, []( const Labels::Label & lhs, const Upc & rhs ) { return lhs.upc < rhs; } );
+  if( place == _labels->index.end()  ||  place->upc != upc ) return {};
+
+  return std::string_view( _labels->text ).substr( place->offset, place->length );
+}
+
+
+
+ShoppingCart::const_iterator ShoppingCart::begin() const noexcept
+{ return { upcs().data(), quantities().data(), 0 }; }
+
+
+
+ShoppingCart::const_iterator ShoppingCart::end() const noexcept
+{ return { upcs().data(), quantities().data(), _size }; }
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Relational Operators
+*******************************************************************************/
+bool ShoppingCart::operator==( const ShoppingCart & rhs ) const
+{
+  auto lhsUpcs       = upcs(),       rhsUpcs       = rhs.upcs();
+  auto lhsQuantities = quantities(), rhsQuantities = rhs.quantities();
+  if( !std::equal( lhsUpcs      .begin(), lhsUpcs      .end(), rhsUpcs      .begin(), rhsUpcs      .end() ) ) return false;
+  if( !std::equal( lhsQuantities.begin(), lhsQuantities.end(), rhsQuantities.begin(), rhsQuantities.end() ) ) return false;
+
+  auto labeled = []( const ShoppingCart & cart ) { return cart._labels == nullptr  ?  std::size_t{ 0 }  :  cart._labels->index.size(); };
+  if( labeled( *this ) != labeled( rhs ) ) return false;
+  if( _labels == nullptr ) return true;
+
+  return std::all_of( _labels->index.begin(), _labels->index.end(), [&]( const Labels::Label & entry ) { return label( entry.upc ) == rhs.label( entry.upc ); } );
+}
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Private helpers
+*******************************************************************************/
+bool ShoppingCart::spilled() const noexcept
+{ return !_spilledUpcs.empty(); }                                         // once spilled, a cart never holds fewer than one line
+
+
+
+Upc * ShoppingCart::upcData() noexcept
+{ return spilled()  ?  _spilledUpcs.data()  :  _inlineUpcs.data(); }
+
+
+
+ShoppingCart::Quantity * ShoppingCart::quantityData() noexcept
+{ return spilled()  ?  _spilledQuantities.data()  :  _inlineQuantities.data(); }
+
+
+
+ShoppingCart::Labels & ShoppingCart::ownLabels()
+{
+  if     ( _labels == nullptr     ) _labels = std::allocate_shared<Labels>( get_allocator(),           get_allocator() );
+  else if( _labels.use_count() > 1 ) _labels = std::allocate_shared<Labels>( get_allocator(), *_labels, get_allocator() );
+  return *_labels;
+}
+
+
+
+void ShoppingCart::copyLabels( const ShoppingCart & other )
+{
+  if     ( other._labels == nullptr                 ) _labels = nullptr;
+  else if( get_allocator() == other.get_allocator() ) _labels = other._labels;
+  else                                                _labels = std::allocate_shared<Labels>( get_allocator(), *other._labels, get_allocator() );
+}
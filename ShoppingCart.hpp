@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <compare>                                                              // strong_ordering
+#include <cstddef>                                                              // size_t, ptrdiff_t
+#include <cstdint>                                                              // uint32_t
+#include <initializer_list>
+#include <iterator>                                                             // random_access_iterator_tag
+#include <memory>                                                               // shared_ptr
+#include <memory_resource>                                                      // pmr::polymorphic_allocator, pmr::vector, pmr::string
+#include <span>
+#include <string_view>
+
+#include "Inventory.hpp"
+#include "Upc.hpp"
+
+
+
+// The groceries in one customer's shopping cart:  a UPC and a quantity per line, and nothing else.  Checkout looks each UPC up in the
+// world wide grocery item database anyway, so a cart never carries a grocery item's description or price.
+//
+// Lines are kept as two parallel arrays, UPCs and quantities, so the UPCs can be handed to a batched database lookup as they are.
+// The first INLINE_CAPACITY lines live inside the cart itself; a cart only allocates once it grows past that.  Lines are added in any
+// order, and closing the cart sorts them by UPC and combines lines for the same grocery item, so a closed cart is read in UPC order
+// with each UPC once.  Carts made from an initializer list are closed already.
+//
+// A customer may label a line with their own name for the grocery item, Ex: "milk".  Labels are rarely needed, only to name an item
+// the database doesn't know, so they are stored out of line, all in one block, allocated only if the cart has any, and shared rather
+// than copied when the cart is copied.
+//
+// Whatever a cart allocates comes from its memory resource, so a cart can live on a checkout transaction's arena, and carts in a
+// std::pmr container use the container's resource.  Labels are shared only between carts using the same resource, so no cart ever
+// points into memory another cart's resource may release.
+class ShoppingCart
+{
+  public:
+    using Quantity       = Inventory::Quantity;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    inline static constexpr std::size_t INLINE_CAPACITY = 16;                   // Lines held without allocating
+
+    struct Line
+    {
+      Upc      upc;
+      Quantity quantity = 1;
+
+      bool operator==( const Line & ) const = default;
+    };
+
+    struct Entry                                                                // One line as written in an initializer list,
+    {                                                                           // Ex: { "00075457129000", "milk" }
+      Upc              upc;
+      std::string_view label    = {};
+      Quantity         quantity = 1;
+    };
+
+    class const_iterator;                                                       // Lines by value, a Line at a time
+
+
+    // Constructors and assignments.  Copies use the default memory resource unless given another, as std::pmr containers do.
+    ShoppingCart() noexcept = default;
+    explicit ShoppingCart( const allocator_type & allocator ) noexcept;
+    ShoppingCart( std::initializer_list<Entry> entries,                         // Closed
+                  const allocator_type &       allocator = {} );
+
+    ShoppingCart( const ShoppingCart & other );
+    ShoppingCart( const ShoppingCart & other, const allocator_type & allocator );
+    ShoppingCart( ShoppingCart &&      other ) noexcept = default;
+    ShoppingCart( ShoppingCart &&      other, const allocator_type & allocator );
+
+    ShoppingCart & operator=( const ShoppingCart & rhs );                       // Keeps this cart's memory resource
+    ShoppingCart & operator=( ShoppingCart &&      rhs );
+
+    allocator_type get_allocator() const noexcept;
+
+
+    // Filling the cart
+    ShoppingCart & add( const Upc & upc, Quantity quantity = 1,                 // Adds a line, reopening the cart unless upc follows every UPC
+                        std::string_view label = {} );                          // already in it.  The first label given a grocery item is kept
+    void           close();                                                     // Sorts the lines by UPC, combining lines for the same item
+
+
+    // Queries.  Lines are in UPC order, each UPC once, only while the cart is closed
+    bool                      closed    () const noexcept;
+    std::size_t               size      () const noexcept;                      // Number of lines
+    bool                      empty     () const noexcept;
+    std::span<const Upc>      upcs      () const noexcept;
+    std::span<const Quantity> quantities() const noexcept;                      // In the same order as upcs()
+    std::string_view          label     ( const Upc & upc ) const noexcept;      // The customer's label for the item, or empty if none
+
+    const_iterator begin() const noexcept;
+    const_iterator end  () const noexcept;
+
+    // Relational Operators
+    bool operator==( const ShoppingCart & rhs ) const;                          // Same lines, in the same order, with the same labels
+
+  private:
+    struct Labels
+    {
+      struct Label
+      {
+        Upc           upc;
+        std::uint32_t offset = 0;                                               // Where the label starts in text
+        std::uint32_t length = 0;
+      };
+
+      explicit Labels( const allocator_type & allocator ) noexcept              : index( allocator ),              text( allocator )             {}
+      Labels( const Labels & other, const allocator_type & allocator )          : index( other.index, allocator ), text( other.text, allocator ) {}
+
+      std::pmr::vector<Label> index;                                            // By UPC, each UPC once
+      std::pmr::string        text;                                             // Every label, one after the other
+    };
+
+    bool       spilled     () const noexcept;                                   // Lines have outgrown the inline arrays
+    Upc      * upcData     ()       noexcept;
+    Quantity * quantityData()       noexcept;
+    Labels   & ownLabels   ();                                                  // The cart's labels, unshared, made if there are none yet
+    void       copyLabels  ( const ShoppingCart & other );                      // Shares other's labels if they're in the same resource
+
+    std::size_t                           _size   = 0;
+    bool                                  _closed = true;
+    std::array<Upc,      INLINE_CAPACITY> _inlineUpcs;
+    std::array<Quantity, INLINE_CAPACITY> _inlineQuantities{};
+    std::pmr::vector<Upc>                 _spilledUpcs;                         // Every line once there are more than INLINE_CAPACITY,
+    std::pmr::vector<Quantity>            _spilledQuantities;                   // otherwise empty.  Their resource is the cart's
+    std::shared_ptr<Labels>               _labels;                              // Nothing until a line is labeled.  Copied before being changed
+                                                                                // if another cart shares it
+};
+
+
+
+class ShoppingCart::const_iterator
+{
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = Line;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = Line;
+
+    const_iterator() noexcept = default;
+
+    Line operator* (                  ) const noexcept { return { _upcs[_line], _quantities[_line] }; }
+    Line operator[]( difference_type n ) const noexcept { return *( *this + n ); }
+
+    const_iterator & operator++(   ) noexcept { ++_line; return *this; }
+    const_iterator   operator++(int) noexcept { auto result = *this; ++_line; return result; }
+    const_iterator & operator--(   ) noexcept { --_line; return *this; }
+    const_iterator   operator--(int) noexcept { auto result = *this; --_line; return result; }
+
+    const_iterator & operator+=( difference_type n ) noexcept { _line = static_cast<std::size_t>( static_cast<difference_type>( _line ) + n ); return *this; }
+    const_iterator & operator-=( difference_type n ) noexcept { return *this += -n; }
+
+    friend const_iterator  operator+( const_iterator it, difference_type n ) noexcept { return it += n; }
+    friend const_iterator  operator+( difference_type n, const_iterator it ) noexcept { return it += n; }
+    friend const_iterator  operator-( const_iterator it, difference_type n ) noexcept { return it -= n; }
+    friend difference_type operator-( const const_iterator & lhs, const const_iterator & rhs ) noexcept
+    { return static_cast<difference_type>( lhs._line ) - static_cast<difference_type>( rhs._line ); }
+
+    bool                 operator== ( const const_iterator & rhs ) const noexcept { return _line == rhs._line; }
+    std::strong_ordering operator<=>( const const_iterator & rhs ) const noexcept { return _line <=> rhs._line; }
+
+  private:
+    friend class ShoppingCart;
+
+    const_iterator( const Upc * upcs, const Quantity * quantities, std::size_t line ) noexcept
+      : _upcs( upcs ), _quantities( quantities ), _line( line )
+    {}
+
+    const Upc      * _upcs       = nullptr;
+    const Quantity * _quantities = nullptr;
+    std::size_t      _line       = 0;
+};
@@ -0,0 +1,334 @@
+#include <algorithm>                                                    // clamp(), max()
+#include <cctype>                                                       // tolower()
+#include <cmath>                                                        // exp(), expm1(), floor(), log(), log1p(), abs()
+#include <cstddef>                                                      // size_t
+#include <cstdint>                                                      // uint64_t
+#include <exception>
+#include <filesystem>                                                   // create_directories()
+#include <fstream>
+#include <iomanip>                                                      // quoted(), setw(), setfill()
+#include <iostream>
+#include <numeric>                                                      // gcd()
+#include <random>                                                       // mt19937_64
+#include <sstream>                                                      // ostringstream
+#include <stdexcept>                                                    // invalid_argument, runtime_error
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "Money.hpp"
+
+
+
+// Writes a synthetic, reproducible data set at whatever scale is asked for:
+//   o  a grocery item database, in exactly the format GroceryItem's insertion operator writes, including brand and product names
+//      with escaped quotes and backslashes and, occasionally, an embedded newline
+//   o  a store inventory covering most, but not all, of those grocery items
+//   o  a checkout workload:  shoppers and the groceries in their carts, chosen with Zipfian popularity so a few grocery items are
+//      in nearly every cart and most are rarely bought
+// The same options and seed always produce byte for byte the same files.
+//
+// Usage:  GenerateDataset [--option=value ...]
+//     --output=<directory>          where the files are written (default GeneratedDataset), named as the store looks for them
+//     --items=<n>                   grocery items in the database (default 1,000,000)
+//     --inventory-coverage=<0..1>   fraction of grocery items the store carries (default 0.9)
+//     --carts=<n>                   shopping carts in the workload (default 10,000)
+//     --cart-size=<n>               average groceries per cart (default 20)
+//     --zipf=<s>                    Zipf exponent of grocery item popularity, 0 for uniform (default 1.0)
+//     --seed=<n>                    random number generator seed (default 1)
+namespace    // unnamed, anonymous namespace
+{
+  struct Options
+  {
+    std::string   output            = "GeneratedDataset";
+    std::size_t   items             = 1'000'000;
+    double        inventoryCoverage = 0.9;
+    std::size_t   carts             = 10'000;
+    std::size_t   cartSize          = 20;
+    double        zipf              = 1.0;
+    std::uint64_t seed              = 1;
+  };
+
+
+
+  Options parseOptions( int argc, char * argv[] )
+  {
+    Options options;
+    for( int i = 1; i < argc; ++i )
+    {
+      std::string_view argument = argv[i];
+      auto equals = argument.find( '=' );
+      if( !argument.starts_with( "--" )  ||  equals == std::string_view::npos ) throw std::invalid_argument( "expected --option=value, found \"" + std::string( argument ) + '"' );
+
+      auto name  = argument.substr( 2, equals - 2 );
+      auto value = std::string( argument.substr( equals + 1 ) );
+
+      if     ( name == "output"             ) options.output            = value;
+      else if( name == "items"              ) options.items             = std::stoull( value );
+      else if( name == "inventory-coverage" ) options.inventoryCoverage = std::stod  ( value );
+      else if( name == "carts"              ) options.carts             = std::stoull( value );
+      else if( name == "cart-size"          ) options.cartSize          = std::stoull( value );
+      else if( name == "zipf"               ) options.zipf              = std::stod  ( value );
+      else if( name == "seed"               ) options.seed              = std::stoull( value );
+      else throw std::invalid_argument( "unrecognized option \"" + std::string( name ) + '"' );
+    }
+
+    if( options.items == 0  ||  options.items > 99'999'999'999ULL ) throw std::invalid_argument( "--items must be between 1 and 99,999,999,999" );
+    if( options.zipf  <  0.0                                      ) throw std::invalid_argument( "--zipf must not be negative" );
+    return options;
+  }
+
+
+
+
+  // The standard distributions' results are implementation defined, so the same seed could produce different data sets with different
+  // standard libraries.  std::mt19937_64's output is fully specified, and these map it to ranges the same way everywhere.
+  class Random
+  {
+    public:
+      explicit Random( std::uint64_t seed ) : _generator( seed ) {}
+
+      double        uniform()                       { return static_cast<double>( _generator() >> 11 ) * 0x1.0p-53; }   // [0, 1)
+      std::uint64_t below  ( std::uint64_t limit )  { return _generator() % limit; }                                    // [0, limit), bias negligible
+      bool          chance ( double probability )   { return uniform() < probability; }
+
+      template<std::size_t N>
+      const char * pick( const char * const ( & choices )[N] ) { return choices[below( N )]; }
+
+    private:
+      std::mt19937_64 _generator;
+  };
+
+
+
+
+  // Samples ranks 1 through n with probability proportional to 1 / rank^exponent in constant time and memory, using rejection
+  // inversion.  See W. Hörmann and G. Derflinger, "Rejection-inversion to generate variates from monotone discrete distributions",
+  // ACM Transactions on Modeling and Computer Simulation, 1996.
+  class ZipfDistribution
+  {
+    public:
+      ZipfDistribution( std::uint64_t n, double exponent )
+        : _n( static_cast<double>( n ) ), _exponent( exponent ),
+          _hIntegralX1( hIntegral( 1.5 ) - 1.0 ),
+          _hIntegralN ( hIntegral( _n + 0.5 ) ),
+          _s          ( 2.0 - hIntegralInverse( hIntegral( 2.5 ) - h( 2.0 ) ) )
+      {}
+
+      std::uint64_t operator()( Random & random ) const
+      {
+        while( true )
+        {
+          double u = _hIntegralN + random.uniform() * ( _hIntegralX1 - _hIntegralN );
+          double x = hIntegralInverse( u );
+          double k = std::clamp( std::floor( x + 0.5 ), 1.0, _n );
+
+          if( k - x <= _s  ||  u >= hIntegral( k + 0.5 ) - h( k ) ) return static_cast<std::uint64_t>( k );
+        }
+      }
+
+    private:
+      double h( double x ) const
+      { return std::exp( -_exponent * std::log( x ) ); }
+
+      double hIntegral( double x ) const
+      {
+        double logX = std::log( x );
+        return helper2( ( 1.0 - _exponent ) * logX ) * logX;
+      }
+
+      double hIntegralInverse( double x ) const
+      {
+        double t = std::max( x * ( 1.0 - _exponent ), -1.0 );
+        return std::exp( helper1( t ) * x );
+      }
+
+      // log1p(x)/x and expm1(x)/x, accurate as x approaches 0
+      static double helper1( double x )
+      { return std::abs( x ) > 1e-8  ?  std::log1p( x ) / x  :  1.0 - x * ( 0.5 - x * ( 1.0 / 3.0 - 0.25 * x ) ); }
+
+      static double helper2( double x )
+      { return std::abs( x ) > 1e-8  ?  std::expm1( x ) / x  :  1.0 + x * 0.5 * ( 1.0 + x / 3.0 * ( 1.0 + 0.25 * x ) ); }
+
+      double _n, _exponent, _hIntegralX1, _hIntegralN, _s;
+  };
+
+
+
+
+  // (a * b) mod m without overflow, for a, b < m < 2^40
+  std::uint64_t multiplyModulo( std::uint64_t a, std::uint64_t b, std::uint64_t m )
+  { return ( ( a * ( b >> 20 ) % m << 20 ) + a * ( b & 0xF'FFFF ) ) % m; }
+
+
+
+
+  // A valid 12 digit UPC-A (11 digits plus check digit), padded to 14 digits as the database stores them.  Multiplying by a number
+  // coprime to 10^11 permutes the payloads, so every grocery item gets a distinct UPC and consecutive items look unrelated.
+  std::string upcFor( std::uint64_t item )
+  {
+    constexpr std::uint64_t PAYLOADS   = 100'000'000'000ULL;
+    constexpr std::uint64_t MULTIPLIER = 7'919'993'821ULL;                          // odd and not a multiple of 5
+
+    auto payload = ( multiplyModulo( item, MULTIPLIER, PAYLOADS ) + 12'345'678'901ULL ) % PAYLOADS;
+
+    std::string digits = std::to_string( payload );
+    digits.insert( 0, 11 - digits.size(), '0' );
+
+    unsigned odd = 0, even = 0;
+    for( std::size_t i = 0; i < digits.size(); ++i ) ( i % 2 == 0  ?  odd  :  even ) += static_cast<unsigned>( digits[i] - '0' );
+    auto check = ( 10 - ( odd * 3 + even ) % 10 ) % 10;
+
+    return "00" + digits + static_cast<char>( '0' + check );
+  }
+
+
+
+
+  constexpr const char * BRAND_SYLLABLES[] = { "Ha", "Mea", "Do", "Sun", "Ri", "Ver", "Gold", "En", "Oak", "Mil", "Ber", "Kin", "Lu", "Crest", "Val", "Bo" };
+  constexpr const char * BRAND_SUFFIXES [] = { "", "", " Farms", " Foods", " & Co.", "'s", " Kitchen", " Organics", " Bakery", " Naturals" };
+  constexpr const char * ADJECTIVES     [] = { "Organic", "Classic", "Low Fat", "Whole Grain", "Spicy", "Original", "Family Size", "Sugar Free", "Smoked", "Fresh" };
+  constexpr const char * NOUNS          [] = { "Milk", "Cheddar Cheese", "Peanut Butter", "Salsa", "Tortilla Chips", "Coffee", "Pasta Sauce", "Granola", "Ketchup", "Green Tea",
+                                               "Notebook College Ruled", "Paper Towels", "Dog Food", "Frozen Pizza", "Ice Cream", "Chicken Broth" };
+  constexpr const char * SIZES          [] = { "12 oz", "1 gal", "6 Ct", "16.9 fl oz", "2 lb", "24 Ct", "8 oz", "64 oz" };
+
+
+
+  std::string brandName( Random & random )
+  {
+    std::string name;
+    for( auto syllables = 2 + random.below( 2 ); syllables-- > 0; ) name += random.pick( BRAND_SYLLABLES );
+    for( std::size_t i = 1; i < name.size(); ++i ) name[i] = static_cast<char>( std::tolower( static_cast<unsigned char>( name[i] ) ) );
+
+    if( random.chance( 0.01 ) ) name += " \"The Original\"";                   // escaped quotes in the brand name
+    return name + random.pick( BRAND_SUFFIXES );
+  }
+
+
+
+  std::string productName( Random & random, const std::string & brand )
+  {
+    std::string name = brand + ' ' + random.pick( ADJECTIVES ) + ' ' + random.pick( NOUNS ) + " - " + random.pick( SIZES );
+
+    if( random.chance( 0.02  ) ) name += " 10.5\" X 8\"";                       // escaped quotes, as in real product names
+    if( random.chance( 0.002 ) ) name += " C:\\Recipes";                        // escaped backslash
+    if( random.chance( 0.001 ) ) name += "\nLimited Edition";                   // newline embedded in the quoted string
+    return name;
+  }
+
+
+
+
+  void openFor( std::ofstream & file, const std::filesystem::path & path, std::vector<char> & buffer )
+  {
+    buffer.resize( 1 << 20 );
+    file.rdbuf()->pubsetbuf( buffer.data(), static_cast<std::streamsize>( buffer.size() ) );
+    file.open( path, std::ios::binary );
+    if( !file ) throw std::runtime_error( "could not create \"" + path.string() + '"' );
+  }
+
+
+
+  // Every grocery item, in an order unrelated to UPC.  Each file gets its own random stream so changing, say, the number of carts
+  // doesn't change the database or inventory.
+  void writeDatabase( const Options & options, const std::filesystem::path & path )
+  {
+    Random random( options.seed );
+
+    std::vector<std::string> brands( std::max<std::size_t>( 1, options.items / 25 ) );
+    for( auto & brand : brands ) brand = brandName( random );
+
+    // Brands are Zipfian too:  a few appear on many products, most on only a handful
+    ZipfDistribution brandPopularity( brands.size(), 0.8 );
+
+    std::ofstream     file;
+    std::vector<char> buffer;
+    openFor( file, path, buffer );
+
+    for( std::uint64_t item = 0; item < options.items; ++item )
+    {
+      const auto & brand = brands[brandPopularity( random ) - 1];
+      auto         price = Money::fromCents( static_cast<Money::Cents>( 50 + random.below( 4'950 ) ) );
+      file << GroceryItem( productName( random, brand ), brand, upcFor( item ), price ) << '\n';
+    }
+    if( !file.flush() ) throw std::runtime_error( "could not write \"" + path.string() + '"' );
+  }
+
+
+
+  void writeInventory( const Options & options, const std::filesystem::path & path )
+  {
+    Random random( options.seed + 1 );
+
+    std::ofstream     file;
+    std::vector<char> buffer;
+    openFor( file, path, buffer );
+
+    for( std::uint64_t item = 0; item < options.items; ++item )
+    {
+      if( !random.chance( options.inventoryCoverage ) ) continue;
+      file << upcFor( item ) << "   " << std::setw( 3 ) << random.below( 61 ) << '\n';   // 0 through 60 on hand, some below the reorder threshold
+    }
+    if( !file.flush() ) throw std::runtime_error( "could not write \"" + path.string() + '"' );
+  }
+
+
+
+  // One line per grocery item in a cart:  the shopper's name, then the grocery item's UPC.  A cart's lines are consecutive.
+  void writeCarts( const Options & options, const std::filesystem::path & path )
+  {
+    Random random( options.seed + 2 );
+
+    // Popularity rank r is grocery item (r * stride + offset) mod items, so the most popular grocery items are scattered through
+    // the database rather than all at its front
+    std::uint64_t stride = options.items / 2 + 1;
+    while( std::gcd( stride, options.items ) != 1 ) ++stride;
+    std::uint64_t offset = random.below( options.items );
+
+    ZipfDistribution popularity( options.items, options.zipf );
+
+    std::ofstream     file;
+    std::vector<char> buffer;
+    openFor( file, path, buffer );
+
+    for( std::size_t cart = 0; cart < options.carts; ++cart )
+    {
+      std::ostringstream name;
+      name << "Shopper " << std::setw( 7 ) << std::setfill( '0' ) << cart + 1;
+
+      for( auto groceries = 1 + random.below( 2 * options.cartSize ); groceries-- > 0; )
+      {
+        auto rank = popularity( random ) - 1;
+        auto item = ( multiplyModulo( rank, stride, options.items ) + offset ) % options.items;
+        file << std::quoted( name.str() ) << ", " << std::quoted( upcFor( item ) ) << '\n';
+      }
+    }
+    if( !file.flush() ) throw std::runtime_error( "could not write \"" + path.string() + '"' );
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+int main( int argc, char * argv[] )
+{
+  try
+  {
+    auto options = parseOptions( argc, argv );
+
+    std::filesystem::path directory( options.output );
+    std::filesystem::create_directories( directory );
+
+    writeDatabase ( options, directory / "Grocery_UPC_Database-Full.dat" );
+    writeInventory( options, directory / "GroceryStoreInventory.dat"     );
+    writeCarts    ( options, directory / "ShoppingCarts.dat"             );
+
+    std::cout << "Wrote " << options.items << " grocery items and " << options.carts << " shopping carts to \"" << directory.string() << "\"\n";
+  }
+  catch( const std::exception & ex )
+  {
+    std::cerr << "GenerateDataset:  " << ex.what() << '\n';
+    return 1;
+  }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <compare>                                                              // strong_ordering
+#include <cstddef>                                                              // size_t
+#include <cstdint>                                                              // uint64_t
+#include <functional>                                                           // hash
+#include <iostream>
+#include <optional>
+#include <stdexcept>                                                            // invalid_argument
+#include <string>
+#include <string_view>
+
+
+
+// A Universal Product Code.  UPCs are always exactly 14 decimal digits (leading zeros are significant), so the digits are validated
+// once, on construction, and packed into a single integer.  Comparing, ordering, and hashing UPCs are then single integer operations,
+// and a UPC used as a container key no longer costs a heap allocation.  Numeric order is the same as the order of the digit strings.
+class Upc
+{
+  public:
+    inline static constexpr std::size_t DIGITS = 14;
+
+    // Constructors
+    constexpr Upc() noexcept = default;                                         // "00000000000000"
+
+    constexpr Upc( const char * text )                                          // Intentionally implicit so string literals can be used wherever a Upc is
+      : Upc( std::string_view( text ) )                                         // expected.  A malformed literal in a constant expression fails to compile
+    {}
+
+    explicit constexpr Upc( std::string_view text )                             // Throws std::invalid_argument if text is not exactly 14 decimal digits
+      : _value( pack( text ) )
+    {}
+
+
+    // Returns the UPC, or nothing if text is not exactly 14 decimal digits
+    static constexpr std::optional<Upc> parse( std::string_view text ) noexcept
+    {
+      if( !isWellFormed( text ) ) return std::nullopt;
+
+      Upc upc;
+      upc._value = unchecked( text );
+      return upc;
+    }
+
+
+    // Returns the UPC whose value() is value, or nothing if value has more than 14 digits
+    static constexpr std::optional<Upc> fromValue( std::uint64_t value ) noexcept
+    {
+      if( value > MAXIMUM_VALUE ) return std::nullopt;
+
+      Upc upc;
+      upc._value = value;
+      return upc;
+    }
+
+
+    // Queries
+    constexpr std::uint64_t value() const noexcept { return _value; }          // The 14 digits as an integer, Ex: "00014100072331" is 14100072331
+
+    std::string to_string() const                                               // The 14 digits, zero padded, Ex: "00014100072331"
+    {
+      std::string text( DIGITS, '0' );
+      to_chars( text.data() );
+      return text;
+    }
+
+    constexpr char * to_chars( char * first ) const noexcept                    // Same, but writes the 14 digits to first, first + DIGITS and
+    {                                                                           // returns first + DIGITS.  Nothing is allocated
+      auto remaining = _value;
+      for( auto digit = first + DIGITS;  digit != first;  remaining /= 10 ) *--digit = static_cast<char>( '0' + remaining % 10 );
+      return first + DIGITS;
+    }
+
+
+    // Relational Operators
+    constexpr std::strong_ordering operator<=>( const Upc & ) const noexcept = default;
+    constexpr bool                 operator== ( const Upc & ) const noexcept = default;
+
+  private:
+    inline static constexpr std::uint64_t MAXIMUM_VALUE = 99'999'999'999'999ULL;  // 14 nines
+
+    static constexpr bool isWellFormed( std::string_view text ) noexcept
+    {
+      if( text.size() != DIGITS ) return false;
+      for( char c : text ) if( c < '0'  ||  c > '9' ) return false;
+      return true;
+    }
+
+    static constexpr std::uint64_t unchecked( std::string_view text ) noexcept
+    {
+      std::uint64_t value = 0;
+      for( char c : text ) value = value * 10 + static_cast<std::uint64_t>( c - '0' );
+      return value;
+    }
+
+    static constexpr std::uint64_t pack( std::string_view text )
+    {
+      if( !isWellFormed( text ) ) throw std::invalid_argument( "UPC \"" + std::string( text ) + "\" is not exactly 14 decimal digits" );
+      return unchecked( text );
+    }
+
+    std::uint64_t _value = 0;
+};
+
+
+
+// Insertion Operator:  writes the 14 digits, unquoted
+inline std::ostream & operator<<( std::ostream & stream, const Upc & upc )
+{ return stream << upc.to_string(); }
+
+
+
+// Fibonacci hashing:  multiplying by 2^64 / golden ratio scatters consecutive UPCs across all bits of the result
+template<>
+struct std::hash<Upc>
+{
+  std::size_t operator()( const Upc & upc ) const noexcept
+  { return static_cast<std::size_t>( upc.value() * 0x9E37'79B9'7F4A'7C15ULL ); }
+};